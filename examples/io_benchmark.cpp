@@ -0,0 +1,802 @@
+////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c)      2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+////////////////////////////////////////////////////////////////////////////////
+
+// I/O benchmark for all hpxio file types, run on every locality at once.
+//
+// Each locality runs --threads I/O streams with --queue-depth requests in
+// flight each. A stream either owns --files files (--sharing per-thread) or
+// all streams of a locality share --files files (--sharing shared), in which
+// case each stream starts in its own region of the files. Requests are
+// --block-size positional reads or writes, picked at --read-ratio percent,
+// at sequential or uniformly random block-aligned offsets (--pattern).
+//
+// --backend, --threads, --pattern, --read-ratio, --block-size and
+// --queue-depth take comma separated lists, every combination is run. The
+// files are created and filled before the runs of each backend and thread
+// count. The results are written as JSON, including latency percentiles of
+// reads and writes, to --output or stdout.
+
+#include <hpxio/file.hpp>
+#include <hpxio/file_stream.hpp>
+#include <hpxio/local_file.hpp>
+#include <hpxio/partitioned_file.hpp>
+#if defined(HPXIO_HAVE_ORANGEFS)
+#include <hpxio/orangefs_file.hpp>
+#include <hpxio/orangefs_file_traits.hpp>
+#include <hpxio/pxfs_file.hpp>
+#endif
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/actions.hpp>
+#include <hpx/include/components.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/runtime.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/shared_ptr.hpp>
+
+using boost::program_options::variables_map;
+using boost::program_options::options_description;
+using boost::program_options::value;
+
+using hpx::init;
+using hpx::finalize;
+
+///////////////////////////////////////////////////////////////////////////////
+struct benchmark_config
+{
+    std::string backend;
+    std::string path;
+    bool random;
+    int read_ratio;                 // percent of the requests which read
+    boost::uint64_t block_size;
+    std::size_t queue_depth;        // requests in flight per stream
+    std::size_t threads;            // streams per locality
+    std::size_t files;
+    bool shared;                    // all streams share the files
+    boost::uint64_t file_size;
+    boost::uint64_t ops;            // per stream, 0: one pass
+    bool direct;
+    boost::uint64_t seed;
+
+    benchmark_config()
+      : random(false), read_ratio(100), block_size(0), queue_depth(1),
+        threads(1), files(1), shared(false), file_size(0), ops(0),
+        direct(false), seed(0)
+    {}
+
+    std::size_t files_per_locality() const
+    {
+        return shared ? files : threads * files;
+    }
+
+    boost::uint64_t blocks_per_file() const
+    {
+        return file_size / block_size;
+    }
+
+    friend class boost::serialization::access;
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int)
+    {
+        ar & backend & path & random & read_ratio & block_size;
+        ar & queue_depth & threads & files & shared & file_size & ops;
+        ar & direct & seed;
+    }
+};
+
+// the requests of one kind issued by a locality
+struct operation_result
+{
+    boost::uint64_t ops;
+    boost::uint64_t bytes;
+    boost::uint64_t errors;         // failed and short transfers
+    std::vector<boost::uint64_t> latencies;     // [ns]
+
+    operation_result() : ops(0), bytes(0), errors(0) {}
+
+    void record(boost::uint64_t latency, boost::uint64_t len, bool complete)
+    {
+        ++ops;
+        bytes += len;
+        if (!complete)
+        {
+            ++errors;
+        }
+        latencies.push_back(latency);
+    }
+
+    void merge(operation_result const& r)
+    {
+        ops += r.ops;
+        bytes += r.bytes;
+        errors += r.errors;
+        latencies.insert(latencies.end(), r.latencies.begin(),
+            r.latencies.end());
+    }
+
+    friend class boost::serialization::access;
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int)
+    {
+        ar & ops & bytes & errors & latencies;
+    }
+};
+
+struct locality_result
+{
+    operation_result read;
+    operation_result write;
+    double elapsed;                 // [s], without opening the files
+    std::size_t failed_files;
+
+    locality_result() : elapsed(0.0), failed_files(0) {}
+
+    void merge(locality_result const& r)
+    {
+        read.merge(r.read);
+        write.merge(r.write);
+        elapsed = (std::max)(elapsed, r.elapsed);
+        failed_files += r.failed_files;
+    }
+
+    friend class boost::serialization::access;
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int)
+    {
+        ar & read & write & elapsed & failed_files;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+hpx::io::file make_backend_file(std::string const& backend)
+{
+#if defined(HPXIO_HAVE_ORANGEFS)
+    return hpx::io::make_file<hpx::io::local_file, hpx::io::partitioned_file,
+        hpx::io::orangefs_file, hpx::io::pxfs_file>(backend);
+#else
+    return hpx::io::make_file<hpx::io::local_file,
+        hpx::io::partitioned_file>(backend);
+#endif
+}
+
+std::string file_name(benchmark_config const& cfg, std::size_t index)
+{
+    std::ostringstream name;
+    name << cfg.path << "/io_benchmark_" << cfg.backend << "_"
+         << hpx::get_locality_id() << "_" << index;
+    return name.str();
+}
+
+// open all files of this locality, invalid files could not be opened
+std::vector<hpx::io::file> open_files(benchmark_config const& cfg,
+    std::string mode)
+{
+    if (cfg.direct)
+    {
+        mode += "d";
+    }
+
+    std::vector<hpx::io::file> files;
+    std::vector<hpx::lcos::future<int> > lazy_results;
+    for (std::size_t i = 0; i != cfg.files_per_locality(); ++i)
+    {
+        files.push_back(make_backend_file(cfg.backend));
+        lazy_results.push_back(files.back().open(file_name(cfg, i), mode));
+    }
+
+    for (std::size_t i = 0; i != files.size(); ++i)
+    {
+        if (lazy_results[i].get() != 0)
+        {
+            hpx::cerr << "Unable to open " << file_name(cfg, i) << hpx::endl;
+            files[i] = hpx::io::file();
+        }
+    }
+    return files;
+}
+
+void close_files(std::vector<hpx::io::file>& files)
+{
+    std::vector<hpx::lcos::future<int> > lazy_results;
+    BOOST_FOREACH(hpx::io::file& f, files)
+    {
+        if (f.valid())
+        {
+            lazy_results.push_back(f.close());
+        }
+    }
+    hpx::wait_all(lazy_results);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// create the files of this locality and fill them, returns the number of
+// files which could not be written completely
+std::size_t prepare_files(benchmark_config const& cfg)
+{
+    std::vector<hpx::io::file> files = open_files(cfg, "w");
+
+    std::vector<char> data(1024 * 1024);
+    boost::random::mt19937 gen(static_cast<boost::uint32_t>(cfg.seed));
+    std::generate(data.begin(), data.end(), gen);
+
+    std::vector<hpx::lcos::future<bool> > lazy_results;
+    BOOST_FOREACH(hpx::io::file& f, files)
+    {
+        if (!f.valid())
+        {
+            lazy_results.push_back(hpx::make_ready_future(false));
+            continue;
+        }
+
+        hpx::io::file file(f);
+        boost::uint64_t const size = cfg.file_size;
+        lazy_results.push_back(hpx::async(
+            [file, size, &data]() mutable -> bool
+            {
+                hpx::io::file_writer<hpx::io::file> w(file);
+                for (boost::uint64_t done = 0; done < size; )
+                {
+                    std::size_t const len = static_cast<std::size_t>(
+                        (std::min)(boost::uint64_t(data.size()),
+                            size - done));
+                    if (!w.write(data.data(), len))
+                    {
+                        break;
+                    }
+                    done += len;
+                }
+                return w.flush_sync() == ssize_t(size) &&
+                    file.fsync_sync() == 0;
+            }));
+    }
+
+    std::size_t failed = 0;
+    for (std::size_t i = 0; i != lazy_results.size(); ++i)
+    {
+        if (!lazy_results[i].get())
+        {
+            ++failed;
+        }
+    }
+
+    close_files(files);
+    return failed;
+}
+
+HPX_PLAIN_ACTION(prepare_files, prepare_files_action);
+
+// returns the number of files which could not be removed
+std::size_t remove_files(benchmark_config const& cfg)
+{
+    std::size_t failed = 0;
+    for (std::size_t i = 0; i != cfg.files_per_locality(); ++i)
+    {
+        hpx::io::file f = make_backend_file(cfg.backend);
+        if (f.remove_file_sync(file_name(cfg, i)) != 0)
+        {
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+HPX_PLAIN_ACTION(remove_files, remove_files_action);
+
+///////////////////////////////////////////////////////////////////////////////
+// One I/O stream. All of its lanes, queue_depth of them, take the next
+// request from the shared counter, so a sequential stream stays in order
+// while queue_depth requests are in flight.
+struct stream
+{
+    std::vector<hpx::io::file> files_;
+    boost::uint64_t blocks_;        // in all of files_
+    boost::uint64_t first_block_;   // where a sequential stream starts
+    boost::uint64_t ops_;
+    boost::atomic<boost::uint64_t> next_;
+
+    stream() : blocks_(0), first_block_(0), ops_(0), next_(0) {}
+};
+
+locality_result run_lane(benchmark_config const& cfg, stream& s,
+    boost::uint64_t seed)
+{
+    boost::random::mt19937_64 gen(seed);
+    boost::random::uniform_int_distribution<boost::uint64_t>
+        random_block(0, s.blocks_ - 1);
+    boost::random::uniform_int_distribution<int> percent(0, 99);
+
+    std::vector<char> data(static_cast<std::size_t>(cfg.block_size));
+    std::generate(data.begin(), data.end(), gen);
+
+    boost::uint64_t const blocks_per_file = cfg.blocks_per_file();
+    std::size_t const count = data.size();
+
+    locality_result r;
+    for (;;)
+    {
+        boost::uint64_t const i = s.next_++;
+        if (i >= s.ops_)
+        {
+            break;
+        }
+
+        boost::uint64_t const block = cfg.random ?
+            random_block(gen) : (s.first_block_ + i) % s.blocks_;
+        hpx::io::file& f = s.files_[block / blocks_per_file];
+        off_t const offset = off_t((block % blocks_per_file) * count);
+        bool const read = percent(gen) < cfg.read_ratio;
+
+        boost::uint64_t const start = hpx::util::high_resolution_clock::now();
+        if (read)
+        {
+            std::vector<char> buf = f.pread_sync(count, offset);
+            r.read.record(hpx::util::high_resolution_clock::now() - start,
+                buf.size(), buf.size() == count);
+        }
+        else
+        {
+            ssize_t const len = f.pwrite_sync(data, offset);
+            r.write.record(hpx::util::high_resolution_clock::now() - start,
+                (len > 0) ? len : 0, len == ssize_t(count));
+        }
+    }
+    return r;
+}
+
+locality_result run_benchmark(benchmark_config const& cfg)
+{
+    std::vector<hpx::io::file> files =
+        open_files(cfg, (cfg.read_ratio == 100) ? "r" : "r+");
+
+    locality_result result;
+    BOOST_FOREACH(hpx::io::file const& f, files)
+    {
+        if (!f.valid())
+        {
+            ++result.failed_files;
+        }
+    }
+    if (result.failed_files != 0)
+    {
+        close_files(files);
+        return result;
+    }
+
+    // split the files among the streams
+    std::vector<boost::shared_ptr<stream> > streams;
+    for (std::size_t t = 0; t != cfg.threads; ++t)
+    {
+        boost::shared_ptr<stream> s = boost::make_shared<stream>();
+        if (cfg.shared)
+        {
+            s->files_ = files;
+        }
+        else
+        {
+            s->files_.assign(files.begin() + t * cfg.files,
+                files.begin() + (t + 1) * cfg.files);
+        }
+
+        s->blocks_ = s->files_.size() * cfg.blocks_per_file();
+        boost::uint64_t const share =
+            cfg.shared ? s->blocks_ / cfg.threads : s->blocks_;
+        s->first_block_ = cfg.shared ? t * share : 0;
+        s->ops_ = (cfg.ops != 0) ? cfg.ops : (std::max)(share,
+            boost::uint64_t(1));
+        streams.push_back(s);
+    }
+
+    boost::uint64_t const seed = cfg.seed + 1000003 * hpx::get_locality_id();
+    boost::uint64_t const start = hpx::util::high_resolution_clock::now();
+
+    std::vector<hpx::lcos::future<locality_result> > lazy_results;
+    for (std::size_t t = 0; t != streams.size(); ++t)
+    {
+        for (std::size_t lane = 0; lane != cfg.queue_depth; ++lane)
+        {
+            stream& s = *streams[t];
+            boost::uint64_t const lane_seed =
+                seed + 1009 * t + lane;
+            lazy_results.push_back(hpx::async(
+                [&cfg, &s, lane_seed]() -> locality_result
+                {
+                    return run_lane(cfg, s, lane_seed);
+                }));
+        }
+    }
+
+    for (std::size_t i = 0; i != lazy_results.size(); ++i)
+    {
+        result.merge(lazy_results[i].get());
+    }
+    result.elapsed = (hpx::util::high_resolution_clock::now() - start) * 1e-9;
+
+    close_files(files);
+    return result;
+}
+
+HPX_PLAIN_ACTION(run_benchmark, run_benchmark_action);
+
+///////////////////////////////////////////////////////////////////////////////
+std::string json_string(std::string const& s)
+{
+    std::ostringstream out;
+    out << '"';
+    BOOST_FOREACH(char c, s)
+    {
+        switch (c)
+        {
+        case '"':  out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                    << int(c) << std::dec;
+            }
+            else
+            {
+                out << c;
+            }
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+std::string json_operation(operation_result r, double elapsed)
+{
+    std::sort(r.latencies.begin(), r.latencies.end());
+
+    boost::uint64_t sum = 0;
+    BOOST_FOREACH(boost::uint64_t l, r.latencies)
+    {
+        sum += l;
+    }
+
+    std::ostringstream out;
+    out << "{\"ops\": " << r.ops
+        << ", \"bytes\": " << r.bytes
+        << ", \"errors\": " << r.errors
+        << ", \"iops\": " << ((elapsed > 0.0) ? r.ops / elapsed : 0.0)
+        << ", \"throughput_mib_s\": " << ((elapsed > 0.0) ?
+            r.bytes / elapsed / (1024 * 1024) : 0.0)
+        << ", \"latency_ns\": {";
+
+    if (r.latencies.empty())
+    {
+        out << "}}";
+        return out.str();
+    }
+
+    char const* const names[] = { "p50", "p90", "p99", "p999" };
+    double const fractions[] = { 0.5, 0.9, 0.99, 0.999 };
+
+    out << "\"mean\": " << sum / r.latencies.size();
+    for (std::size_t i = 0; i != 4; ++i)
+    {
+        std::size_t const idx = (std::min)(r.latencies.size() - 1,
+            static_cast<std::size_t>(fractions[i] * r.latencies.size()));
+        out << ", \"" << names[i] << "\": " << r.latencies[idx];
+    }
+    out << ", \"max\": " << r.latencies.back() << "}}";
+    return out.str();
+}
+
+std::string json_run(benchmark_config const& cfg, std::size_t localities,
+    locality_result const& r)
+{
+    std::ostringstream out;
+    out << "    {\"backend\": " << json_string(cfg.backend)
+        << ", \"pattern\": \"" << (cfg.random ? "random" : "sequential")
+        << "\", \"read_ratio\": " << cfg.read_ratio
+        << ", \"block_size\": " << cfg.block_size
+        << ", \"queue_depth\": " << cfg.queue_depth
+        << ", \"threads\": " << cfg.threads
+        << ", \"files\": " << cfg.files
+        << ", \"sharing\": \"" << (cfg.shared ? "shared" : "per-thread")
+        << "\", \"file_size\": " << cfg.file_size
+        << ", \"direct\": " << (cfg.direct ? "true" : "false")
+        << ", \"localities\": " << localities
+        << ",\n     \"elapsed_s\": " << r.elapsed
+        << ", \"failed_files\": " << r.failed_files
+        << ",\n     \"read\": " << json_operation(r.read, r.elapsed)
+        << ",\n     \"write\": " << json_operation(r.write, r.elapsed)
+        << "}";
+    return out.str();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> split_list(std::string const& list)
+{
+    std::vector<std::string> result;
+    boost::algorithm::split(result, list, boost::algorithm::is_any_of(","),
+        boost::algorithm::token_compress_on);
+    result.erase(std::remove(result.begin(), result.end(), std::string()),
+        result.end());
+    return result;
+}
+
+// sizes may carry a k, m or g suffix
+boost::uint64_t parse_size(std::string s)
+{
+    boost::uint64_t unit = 1;
+    if (!s.empty())
+    {
+        switch (s[s.size() - 1])
+        {
+        case 'k': case 'K': unit = 1024; break;
+        case 'm': case 'M': unit = 1024 * 1024; break;
+        case 'g': case 'G': unit = 1024 * 1024 * 1024; break;
+        default: break;
+        }
+        if (unit != 1)
+        {
+            s.erase(s.size() - 1);
+        }
+    }
+    return unit * boost::lexical_cast<boost::uint64_t>(s);
+}
+
+template <typename T>
+std::vector<T> parse_list(std::string const& list)
+{
+    std::vector<T> result;
+    BOOST_FOREACH(std::string const& s, split_list(list))
+    {
+        result.push_back(static_cast<T>(parse_size(s)));
+    }
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename Action, typename Result>
+std::vector<Result> on_all_localities(benchmark_config const& cfg)
+{
+    std::vector<hpx::id_type> localities = hpx::find_all_localities();
+
+    std::vector<hpx::lcos::future<Result> > lazy_results;
+    BOOST_FOREACH(hpx::id_type const& node, localities)
+    {
+        lazy_results.push_back(hpx::async<Action>(node, cfg));
+    }
+
+    std::vector<Result> results;
+    for (std::size_t i = 0; i != lazy_results.size(); ++i)
+    {
+        results.push_back(lazy_results[i].get());
+    }
+    return results;
+}
+
+int hpx_main(variables_map& vm)
+{
+    std::vector<std::string> backends =
+        split_list(vm["backend"].as<std::string>());
+    std::vector<std::string> patterns =
+        split_list(vm["pattern"].as<std::string>());
+    std::vector<int> read_ratios =
+        parse_list<int>(vm["read-ratio"].as<std::string>());
+    std::vector<boost::uint64_t> block_sizes =
+        parse_list<boost::uint64_t>(vm["block-size"].as<std::string>());
+    std::vector<std::size_t> queue_depths =
+        parse_list<std::size_t>(vm["queue-depth"].as<std::string>());
+    std::vector<std::size_t> threads =
+        parse_list<std::size_t>(vm["threads"].as<std::string>());
+
+    benchmark_config cfg;
+    cfg.files = vm["files"].as<std::size_t>();
+    cfg.shared = vm["sharing"].as<std::string>() == "shared";
+    cfg.file_size = parse_size(vm["file-size"].as<std::string>());
+    cfg.ops = vm["ops"].as<boost::uint64_t>();
+    cfg.direct = vm.count("direct") != 0;
+    cfg.seed = vm["seed"].as<boost::uint64_t>();
+
+    bool argument_error = false;
+    if (vm.count("path"))
+    {
+        cfg.path = vm["path"].as<std::string>();
+    }
+    else
+    {
+        hpx::cerr << "Need to specify test path!!" << hpx::endl;
+        argument_error = true;
+    }
+
+    if (cfg.files == 0)
+    {
+        hpx::cerr << "need at least one file" << hpx::endl;
+        argument_error = true;
+    }
+
+    BOOST_FOREACH(std::string const& b, backends)
+    {
+        if (!make_backend_file(b).valid())
+        {
+            hpx::cerr << "unknown backend " << b << hpx::endl;
+            argument_error = true;
+        }
+    }
+    BOOST_FOREACH(std::string const& p, patterns)
+    {
+        if (p != "sequential" && p != "random")
+        {
+            hpx::cerr << "unknown pattern " << p << hpx::endl;
+            argument_error = true;
+        }
+    }
+    BOOST_FOREACH(int r, read_ratios)
+    {
+        if (r < 0 || r > 100)
+        {
+            hpx::cerr << "read ratio has to be within [0, 100]" << hpx::endl;
+            argument_error = true;
+        }
+    }
+    BOOST_FOREACH(boost::uint64_t b, block_sizes)
+    {
+        if (b == 0 || b > cfg.file_size)
+        {
+            hpx::cerr << "block size has to be within [1, file size]"
+                << hpx::endl;
+            argument_error = true;
+        }
+    }
+    if (std::count(queue_depths.begin(), queue_depths.end(), 0) != 0 ||
+        std::count(threads.begin(), threads.end(), 0) != 0)
+    {
+        hpx::cerr << "need at least one thread and queue depth one"
+            << hpx::endl;
+        argument_error = true;
+    }
+
+    if (argument_error || backends.empty() || patterns.empty() ||
+        read_ratios.empty() || block_sizes.empty() || queue_depths.empty() ||
+        threads.empty())
+    {
+        return hpx::finalize();
+    }
+
+    std::size_t const localities = hpx::find_all_localities().size();
+    std::vector<std::string> runs;
+
+    BOOST_FOREACH(std::string const& backend, backends)
+    {
+        cfg.backend = backend;
+        BOOST_FOREACH(std::size_t t, threads)
+        {
+            cfg.threads = t;
+
+            std::vector<std::size_t> failed =
+                on_all_localities<prepare_files_action, std::size_t>(cfg);
+            if (std::count(failed.begin(), failed.end(), 0) !=
+                std::ptrdiff_t(failed.size()))
+            {
+                hpx::cerr << "unable to prepare the " << backend
+                    << " test files" << hpx::endl;
+                continue;
+            }
+
+            BOOST_FOREACH(std::string const& pattern, patterns)
+            BOOST_FOREACH(int read_ratio, read_ratios)
+            BOOST_FOREACH(boost::uint64_t block_size, block_sizes)
+            BOOST_FOREACH(std::size_t queue_depth, queue_depths)
+            {
+                cfg.random = pattern == "random";
+                cfg.read_ratio = read_ratio;
+                cfg.block_size = block_size;
+                cfg.queue_depth = queue_depth;
+
+                std::vector<locality_result> results =
+                    on_all_localities<run_benchmark_action,
+                        locality_result>(cfg);
+
+                locality_result total;
+                BOOST_FOREACH(locality_result const& r, results)
+                {
+                    total.merge(r);
+                }
+                runs.push_back(json_run(cfg, localities, total));
+            }
+
+            if (vm.count("remove"))
+            {
+                on_all_localities<remove_files_action, std::size_t>(cfg);
+            }
+        }
+    }
+
+    std::ostringstream out;
+    out << "{\"benchmark\": \"io_benchmark\", \"runs\": [\n";
+    for (std::size_t i = 0; i != runs.size(); ++i)
+    {
+        out << runs[i] << ((i + 1 != runs.size()) ? ",\n" : "\n");
+    }
+    out << "]}\n";
+
+    if (vm.count("output"))
+    {
+        std::ofstream file(vm["output"].as<std::string>().c_str());
+        file << out.str();
+    }
+    else
+    {
+        hpx::cout << out.str() << hpx::flush;
+    }
+
+    return hpx::finalize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    // Configure application-specific options
+    options_description
+       desc_commandline("Usage: " HPX_APPLICATION_STRING " [options]");
+
+    desc_commandline.add_options()
+        ( "path" , value<std::string>(),
+            "file path to place the testing files.")
+        ( "backend", value<std::string>()->default_value("local_file"),
+            "file types to test: local_file, partitioned_file, "
+            "orangefs_file, pxfs_file")
+        ( "pattern", value<std::string>()->default_value("sequential"),
+            "access patterns to test: sequential, random")
+        ( "read-ratio", value<std::string>()->default_value("100"),
+            "percentages of requests which read, the others write")
+        ( "block-size", value<std::string>()->default_value("1m"),
+            "request sizes (in bytes, with optional k, m, g suffix)")
+        ( "queue-depth", value<std::string>()->default_value("1"),
+            "requests in flight per thread")
+        ( "threads", value<std::string>()->default_value("1"),
+            "I/O threads per locality")
+        ( "files", value<std::size_t>()->default_value(1),
+            "number of files per thread, or per locality if shared")
+        ( "sharing", value<std::string>()->default_value("per-thread"),
+            "per-thread: one set of files per thread, "
+            "shared: all threads access the same files")
+        ( "file-size", value<std::string>()->default_value("64m"),
+            "size of each file (in bytes, with optional k, m, g suffix)")
+        ( "ops", value<boost::uint64_t>()->default_value(0),
+            "requests per thread, 0: one pass over the thread's share")
+        ( "direct", "open the files with O_DIRECT where supported.")
+        ( "seed", value<boost::uint64_t>()->default_value(42),
+            "seed of the random offsets and data")
+        ( "output", value<std::string>(),
+            "write the JSON results to this file instead of stdout.")
+        ( "remove", "remove files after test.")
+        ;
+
+#if defined(HPXIO_HAVE_ORANGEFS)
+    hpx::register_startup_function(&hpx::io::register_pxfs_counters);
+#endif
+
+    // Initialize and run HPX
+    return init(desc_commandline, argc, argv);
+}
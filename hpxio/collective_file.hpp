@@ -0,0 +1,298 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_COLLECTIVE_FILE_HPP_JUN_26_2015_0420PM)
+#define HPX_COMPONENTS_IO_COLLECTIVE_FILE_HPP_JUN_26_2015_0420PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/naming.hpp>
+#include <hpx/util/serialize_buffer.hpp>
+#include <hpxio/extent.hpp>
+#include <hpxio/server/vector_buffer.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Two-phase collective I/O in the style of MPI-IO on top of local_file
+    // or orangefs_file components. A small set of file components, usually
+    // one on each of a few localities and all opened on the same shared
+    // file, act as aggregators. The file is divided into domains of
+    // domain_size bytes which are assigned round-robin to the aggregators.
+    //
+    // Every participating HPX thread uses its own copy of the collective_file
+    // and all participants call the collective operations in the same
+    // order. A call splits the caller's extents at domain boundaries and
+    // hands every aggregator its part, an empty one if need be. An
+    // aggregator waits for all participants, merges their extents into
+    // large contiguous ranges and is the only one accessing the file system.
+    //
+    // The copies can be passed to participants on other localities.
+    template <typename File>
+    class collective_file
+    {
+      private:
+        typedef hpx::util::serialize_buffer<char> buffer_type;
+
+        // the extents and data of one call going to one aggregator
+        struct part
+        {
+            std::vector<extent> extents;
+            std::vector<std::size_t> pos;   // position within the call's data
+        };
+
+      public:
+        collective_file()
+          : participants_(0), domain_size_(0), round_(0)
+        {}
+
+        // aggregators are the ids of opened file components
+        collective_file(std::vector<naming::id_type> const& aggregators,
+                std::size_t participants,
+                std::size_t domain_size = 4 * 1024 * 1024)
+          : aggregators_(aggregators), participants_(participants),
+            domain_size_((std::max)(domain_size, std::size_t(1))), round_(0)
+        {}
+
+        std::size_t participants() const
+        {
+            return participants_;
+        }
+
+        std::vector<naming::id_type> const& aggregators() const
+        {
+            return aggregators_;
+        }
+
+        // write the extents, whose data is laid out back to back in buf;
+        // returns buf.size() once all participants' data is written, -1 if
+        // any of it failed
+        lcos::future<ssize_t> write_all(std::vector<extent> const& extents,
+                std::vector<char> const& buf)
+        {
+            boost::uint64_t const round = round_++;
+
+            // a mismatching buffer still takes part in the round, without
+            // any data
+            bool const valid = total_count(extents) == buf.size();
+            std::vector<part> parts =
+                split(valid ? extents : std::vector<extent>());
+
+            std::vector<lcos::future<ssize_t> > lazy_results;
+            lazy_results.reserve(parts.size());
+            for (std::size_t i = 0; i != parts.size(); ++i)
+            {
+                std::vector<char> data;
+                data.reserve(total_count(parts[i].extents));
+                for (std::size_t j = 0; j != parts[i].extents.size(); ++j)
+                {
+                    std::size_t const pos = parts[i].pos[j];
+                    data.insert(data.end(), buf.begin() + pos,
+                        buf.begin() + pos + parts[i].extents[j].count);
+                }
+
+                File f(aggregators_[i]);
+                lazy_results.push_back(f.collective_write(round,
+                    participants_, parts[i].extents,
+                    server::to_buffer(std::move(data))));
+            }
+
+            std::size_t const count = buf.size();
+            return hpx::when_all(lazy_results).then(
+                [count, valid](
+                    lcos::future<std::vector<lcos::future<ssize_t> > > f)
+                    -> ssize_t
+                {
+                    std::vector<lcos::future<ssize_t> > r = f.get();
+                    ssize_t result = valid ? ssize_t(count) : -1;
+                    for (std::size_t i = 0; i != r.size(); ++i)
+                    {
+                        if (r[i].get() < 0)
+                        {
+                            result = -1;
+                        }
+                    }
+                    return result;
+                });
+        }
+
+        ssize_t write_all_sync(std::vector<extent> const& extents,
+                std::vector<char> const& buf)
+        {
+            return write_all(extents, buf).get();
+        }
+
+        lcos::future<ssize_t> write_at_all(std::vector<char> const& buf,
+                off_t const offset)
+        {
+            return write_all(single_extent(offset, buf.size()), buf);
+        }
+
+        ssize_t write_at_all_sync(std::vector<char> const& buf,
+                off_t const offset)
+        {
+            return write_at_all(buf, offset).get();
+        }
+
+        // read the extents, their data is returned back to back and ends
+        // with the first extent which could not be read completely
+        lcos::future<std::vector<char> > read_all(
+                std::vector<extent> const& extents)
+        {
+            boost::uint64_t const round = round_++;
+            boost::shared_ptr<std::vector<part> > parts =
+                boost::make_shared<std::vector<part> >(split(extents));
+
+            std::vector<lcos::future<buffer_type> > lazy_results;
+            lazy_results.reserve(parts->size());
+            for (std::size_t i = 0; i != parts->size(); ++i)
+            {
+                File f(aggregators_[i]);
+                lazy_results.push_back(f.collective_read(round,
+                    participants_, (*parts)[i].extents));
+            }
+
+            std::size_t const count = total_count(extents);
+            return hpx::when_all(lazy_results).then(
+                [parts, count](lcos::future<
+                    std::vector<lcos::future<buffer_type> > > f)
+                {
+                    std::vector<lcos::future<buffer_type> > r = f.get();
+
+                    // (position, length) of every piece that arrived
+                    std::vector<std::pair<std::size_t, std::size_t> > pieces;
+                    std::vector<char> result(count);
+                    for (std::size_t i = 0; i != r.size(); ++i)
+                    {
+                        buffer_type data = r[i].get();
+                        part const& p = (*parts)[i];
+
+                        std::size_t done = 0;
+                        for (std::size_t j = 0;
+                             j != p.extents.size() && done < data.size(); ++j)
+                        {
+                            std::size_t len = (std::min)(p.extents[j].count,
+                                data.size() - done);
+                            std::memcpy(result.data() + p.pos[j],
+                                data.data() + done, len);
+                            pieces.push_back(std::make_pair(p.pos[j], len));
+                            done += len;
+                        }
+                    }
+
+                    // the result ends at the first gap
+                    std::sort(pieces.begin(), pieces.end());
+                    std::size_t end = 0;
+                    for (std::size_t i = 0; i != pieces.size(); ++i)
+                    {
+                        if (pieces[i].first != end)
+                        {
+                            break;
+                        }
+                        end += pieces[i].second;
+                    }
+                    result.resize(end);
+                    return result;
+                });
+        }
+
+        std::vector<char> read_all_sync(std::vector<extent> const& extents)
+        {
+            return read_all(extents).get();
+        }
+
+        lcos::future<std::vector<char> > read_at_all(size_t const count,
+                off_t const offset)
+        {
+            return read_all(single_extent(offset, count));
+        }
+
+        std::vector<char> read_at_all_sync(size_t const count,
+                off_t const offset)
+        {
+            return read_at_all(count, offset).get();
+        }
+
+      private:
+        static std::vector<extent> single_extent(off_t offset,
+            std::size_t count)
+        {
+            std::vector<extent> extents;
+            if (count != 0)
+            {
+                extents.push_back(extent(offset, count));
+            }
+            return extents;
+        }
+
+        // cut the extents at domain boundaries, domain d goes to aggregator
+        // d % aggregators
+        std::vector<part> split(std::vector<extent> const& extents) const
+        {
+            std::vector<part> parts(aggregators_.size());
+            if (parts.empty())
+            {
+                return parts;
+            }
+
+            off_t const ds = domain_size_;
+            std::size_t pos = 0;
+            for (std::size_t i = 0; i != extents.size(); ++i)
+            {
+                extent const& e = extents[i];
+                if (e.offset < 0)
+                {
+                    break;
+                }
+
+                off_t const end = e.offset + e.count;
+                for (off_t o = e.offset; o < end; /**/)
+                {
+                    off_t const domain = o / ds;
+                    off_t const next = (std::min)((domain + 1) * ds, end);
+
+                    part& p = parts[domain % aggregators_.size()];
+                    p.extents.push_back(extent(o, next - o));
+                    p.pos.push_back(pos);
+
+                    pos += next - o;
+                    o = next;
+                }
+            }
+            return parts;
+        }
+
+        friend class boost::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned int const)
+        {
+            ar & aggregators_;
+            ar & participants_;
+            ar & domain_size_;
+            ar & round_;
+        }
+
+        std::vector<naming::id_type> aggregators_;
+        std::size_t participants_;
+        std::size_t domain_size_;
+        boost::uint64_t round_;
+    };
+
+}} // hpx::io
+
+#endif
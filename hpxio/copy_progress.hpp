@@ -0,0 +1,43 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_COPY_PROGRESS_HPP_JUL_15_2015_0930AM)
+#define HPX_COMPONENTS_IO_COPY_PROGRESS_HPP_JUL_15_2015_0930AM
+
+#include <boost/cstdint.hpp>
+#include <boost/serialization/access.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // The state of a server-side copy. copied counts the bytes which reached
+    // the destination, result is the number of bytes copied (or -1) once
+    // the copy is done. A copy ends early at the end of the source file.
+    struct copy_progress
+    {
+        copy_progress() : count(0), copied(0), done(false), result(0) {}
+
+        boost::uint64_t count;
+        boost::uint64_t copied;
+        bool done;
+        boost::int64_t result;
+
+      private:
+        friend class boost::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned int const)
+        {
+            ar & count;
+            ar & copied;
+            ar & done;
+            ar & result;
+        }
+    };
+
+}} // hpx::io
+
+#endif
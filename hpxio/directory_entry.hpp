@@ -0,0 +1,47 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_DIRECTORY_ENTRY_HPP_JUL_10_2015_0940AM)
+#define HPX_COMPONENTS_IO_DIRECTORY_ENTRY_HPP_JUL_10_2015_0940AM
+
+#include <boost/cstdint.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/string.hpp>
+
+#include <string>
+
+#include <dirent.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // One entry of a directory listing, type is one of the DT_* constants
+    // of <dirent.h>, DT_UNKNOWN if the file system does not tell.
+    struct directory_entry
+    {
+        directory_entry() : type(DT_UNKNOWN) {}
+
+        directory_entry(std::string const& n, boost::uint8_t t)
+          : name(n), type(t)
+        {}
+
+        std::string name;
+        boost::uint8_t type;
+
+      private:
+        friend class boost::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned int const)
+        {
+            ar & name;
+            ar & type;
+        }
+    };
+
+}} // hpx::io
+
+#endif
@@ -0,0 +1,192 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_DIRECTORY_READER_HPP_JUL_10_2015_0330PM)
+#define HPX_COMPONENTS_IO_DIRECTORY_READER_HPP_JUL_10_2015_0330PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/include/async.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpxio/directory_entry.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Streams the entries of a directory in batches of up to batch_size
+    // entries through the opendir/readdir/closedir actions of a local_file
+    // or orangefs_file component, the directory is read on the component's
+    // locality. The next batch is requested while the current one is being
+    // processed, memory stays bounded by two batches even for directories
+    // with millions of entries.
+    //
+    // Copies refer to the same stream, which is meant to be used by one HPX
+    // thread at a time. The directory is closed at the end of the listing or
+    // once the last copy went away.
+    template <typename File>
+    class directory_reader
+    {
+      private:
+        struct state
+        {
+            state(File const& f, std::string const& path,
+                    std::size_t batch_size)
+              : file_(f),
+                batch_size_((std::max)(batch_size, std::size_t(1))),
+                handle_(file_.opendir(path)), closed_(false)
+            {
+                File file(f);
+                std::size_t const n = batch_size_;
+                pending_ = handle_.then(
+                    [file, n](lcos::shared_future<boost::uint64_t> h) mutable
+                        -> std::vector<directory_entry>
+                    {
+                        boost::uint64_t const handle = h.get();
+                        if (handle == 0)
+                        {
+                            return std::vector<directory_entry>();
+                        }
+                        return file.readdir_sync(handle, n);
+                    });
+            }
+
+            ~state()
+            {
+                close();
+            }
+
+            void close()
+            {
+                if (closed_)
+                {
+                    return;
+                }
+                closed_ = true;
+
+                // nobody waits for the directory to be closed
+                File file(file_);
+                handle_.then(
+                    [file](lcos::shared_future<boost::uint64_t> h) mutable
+                    {
+                        boost::uint64_t const handle = h.get();
+                        if (handle != 0)
+                        {
+                            file.closedir(handle);
+                        }
+                    });
+            }
+
+            File file_;
+            std::size_t batch_size_;
+            lcos::shared_future<boost::uint64_t> handle_;
+            bool closed_;
+
+            // the batch requested ahead, invalid at the end of the listing
+            lcos::future<std::vector<directory_entry> > pending_;
+        };
+
+        typedef boost::shared_ptr<state> state_ptr;
+
+      public:
+        directory_reader(File const& f, std::string const& path,
+                std::size_t batch_size = 4096)
+          : state_(boost::make_shared<state>(f, path, batch_size))
+        {}
+
+        // true if the directory could be opened
+        lcos::future<bool> is_open() const
+        {
+            return state_->handle_.then(
+                [](lcos::shared_future<boost::uint64_t> h)
+                {
+                    return h.get() != 0;
+                });
+        }
+
+        // The next batch of entries, an empty one at the end. The returned
+        // future has to become ready before next() is called again.
+        lcos::future<std::vector<directory_entry> > next()
+        {
+            state_ptr s = state_;
+            if (!s->pending_.valid())
+            {
+                return hpx::make_ready_future(std::vector<directory_entry>());
+            }
+
+            lcos::future<std::vector<directory_entry> > f =
+                std::move(s->pending_);
+            return f.then(
+                [s](lcos::future<std::vector<directory_entry> > f)
+                    -> std::vector<directory_entry>
+                {
+                    std::vector<directory_entry> batch = f.get();
+                    if (batch.empty())
+                    {
+                        s->close();
+                    }
+                    else
+                    {
+                        // ask for the next batch right away
+                        s->pending_ = s->file_.readdir(s->handle_.get(),
+                            s->batch_size_);
+                    }
+                    return batch;
+                });
+        }
+
+        std::vector<directory_entry> next_sync()
+        {
+            return next().get();
+        }
+
+        // Call f(entry) for every entry of the directory, the future holds
+        // the number of entries.
+        template <typename F>
+        lcos::future<std::size_t> for_each(F f)
+        {
+            directory_reader r(*this);
+            return hpx::async(
+                [r, f]() mutable -> std::size_t
+                {
+                    std::size_t count = 0;
+                    for (;;)
+                    {
+                        std::vector<directory_entry> batch = r.next_sync();
+                        if (batch.empty())
+                        {
+                            break;
+                        }
+
+                        for (std::size_t i = 0; i != batch.size(); ++i)
+                        {
+                            f(batch[i]);
+                        }
+                        count += batch.size();
+                    }
+                    return count;
+                });
+        }
+
+        template <typename F>
+        std::size_t for_each_sync(F f)
+        {
+            return for_each(f).get();
+        }
+
+      private:
+        state_ptr state_;
+    };
+
+}} // hpx::io
+
+#endif
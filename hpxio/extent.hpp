@@ -0,0 +1,56 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_EXTENT_HPP_JUN_05_2015_0330PM)
+#define HPX_COMPONENTS_IO_EXTENT_HPP_JUN_05_2015_0330PM
+
+#include <boost/serialization/access.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <sys/types.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // A contiguous byte range of a file as used by the vectored preadv and
+    // pwritev operations. The data of a list of extents is always laid out
+    // back to back in the order of the list.
+    struct extent
+    {
+        extent() : offset(0), count(0) {}
+
+        extent(off_t o, std::size_t c) : offset(o), count(c) {}
+
+        off_t offset;
+        std::size_t count;
+
+      private:
+        friend class boost::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned int const)
+        {
+            ar & offset;
+            ar & count;
+        }
+    };
+
+    // total number of bytes covered by a list of extents
+    inline std::size_t total_count(std::vector<extent> const& extents)
+    {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i != extents.size(); ++i)
+        {
+            total += extents[i].count;
+        }
+        return total;
+    }
+
+}} // hpx::io
+
+#endif
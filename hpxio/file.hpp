@@ -0,0 +1,588 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_FILE_HPP_JUL_08_2015_0930AM)
+#define HPX_COMPONENTS_IO_FILE_HPP_JUL_08_2015_0930AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/naming.hpp>
+#include <hpx/include/runtime.hpp>
+#include <hpx/runtime/get_config_entry.hpp>
+#include <hpxio/extent.hpp>
+#include <hpxio/local_file.hpp>
+#include <hpxio/open_mode.hpp>
+#include <hpxio/partitioned_file.hpp>
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // file_traits<File> adapts one of the file types to the common file
+    // concept used by the type-erased file below and by generic code:
+    //
+    //   open(f, name, mode)      -> future<int>, fopen() mode, 0 on success
+    //   is_open(f)               -> future<bool>
+    //   close(f)                 -> future<int>, 0 on success
+    //   remove_file(f, name)     -> future<int>, 0 on success
+    //   read(f, count), pread(f, count, offset), preadv(f, extents)
+    //                            -> future<std::vector<char> >
+    //   write(f, buf), pwrite(f, buf, offset), pwritev(f, extents, buf)
+    //                            -> future<ssize_t>
+    //   flush(f), fsync(f), fdatasync(f)
+    //                            -> future<int>, 0 on success
+    //   lseek(f, offset, whence) -> future<off_t>, the resulting offset
+    //   create(locality)         -> boost::shared_ptr<File>, a new instance
+    //   name()                   -> the name of the backend
+    //
+    // Operations a file type does not support fail with -1 or no data.
+    template <typename File>
+    struct file_traits;
+
+    // forwards everything to a client whose API follows local_file
+    template <typename File>
+    struct default_file_traits
+    {
+        static lcos::future<int> open(File& f, std::string const& name,
+            std::string const& mode)
+        {
+            File c(f);
+            return f.open(name, mode).then(
+                [c](lcos::future<void> r) mutable -> int
+                {
+                    r.get();
+                    return c.is_open_sync() ? 0 : -1;
+                });
+        }
+
+        static lcos::future<bool> is_open(File& f)
+        {
+            return f.is_open();
+        }
+
+        static lcos::future<int> close(File& f)
+        {
+            return f.close();
+        }
+
+        static lcos::future<int> remove_file(File& f, std::string const& name)
+        {
+            return f.remove_file(name);
+        }
+
+        static lcos::future<std::vector<char> > read(File& f,
+            std::size_t count)
+        {
+            return f.read(count);
+        }
+
+        static lcos::future<std::vector<char> > pread(File& f,
+            std::size_t count, off_t offset)
+        {
+            return f.pread(count, offset);
+        }
+
+        static lcos::future<std::vector<char> > preadv(File& f,
+            std::vector<extent> const& extents)
+        {
+            return f.preadv(extents);
+        }
+
+        static lcos::future<ssize_t> write(File& f,
+            std::vector<char> const& buf)
+        {
+            return f.write(buf);
+        }
+
+        static lcos::future<ssize_t> pwrite(File& f,
+            std::vector<char> const& buf, off_t offset)
+        {
+            return f.pwrite(buf, offset);
+        }
+
+        static lcos::future<ssize_t> pwritev(File& f,
+            std::vector<extent> const& extents, std::vector<char> const& buf)
+        {
+            return f.pwritev(extents, buf);
+        }
+
+        static lcos::future<int> flush(File& f)
+        {
+            return f.flush();
+        }
+
+        static lcos::future<int> fsync(File& f)
+        {
+            return f.fsync();
+        }
+
+        static lcos::future<int> fdatasync(File& f)
+        {
+            return f.fdatasync();
+        }
+
+        static lcos::future<off_t> lseek(File& f, off_t offset, int whence)
+        {
+            return f.lseek(offset, whence);
+        }
+
+        static boost::shared_ptr<File> create(naming::id_type const& locality)
+        {
+            return boost::make_shared<File>(File::create(locality));
+        }
+    };
+
+    template <>
+    struct file_traits<local_file>
+      : default_file_traits<local_file>
+    {
+        static char const* name()
+        {
+            return "local_file";
+        }
+
+        // local_file::lseek returns 0/-1
+        static lcos::future<off_t> lseek(local_file& f, off_t offset,
+            int whence)
+        {
+            return f.seek(offset, whence);
+        }
+    };
+
+    // a partitioned_file only supports positional I/O, it is spread over
+    // all localities regardless of the one given to create()
+    template <>
+    struct file_traits<partitioned_file>
+      : default_file_traits<partitioned_file>
+    {
+        static char const* name()
+        {
+            return "partitioned_file";
+        }
+
+        static lcos::future<std::vector<char> > read(partitioned_file&,
+            std::size_t)
+        {
+            return hpx::make_ready_future(std::vector<char>());
+        }
+
+        static lcos::future<std::vector<char> > preadv(partitioned_file& f,
+            std::vector<extent> const& extents)
+        {
+            if (extents.size() == 1)
+            {
+                return f.pread(extents[0].count, extents[0].offset);
+            }
+            return hpx::make_ready_future(std::vector<char>());
+        }
+
+        static lcos::future<ssize_t> write(partitioned_file&,
+            std::vector<char> const&)
+        {
+            return hpx::make_ready_future(ssize_t(-1));
+        }
+
+        static lcos::future<ssize_t> pwritev(partitioned_file& f,
+            std::vector<extent> const& extents, std::vector<char> const& buf)
+        {
+            if (extents.size() == 1 && extents[0].count == buf.size())
+            {
+                return f.pwrite(buf, extents[0].offset);
+            }
+            return hpx::make_ready_future(ssize_t(-1));
+        }
+
+        static lcos::future<int> fdatasync(partitioned_file& f)
+        {
+            return f.fsync();
+        }
+
+        static lcos::future<off_t> lseek(partitioned_file&, off_t, int)
+        {
+            return hpx::make_ready_future(off_t(-1));
+        }
+
+        static boost::shared_ptr<partitioned_file> create(
+            naming::id_type const&)
+        {
+            return boost::make_shared<partitioned_file>();
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // A handle to a file of any type for which file_traits are defined. It
+    // offers the same API for all of them, using fopen() style modes, so
+    // code and benchmarks can switch between backends at runtime. Copies
+    // refer to the same file object.
+    class file
+    {
+      private:
+        struct file_base
+        {
+            virtual ~file_base() {}
+
+            virtual char const* name() const = 0;
+
+            virtual lcos::future<int> open(std::string const& name,
+                std::string const& mode) = 0;
+            virtual lcos::future<bool> is_open() = 0;
+            virtual lcos::future<int> close() = 0;
+            virtual lcos::future<int> remove_file(
+                std::string const& name) = 0;
+
+            virtual lcos::future<std::vector<char> > read(
+                std::size_t count) = 0;
+            virtual lcos::future<std::vector<char> > pread(
+                std::size_t count, off_t offset) = 0;
+            virtual lcos::future<std::vector<char> > preadv(
+                std::vector<extent> const& extents) = 0;
+
+            virtual lcos::future<ssize_t> write(
+                std::vector<char> const& buf) = 0;
+            virtual lcos::future<ssize_t> pwrite(
+                std::vector<char> const& buf, off_t offset) = 0;
+            virtual lcos::future<ssize_t> pwritev(
+                std::vector<extent> const& extents,
+                std::vector<char> const& buf) = 0;
+
+            virtual lcos::future<int> flush() = 0;
+            virtual lcos::future<int> fsync() = 0;
+            virtual lcos::future<int> fdatasync() = 0;
+            virtual lcos::future<off_t> lseek(off_t offset, int whence) = 0;
+        };
+
+        template <typename File>
+        struct file_model : file_base
+        {
+            typedef file_traits<File> traits;
+
+            explicit file_model(boost::shared_ptr<File> const& f)
+              : f_(f)
+            {}
+
+            char const* name() const
+            {
+                return traits::name();
+            }
+
+            lcos::future<int> open(std::string const& name,
+                std::string const& mode)
+            {
+                return traits::open(*f_, name, mode);
+            }
+
+            lcos::future<bool> is_open()
+            {
+                return traits::is_open(*f_);
+            }
+
+            lcos::future<int> close()
+            {
+                return traits::close(*f_);
+            }
+
+            lcos::future<int> remove_file(std::string const& name)
+            {
+                return traits::remove_file(*f_, name);
+            }
+
+            lcos::future<std::vector<char> > read(std::size_t count)
+            {
+                return traits::read(*f_, count);
+            }
+
+            lcos::future<std::vector<char> > pread(std::size_t count,
+                off_t offset)
+            {
+                return traits::pread(*f_, count, offset);
+            }
+
+            lcos::future<std::vector<char> > preadv(
+                std::vector<extent> const& extents)
+            {
+                return traits::preadv(*f_, extents);
+            }
+
+            lcos::future<ssize_t> write(std::vector<char> const& buf)
+            {
+                return traits::write(*f_, buf);
+            }
+
+            lcos::future<ssize_t> pwrite(std::vector<char> const& buf,
+                off_t offset)
+            {
+                return traits::pwrite(*f_, buf, offset);
+            }
+
+            lcos::future<ssize_t> pwritev(std::vector<extent> const& extents,
+                std::vector<char> const& buf)
+            {
+                return traits::pwritev(*f_, extents, buf);
+            }
+
+            lcos::future<int> flush()
+            {
+                return traits::flush(*f_);
+            }
+
+            lcos::future<int> fsync()
+            {
+                return traits::fsync(*f_);
+            }
+
+            lcos::future<int> fdatasync()
+            {
+                return traits::fdatasync(*f_);
+            }
+
+            lcos::future<off_t> lseek(off_t offset, int whence)
+            {
+                return traits::lseek(*f_, offset, whence);
+            }
+
+            boost::shared_ptr<File> f_;
+        };
+
+      public:
+        file() {}
+
+        // share a file object, this works for all file types
+        template <typename File>
+        explicit file(boost::shared_ptr<File> const& f)
+          : impl_(boost::make_shared<file_model<File> >(f))
+        {}
+
+        // wrap a copy of a component client
+        template <typename File>
+        explicit file(File const& f)
+          : impl_(boost::make_shared<file_model<File> >(
+                boost::make_shared<File>(f)))
+        {}
+
+        // a new file object of the given type
+        template <typename File>
+        static file create(naming::id_type const& locality = hpx::find_here())
+        {
+            return file(file_traits<File>::create(locality));
+        }
+
+        bool valid() const
+        {
+            return impl_.get() != 0;
+        }
+
+        // the backend, file_traits<>::name()
+        char const* name() const
+        {
+            return impl_->name();
+        }
+
+        lcos::future<int> open(std::string const& name,
+                std::string const& mode)
+        {
+            return impl_->open(name, mode);
+        }
+
+        int open_sync(std::string const& name, std::string const& mode)
+        {
+            return open(name, mode).get();
+        }
+
+        lcos::future<bool> is_open()
+        {
+            return impl_->is_open();
+        }
+
+        bool is_open_sync()
+        {
+            return is_open().get();
+        }
+
+        lcos::future<int> close()
+        {
+            return impl_->close();
+        }
+
+        int close_sync()
+        {
+            return close().get();
+        }
+
+        lcos::future<int> remove_file(std::string const& file_name)
+        {
+            return impl_->remove_file(file_name);
+        }
+
+        int remove_file_sync(std::string const& file_name)
+        {
+            return remove_file(file_name).get();
+        }
+
+        lcos::future<std::vector<char> > read(size_t const count)
+        {
+            return impl_->read(count);
+        }
+
+        std::vector<char> read_sync(size_t const count)
+        {
+            return read(count).get();
+        }
+
+        lcos::future<std::vector<char> > pread(size_t const count,
+                off_t const offset)
+        {
+            return impl_->pread(count, offset);
+        }
+
+        std::vector<char> pread_sync(size_t const count, off_t const offset)
+        {
+            return pread(count, offset).get();
+        }
+
+        lcos::future<std::vector<char> > preadv(
+                std::vector<extent> const& extents)
+        {
+            return impl_->preadv(extents);
+        }
+
+        std::vector<char> preadv_sync(std::vector<extent> const& extents)
+        {
+            return preadv(extents).get();
+        }
+
+        lcos::future<ssize_t> write(std::vector<char> const& buf)
+        {
+            return impl_->write(buf);
+        }
+
+        ssize_t write_sync(std::vector<char> const& buf)
+        {
+            return write(buf).get();
+        }
+
+        lcos::future<ssize_t> pwrite(std::vector<char> const& buf,
+                off_t const offset)
+        {
+            return impl_->pwrite(buf, offset);
+        }
+
+        ssize_t pwrite_sync(std::vector<char> const& buf, off_t const offset)
+        {
+            return pwrite(buf, offset).get();
+        }
+
+        lcos::future<ssize_t> pwritev(std::vector<extent> const& extents,
+                std::vector<char> const& buf)
+        {
+            return impl_->pwritev(extents, buf);
+        }
+
+        ssize_t pwritev_sync(std::vector<extent> const& extents,
+                std::vector<char> const& buf)
+        {
+            return pwritev(extents, buf).get();
+        }
+
+        lcos::future<int> flush()
+        {
+            return impl_->flush();
+        }
+
+        int flush_sync()
+        {
+            return flush().get();
+        }
+
+        lcos::future<int> fsync()
+        {
+            return impl_->fsync();
+        }
+
+        int fsync_sync()
+        {
+            return fsync().get();
+        }
+
+        lcos::future<int> fdatasync()
+        {
+            return impl_->fdatasync();
+        }
+
+        int fdatasync_sync()
+        {
+            return fdatasync().get();
+        }
+
+        lcos::future<off_t> lseek(off_t const offset, int const whence)
+        {
+            return impl_->lseek(offset, whence);
+        }
+
+        off_t lseek_sync(off_t const offset, int const whence)
+        {
+            return lseek(offset, whence).get();
+        }
+
+      private:
+        boost::shared_ptr<file_base> impl_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Create a file of the backend with the given name, chosen among the
+    // listed file types, e.g.
+    //
+    //   file f = make_file<local_file, orangefs_file>(default_backend());
+    //
+    // An unknown backend results in an invalid file.
+    template <typename... Files>
+    struct file_factory;
+
+    template <>
+    struct file_factory<>
+    {
+        static file create(std::string const&, naming::id_type const&)
+        {
+            return file();
+        }
+    };
+
+    template <typename File, typename... Files>
+    struct file_factory<File, Files...>
+    {
+        static file create(std::string const& backend,
+            naming::id_type const& locality)
+        {
+            if (backend == file_traits<File>::name())
+            {
+                return file::create<File>(locality);
+            }
+            return file_factory<Files...>::create(backend, locality);
+        }
+    };
+
+    template <typename... Files>
+    file make_file(std::string const& backend,
+        naming::id_type const& locality = hpx::find_here())
+    {
+        return file_factory<Files...>::create(backend, locality);
+    }
+
+    // the backend configured by hpxio.file.backend, local_file by default
+    inline std::string default_backend()
+    {
+        return hpx::get_config_entry("hpxio.file.backend", "local_file");
+    }
+
+}} // hpx::io
+
+#endif
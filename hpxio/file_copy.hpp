@@ -0,0 +1,75 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_FILE_COPY_HPP_JUL_15_2015_1130AM)
+#define HPX_COMPONENTS_IO_FILE_COPY_HPP_JUL_15_2015_1130AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/naming.hpp>
+#include <hpxio/copy_progress.hpp>
+
+#include <boost/cstdint.hpp>
+
+#include <sys/types.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // A server-side copy as started by copy_to or copy_from of a local_file
+    // or orangefs_file, it is executed by the component of type File the
+    // copy refers to. The data does not pass through the caller.
+    //
+    // progress() may be asked for at any time. get() returns the number of
+    // bytes copied once the copy is done, or -1, and releases the copy on
+    // the component; it has to be called exactly once.
+    template <typename File>
+    class file_copy
+    {
+      public:
+        file_copy(naming::id_type const& id,
+                lcos::future<boost::uint64_t> && handle)
+          : id_(id), handle_(handle.share())
+        {}
+
+        lcos::future<copy_progress> progress() const
+        {
+            naming::id_type const id = id_;
+            return handle_.then(
+                [id](lcos::shared_future<boost::uint64_t> h)
+                {
+                    return File(id).copy_status_sync(h.get());
+                });
+        }
+
+        copy_progress progress_sync() const
+        {
+            return progress().get();
+        }
+
+        lcos::future<ssize_t> get()
+        {
+            naming::id_type const id = id_;
+            return handle_.then(
+                [id](lcos::shared_future<boost::uint64_t> h)
+                {
+                    return File(id).copy_wait_sync(h.get());
+                });
+        }
+
+        ssize_t get_sync()
+        {
+            return get().get();
+        }
+
+      private:
+        naming::id_type id_;
+        lcos::shared_future<boost::uint64_t> handle_;
+    };
+
+}} // hpx::io
+
+#endif
@@ -0,0 +1,64 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_FILE_STATUS_HPP_JUL_09_2015_1000AM)
+#define HPX_COMPONENTS_IO_FILE_STATUS_HPP_JUL_09_2015_1000AM
+
+#include <boost/cstdint.hpp>
+#include <boost/serialization/access.hpp>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // The part of struct stat returned by the metadata operations, result
+    // is 0 if the path could be examined and -1 otherwise.
+    struct file_status
+    {
+        file_status() : result(-1), size(0), mode(0), mtime(0) {}
+
+        explicit file_status(struct stat const& st)
+          : result(0), size(st.st_size), mode(st.st_mode), mtime(st.st_mtime)
+        {}
+
+        bool exists() const
+        {
+            return result == 0;
+        }
+
+        bool is_regular() const
+        {
+            return exists() && S_ISREG(mode);
+        }
+
+        bool is_directory() const
+        {
+            return exists() && S_ISDIR(mode);
+        }
+
+        int result;
+        boost::uint64_t size;
+        boost::uint32_t mode;
+        boost::int64_t mtime;       // seconds since the epoch
+
+      private:
+        friend class boost::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned int const)
+        {
+            ar & result;
+            ar & size;
+            ar & mode;
+            ar & mtime;
+        }
+    };
+
+}} // hpx::io
+
+#endif
@@ -0,0 +1,315 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_FILE_STREAM_HPP_JUL_06_2015_1040AM)
+#define HPX_COMPONENTS_IO_FILE_STREAM_HPP_JUL_06_2015_1040AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/include/async.hpp>
+#include <hpx/include/lcos.hpp>
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Streaming access to large files through any of the hpxio file types
+    // (local_file, orangefs_file, pxfs_file, partitioned_file, mapped_file for
+    // reading). The file is transferred in chunks of chunk_size bytes using
+    // positional I/O, up to window chunk requests are outstanding at any
+    // time. This keeps the pipeline to the file full while the memory used
+    // by a stream stays bounded by chunk_size * window.
+    //
+    // A stream refers to the file object it was created for, which has to
+    // outlive it. Copies of a stream refer to the same stream, which is meant
+    // to be used by one HPX thread at a time.
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Reads count bytes starting at offset, or everything up to the end of
+    // file if count is not given. Chunks are delivered in file order.
+    template <typename File>
+    class file_reader
+    {
+      private:
+        struct state
+        {
+            state(File& f, off_t offset, std::size_t count,
+                    std::size_t chunk_size, std::size_t window)
+              : file_(f), pos_(offset), next_(offset),
+                end_(count == (std::numeric_limits<std::size_t>::max)() ?
+                    (std::numeric_limits<off_t>::max)() : offset + count),
+                chunk_size_((std::max)(chunk_size, std::size_t(1))),
+                window_((std::max)(window, std::size_t(1))), eof_(false)
+            {}
+
+            // issue chunk requests until the window is full
+            void fill()
+            {
+                while (!eof_ && next_ < end_ && pending_.size() < window_)
+                {
+                    std::size_t const count = static_cast<std::size_t>(
+                        (std::min)(off_t(chunk_size_), end_ - next_));
+
+                    pending_.push_back(std::make_pair(count,
+                        file_.pread(count, next_)));
+                    next_ += count;
+                }
+            }
+
+            File& file_;
+            off_t pos_;             // offset of the next chunk to deliver
+            off_t next_;            // offset of the next chunk to request
+            off_t end_;
+            std::size_t chunk_size_;
+            std::size_t window_;
+            bool eof_;
+
+            // requested size and data of the chunks in flight, in file order
+            std::deque<std::pair<
+                std::size_t, lcos::future<std::vector<char> > > > pending_;
+        };
+
+        typedef boost::shared_ptr<state> state_ptr;
+
+      public:
+        file_reader(File& f, off_t offset = 0,
+                std::size_t count = (std::numeric_limits<std::size_t>::max)(),
+                std::size_t chunk_size = 1024 * 1024, std::size_t window = 4)
+          : state_(boost::make_shared<state>(f, offset, count, chunk_size,
+                window))
+        {}
+
+        // The next chunk, an empty one once the stream is exhausted. The
+        // chunk ending the stream may be shorter than chunk_size. The
+        // returned future has to become ready before next() is called again.
+        lcos::future<std::vector<char> > next()
+        {
+            state_ptr s = state_;
+            s->fill();
+            if (s->pending_.empty())
+            {
+                return hpx::make_ready_future(std::vector<char>());
+            }
+
+            std::size_t const count = s->pending_.front().first;
+            lcos::future<std::vector<char> > f =
+                std::move(s->pending_.front().second);
+            s->pending_.pop_front();
+
+            // keep the window full while the consumer is busy
+            s->fill();
+
+            return f.then(
+                [s, count](lcos::future<std::vector<char> > f)
+                    -> std::vector<char>
+                {
+                    std::vector<char> chunk = f.get();
+                    s->pos_ += chunk.size();
+                    if (chunk.size() < count)
+                    {
+                        // whatever is still in flight lies behind the end
+                        // of file or an error
+                        s->eof_ = true;
+                        s->pending_.clear();
+                    }
+                    return chunk;
+                });
+        }
+
+        std::vector<char> next_sync()
+        {
+            return next().get();
+        }
+
+        // Call f(chunk, offset) for every chunk in file order, the next
+        // chunk is handed out only after f returned. The future holds the
+        // number of bytes delivered.
+        template <typename F>
+        lcos::future<std::size_t> for_each(F f)
+        {
+            file_reader r(*this);
+            off_t const offset = state_->pos_;
+            return hpx::async(
+                [r, f, offset]() mutable -> std::size_t
+                {
+                    std::size_t done = 0;
+                    for (;;)
+                    {
+                        std::vector<char> chunk = r.next_sync();
+                        if (chunk.empty())
+                        {
+                            break;
+                        }
+
+                        std::size_t const len = chunk.size();
+                        f(std::move(chunk), off_t(offset + done));
+                        done += len;
+                    }
+                    return done;
+                });
+        }
+
+        template <typename F>
+        std::size_t for_each_sync(F f)
+        {
+            return for_each(f).get();
+        }
+
+      private:
+        state_ptr state_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Writes the data handed to write() back to back starting at offset.
+    // Full chunks are written as soon as they are complete, write() suspends
+    // the calling HPX thread while window chunks are outstanding. flush()
+    // writes the remaining partial chunk.
+    template <typename File>
+    class file_writer
+    {
+      private:
+        struct chunk
+        {
+            std::vector<char> data_;
+            lcos::future<ssize_t> result_;
+        };
+
+        struct state
+        {
+            state(File& f, off_t offset, std::size_t chunk_size,
+                    std::size_t window)
+              : file_(f), next_(offset),
+                chunk_size_((std::max)(chunk_size, std::size_t(1))),
+                window_((std::max)(window, std::size_t(1))),
+                written_(0), failed_(false)
+            {}
+
+            // account for the oldest chunk in flight
+            void retire()
+            {
+                std::size_t const count = pending_.front().data_.size();
+                ssize_t const len = pending_.front().result_.get();
+                pending_.pop_front();
+
+                if (len != ssize_t(count))
+                {
+                    failed_ = true;
+                }
+                else
+                {
+                    written_ += count;
+                }
+            }
+
+            void issue()
+            {
+                while (pending_.size() >= window_)
+                {
+                    retire();
+                }
+
+                // the data stays alive until the chunk is retired, some file
+                // types write from it asynchronously
+                pending_.push_back(chunk());
+                chunk& c = pending_.back();
+                c.data_.swap(buffer_);
+                c.result_ = file_.pwrite(c.data_, next_);
+                next_ += c.data_.size();
+            }
+
+            File& file_;
+            off_t next_;            // offset of the next chunk to write
+            std::size_t chunk_size_;
+            std::size_t window_;
+
+            std::vector<char> buffer_;
+            std::size_t written_;
+            bool failed_;
+
+            // the chunks in flight, oldest first
+            std::deque<chunk> pending_;
+        };
+
+        typedef boost::shared_ptr<state> state_ptr;
+
+      public:
+        file_writer(File& f, off_t offset = 0,
+                std::size_t chunk_size = 1024 * 1024, std::size_t window = 4)
+          : state_(boost::make_shared<state>(f, offset, chunk_size, window))
+        {}
+
+        // copies the data, returns false once any earlier chunk has failed
+        bool write(char const* data, std::size_t count)
+        {
+            state& s = *state_;
+            while (count != 0 && !s.failed_)
+            {
+                if (s.buffer_.empty())
+                {
+                    s.buffer_.reserve(s.chunk_size_);
+                }
+
+                std::size_t const len =
+                    (std::min)(count, s.chunk_size_ - s.buffer_.size());
+                s.buffer_.insert(s.buffer_.end(), data, data + len);
+                data += len;
+                count -= len;
+
+                if (s.buffer_.size() == s.chunk_size_)
+                {
+                    s.issue();
+                }
+            }
+            return !s.failed_;
+        }
+
+        bool write(std::vector<char> const& data)
+        {
+            return write(data.data(), data.size());
+        }
+
+        // Write the buffered data and wait for all chunks in flight. The
+        // future holds the number of bytes written so far, or -1 if any
+        // chunk could not be written completely.
+        lcos::future<ssize_t> flush()
+        {
+            state_ptr s = state_;
+            return hpx::async(
+                [s]() -> ssize_t
+                {
+                    if (!s->buffer_.empty() && !s->failed_)
+                    {
+                        s->issue();
+                    }
+                    while (!s->pending_.empty())
+                    {
+                        s->retire();
+                    }
+                    return s->failed_ ? -1 : ssize_t(s->written_);
+                });
+        }
+
+        ssize_t flush_sync()
+        {
+            return flush().get();
+        }
+
+      private:
+        state_ptr state_;
+    };
+
+}} // hpx::io
+
+#endif
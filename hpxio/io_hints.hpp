@@ -0,0 +1,57 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_IO_HINTS_HPP_JUL_16_2015_0900AM)
+#define HPX_COMPONENTS_IO_IO_HINTS_HPP_JUL_16_2015_0900AM
+
+#include <boost/cstdint.hpp>
+#include <boost/serialization/access.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // The priority classes of the io_scheduler, a class is served only if
+    // all classes above it have nothing waiting (or a deadline is due).
+    enum io_priority
+    {
+        io_priority_interactive = 0,
+        io_priority_normal = 1,
+        io_priority_background = 2,
+        io_priority_count = 3
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Scheduling hints passed along with read, pread, write and pwrite.
+    // Requests of different clients of the same priority class are served
+    // round robin, client is any number identifying a tenant, e.g. a job or
+    // user id. deadline is the time in microseconds after which the request
+    // should have been started, 0 means the default of its class.
+    struct io_hints
+    {
+        io_hints(io_priority p = io_priority_normal,
+                boost::uint64_t c = 0, boost::uint64_t d = 0)
+          : priority(p), client(c), deadline(d)
+        {}
+
+        boost::uint32_t priority;
+        boost::uint64_t client;
+        boost::uint64_t deadline;
+
+      private:
+        friend class boost::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned int const)
+        {
+            ar & priority;
+            ar & client;
+            ar & deadline;
+        }
+    };
+
+}} // hpx::io
+
+#endif
@@ -9,8 +9,14 @@
 
 #include <hpx/hpx_fwd.hpp>
 #include <hpx/include/client.hpp>
+#include <hpx/runtime/get_ptr.hpp>
+#include <hpxio/file_copy.hpp>
+#include <hpxio/io_hints.hpp>
 #include <hpxio/server/local_file.hpp>
 
+#include <cstring>
+#include <utility>
+
 ///////////////////////////////////////////////////////////////////////////////
 namespace hpx { namespace io
 {
@@ -25,6 +31,8 @@ namespace hpx { namespace io
             base_type;
 
     public:
+        typedef server::local_file::buffer_type buffer_type;
+
         local_file(naming::id_type gid) : base_type(gid) {}
 
         local_file(hpx::future<naming::id_type> && gid)
@@ -54,13 +62,14 @@ namespace hpx { namespace io
             return is_open().get();
         }
 
-        lcos::future<void> close()
+        // returns -1 if staged data could not be written out
+        lcos::future<int> close()
         {
             typedef server::local_file::close_action action_type;
             return hpx::async<action_type>(this->base_type::get_gid());
         }
 
-        void close_sync()
+        int close_sync()
         {
             return close().get();
         }
@@ -77,66 +86,590 @@ namespace hpx { namespace io
             return remove_file(file_name).get();
         }
 
-        lcos::future<std::vector<char> > read(size_t const& count)
+        // The reads and writes (vectored ones included), flush and lseek
+        // take io_hints, the priority class, client and deadline the
+        // io_scheduler of the component admits their work to the io_pool
+        // with.
+        //
+        // The vector based reads hand over the result of the component
+        // directly if it is local. Otherwise the data is received as a
+        // zero-copy buffer and copied into the vector once, use the
+        // *_buffer functions to avoid this copy.
+        lcos::future<std::vector<char> > read(size_t const count,
+                io_hints const& hints = io_hints())
         {
-            typedef server::local_file::read_action action_type;
-            return hpx::async<action_type>(this->base_type::get_gid(),
-                    count);
+            naming::id_type const gid = this->base_type::get_gid();
+            if (naming::get_locality_from_id(gid) == hpx::find_here())
+            {
+                return hpx::get_ptr<server::local_file>(gid).then(
+                    [=](lcos::future<boost::shared_ptr<server::local_file> > f)
+                    {
+                        return f.get()->read(count, hints);
+                    });
+            }
+            return read_buffer(count, hints).then(
+                [](lcos::future<buffer_type> f)
+                {
+                    return server::to_vector(f.get());
+                });
         }
 
-        std::vector<char> read_sync(size_t const count)
+        std::vector<char> read_sync(size_t const count,
+                io_hints const& hints = io_hints())
         {
-            return read(count).get();
+            return read(count, hints).get();
         }
 
         lcos::future<std::vector<char> > pread(ssize_t const count,
-                off_t const offset)
+                off_t const offset, io_hints const& hints = io_hints())
+        {
+            naming::id_type const gid = this->base_type::get_gid();
+            if (naming::get_locality_from_id(gid) == hpx::find_here())
+            {
+                return hpx::get_ptr<server::local_file>(gid).then(
+                    [=](lcos::future<boost::shared_ptr<server::local_file> > f)
+                    {
+                        return f.get()->pread(count, offset, hints);
+                    });
+            }
+            return pread_buffer(count, offset, hints).then(
+                [](lcos::future<buffer_type> f)
+                {
+                    return server::to_vector(f.get());
+                });
+        }
+
+        std::vector<char> pread_sync(size_t const count, off_t const offset,
+                io_hints const& hints = io_hints())
+        {
+            return pread(count, offset, hints).get();
+        }
+
+        lcos::future<buffer_type> read_buffer(size_t const count,
+                io_hints const& hints = io_hints())
         {
-            typedef server::local_file::pread_action action_type;
+            typedef server::local_file::read_buffer_action action_type;
             return hpx::async<action_type>(this->base_type::get_gid(),
-                    count, offset);
+                    count, hints);
+        }
+
+        buffer_type read_buffer_sync(size_t const count,
+                io_hints const& hints = io_hints())
+        {
+            return read_buffer(count, hints).get();
+        }
+
+        lcos::future<buffer_type> pread_buffer(size_t const count,
+                off_t const offset, io_hints const& hints = io_hints())
+        {
+            typedef server::local_file::pread_buffer_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    count, offset, hints);
+        }
+
+        buffer_type pread_buffer_sync(size_t const count,
+                off_t const offset, io_hints const& hints = io_hints())
+        {
+            return pread_buffer(count, offset, hints).get();
+        }
+
+        // Read into memory owned by the caller, which has to stay valid until
+        // the returned future becomes ready. If the component is local the
+        // data is read straight into buf, otherwise it is copied from the
+        // received buffer exactly once.
+        lcos::future<ssize_t> read(char* buf, size_t const count,
+                io_hints const& hints = io_hints())
+        {
+            naming::id_type const gid = this->base_type::get_gid();
+            if (naming::get_locality_from_id(gid) == hpx::find_here())
+            {
+                return hpx::get_ptr<server::local_file>(gid).then(
+                    [=](lcos::future<boost::shared_ptr<server::local_file> > f)
+                    {
+                        return f.get()->read_into(buf, count, hints);
+                    });
+            }
+            return read_buffer(count, hints).then(
+                [buf](lcos::future<buffer_type> f) -> ssize_t
+                {
+                    buffer_type data = f.get();
+                    std::memcpy(buf, data.data(), data.size());
+                    return data.size();
+                });
+        }
+
+        ssize_t read_sync(char* buf, size_t const count,
+                io_hints const& hints = io_hints())
+        {
+            return read(buf, count, hints).get();
+        }
+
+        lcos::future<ssize_t> pread(char* buf, size_t const count,
+                off_t const offset, io_hints const& hints = io_hints())
+        {
+            naming::id_type const gid = this->base_type::get_gid();
+            if (naming::get_locality_from_id(gid) == hpx::find_here())
+            {
+                return hpx::get_ptr<server::local_file>(gid).then(
+                    [=](lcos::future<boost::shared_ptr<server::local_file> > f)
+                    {
+                        return f.get()->pread_into(buf, count, offset, hints);
+                    });
+            }
+            return pread_buffer(count, offset, hints).then(
+                [buf](lcos::future<buffer_type> f) -> ssize_t
+                {
+                    buffer_type data = f.get();
+                    std::memcpy(buf, data.data(), data.size());
+                    return data.size();
+                });
         }
 
-        std::vector<char> pread_sync(size_t const count, off_t const offset)
+        ssize_t pread_sync(char* buf, size_t const count,
+                off_t const offset, io_hints const& hints = io_hints())
         {
-            return pread(count, offset).get();
+            return pread(buf, count, offset, hints).get();
         }
 
-        lcos::future<ssize_t> write(std::vector<char> const& buf)
+        // The data is sent as a zero-copy buffer. A vector passed as an
+        // rvalue is handed over as is, otherwise it is copied once.
+        lcos::future<ssize_t> write(buffer_type const& buf,
+                io_hints const& hints = io_hints())
         {
             typedef server::local_file::write_action action_type;
             return hpx::async<action_type>(this->base_type::get_gid(),
-                    buf);
+                    buf, hints);
         }
 
-        ssize_t write_sync(std::vector<char> const& buf)
+        lcos::future<ssize_t> write(std::vector<char> const& buf,
+                io_hints const& hints = io_hints())
         {
-            return write(buf).get();
+            return write(server::to_buffer(buf), hints);
         }
 
-        lcos::future<ssize_t> pwrite(std::vector<char> const& buf,
-                off_t const offset)
+        lcos::future<ssize_t> write(std::vector<char>&& buf,
+                io_hints const& hints = io_hints())
+        {
+            return write(server::to_buffer(std::move(buf)), hints);
+        }
+
+        ssize_t write_sync(buffer_type const& buf,
+                io_hints const& hints = io_hints())
+        {
+            return write(buf, hints).get();
+        }
+
+        ssize_t write_sync(std::vector<char> const& buf,
+                io_hints const& hints = io_hints())
+        {
+            return write(buf, hints).get();
+        }
+
+        lcos::future<ssize_t> pwrite(buffer_type const& buf,
+                off_t const offset, io_hints const& hints = io_hints())
         {
             typedef server::local_file::pwrite_action action_type;
             return hpx::async<action_type>(this->base_type::get_gid(),
-                    buf, offset);
+                    buf, offset, hints);
+        }
+
+        lcos::future<ssize_t> pwrite(std::vector<char> const& buf,
+                off_t const offset, io_hints const& hints = io_hints())
+        {
+            return pwrite(server::to_buffer(buf), offset, hints);
+        }
+
+        lcos::future<ssize_t> pwrite(std::vector<char>&& buf,
+                off_t const offset, io_hints const& hints = io_hints())
+        {
+            return pwrite(server::to_buffer(std::move(buf)), offset,
+                hints);
+        }
+
+        ssize_t pwrite_sync(buffer_type const& buf, off_t const offset,
+                io_hints const& hints = io_hints())
+        {
+            return pwrite(buf, offset, hints).get();
+        }
+
+        ssize_t pwrite_sync(std::vector<char> const& buf, off_t const offset,
+                io_hints const& hints = io_hints())
+        {
+            return pwrite(buf, offset, hints).get();
+        }
+
+        lcos::future<std::vector<char> > preadv(
+                std::vector<extent> const& extents,
+                io_hints const& hints = io_hints())
+        {
+            naming::id_type const gid = this->base_type::get_gid();
+            if (naming::get_locality_from_id(gid) == hpx::find_here())
+            {
+                return hpx::get_ptr<server::local_file>(gid).then(
+                    [=](lcos::future<boost::shared_ptr<server::local_file> > f)
+                    {
+                        return f.get()->preadv(extents, hints);
+                    });
+            }
+            return preadv_buffer(extents, hints).then(
+                [](lcos::future<buffer_type> f)
+                {
+                    return server::to_vector(f.get());
+                });
+        }
+
+        std::vector<char> preadv_sync(std::vector<extent> const& extents,
+                io_hints const& hints = io_hints())
+        {
+            return preadv(extents, hints).get();
+        }
+
+        lcos::future<buffer_type> preadv_buffer(
+                std::vector<extent> const& extents,
+                io_hints const& hints = io_hints())
+        {
+            typedef server::local_file::preadv_buffer_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    extents, hints);
+        }
+
+        buffer_type preadv_buffer_sync(std::vector<extent> const& extents,
+                io_hints const& hints = io_hints())
+        {
+            return preadv_buffer(extents, hints).get();
+        }
+
+        lcos::future<ssize_t> pwritev(std::vector<extent> const& extents,
+                buffer_type const& buf, io_hints const& hints = io_hints())
+        {
+            typedef server::local_file::pwritev_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    extents, buf, hints);
+        }
+
+        lcos::future<ssize_t> pwritev(std::vector<extent> const& extents,
+                std::vector<char> const& buf,
+                io_hints const& hints = io_hints())
+        {
+            return pwritev(extents, server::to_buffer(buf), hints);
+        }
+
+        lcos::future<ssize_t> pwritev(std::vector<extent> const& extents,
+                std::vector<char>&& buf, io_hints const& hints = io_hints())
+        {
+            return pwritev(extents, server::to_buffer(std::move(buf)),
+                hints);
+        }
+
+        ssize_t pwritev_sync(std::vector<extent> const& extents,
+                buffer_type const& buf, io_hints const& hints = io_hints())
+        {
+            return pwritev(extents, buf, hints).get();
+        }
+
+        ssize_t pwritev_sync(std::vector<extent> const& extents,
+                std::vector<char> const& buf,
+                io_hints const& hints = io_hints())
+        {
+            return pwritev(extents, buf, hints).get();
+        }
+
+        // the staged data is written with the given hints
+        lcos::future<int> flush(io_hints const& hints = io_hints())
+        {
+            typedef server::local_file::flush_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    hints);
+        }
+
+        int flush_sync(io_hints const& hints = io_hints())
+        {
+            return flush(hints).get();
+        }
+
+        // flushes staged data first, the future returns 0 once the file
+        // reached stable storage
+        lcos::future<int> fsync()
+        {
+            typedef server::local_file::fsync_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid());
         }
 
-        ssize_t pwrite_sync(std::vector<char> const& buf, off_t const offset)
+        int fsync_sync()
         {
-            return pwrite(buf, offset).get();
+            return fsync().get();
+        }
+
+        lcos::future<int> fdatasync()
+        {
+            typedef server::local_file::fdatasync_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid());
         }
 
-        lcos::future<int> lseek(off_t const offset, int const whence)
+        int fdatasync_sync()
+        {
+            return fdatasync().get();
+        }
+
+        // Contribute to round number round of a collective operation with
+        // participants contributors in total, the component acts as the
+        // aggregator. Use collective_file rather than calling these directly.
+        lcos::future<ssize_t> collective_write(boost::uint64_t const round,
+                size_t const participants, std::vector<extent> const& extents,
+                buffer_type const& buf)
+        {
+            typedef server::local_file::collective_write_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    round, participants, extents, buf);
+        }
+
+        lcos::future<buffer_type> collective_read(
+                boost::uint64_t const round, size_t const participants,
+                std::vector<extent> const& extents)
+        {
+            typedef server::local_file::collective_read_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    round, participants, extents);
+        }
+
+        // returns 0 on success and -1 otherwise
+        lcos::future<int> lseek(off_t const offset, int const whence,
+                io_hints const& hints = io_hints())
         {
             typedef server::local_file::lseek_action action_type;
             return hpx::async<action_type>(this->base_type::get_gid(),
-                    offset, whence);
+                    offset, whence, hints);
+        }
+
+        int lseek_sync(off_t const offset, int const whence,
+                io_hints const& hints = io_hints())
+        {
+            return lseek(offset, whence, hints).get();
+        }
+
+        // returns the resulting offset or -1
+        lcos::future<off_t> seek(off_t const offset, int const whence,
+                io_hints const& hints = io_hints())
+        {
+            typedef server::local_file::seek_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    offset, whence, hints);
+        }
+
+        off_t seek_sync(off_t const offset, int const whence,
+                io_hints const& hints = io_hints())
+        {
+            return seek(offset, whence, hints).get();
+        }
+
+        // Batched metadata operations, one action for a whole list of paths.
+        // The paths are handled on the component's locality, in parallel.
+
+        // open each path in a new local_file component on the locality of this
+        // one, paths which could not be opened get an invalid id
+        lcos::future<std::vector<naming::id_type> > open_many(
+                std::vector<std::string> const& names,
+                std::string const& mode)
+        {
+            typedef server::local_file::open_many_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    names, mode);
+        }
+
+        std::vector<naming::id_type> open_many_sync(
+                std::vector<std::string> const& names,
+                std::string const& mode)
+        {
+            return open_many(names, mode).get();
+        }
+
+        lcos::future<std::vector<file_status> > stat_many(
+                std::vector<std::string> const& paths)
+        {
+            typedef server::local_file::stat_many_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    paths);
+        }
+
+        std::vector<file_status> stat_many_sync(
+                std::vector<std::string> const& paths)
+        {
+            return stat_many(paths).get();
+        }
+
+        // 0 for each path removed, -1 otherwise
+        lcos::future<std::vector<int> > unlink_many(
+                std::vector<std::string> const& paths)
+        {
+            typedef server::local_file::unlink_many_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    paths);
+        }
+
+        std::vector<int> unlink_many_sync(
+                std::vector<std::string> const& paths)
+        {
+            return unlink_many(paths).get();
+        }
+
+        // create empty files, 0 for each file created, -1 otherwise
+        lcos::future<std::vector<int> > create_many(
+                std::vector<std::string> const& paths)
+        {
+            typedef server::local_file::create_many_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    paths);
+        }
+
+        std::vector<int> create_many_sync(
+                std::vector<std::string> const& paths)
+        {
+            return create_many(paths).get();
+        }
+
+        // Metadata operations on arbitrary paths, executed on the
+        // component's locality. The int results are 0 on success, -1
+        // otherwise.
+        lcos::future<file_status> stat(std::string const& path)
+        {
+            typedef server::local_file::stat_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    path);
+        }
+
+        file_status stat_sync(std::string const& path)
+        {
+            return stat(path).get();
+        }
+
+        lcos::future<int> mkdir(std::string const& path, int const mode = 0755)
+        {
+            typedef server::local_file::mkdir_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    path, mode);
+        }
+
+        int mkdir_sync(std::string const& path, int const mode = 0755)
+        {
+            return mkdir(path, mode).get();
+        }
+
+        lcos::future<int> rmdir(std::string const& path)
+        {
+            typedef server::local_file::rmdir_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    path);
+        }
+
+        int rmdir_sync(std::string const& path)
+        {
+            return rmdir(path).get();
+        }
+
+        lcos::future<int> rename(std::string const& from,
+                std::string const& to)
+        {
+            typedef server::local_file::rename_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    from, to);
+        }
+
+        int rename_sync(std::string const& from, std::string const& to)
+        {
+            return rename(from, to).get();
+        }
+
+        lcos::future<int> truncate(std::string const& path,
+                off_t const length)
+        {
+            typedef server::local_file::truncate_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    path, length);
+        }
+
+        int truncate_sync(std::string const& path, off_t const length)
+        {
+            return truncate(path, length).get();
+        }
+
+        // Streamed directory listings, see directory_reader for a
+        // convenient interface. opendir returns 0 on failure, readdir an
+        // empty batch at the end of the directory.
+        lcos::future<boost::uint64_t> opendir(std::string const& path)
+        {
+            typedef server::local_file::opendir_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    path);
+        }
+
+        boost::uint64_t opendir_sync(std::string const& path)
+        {
+            return opendir(path).get();
+        }
+
+        lcos::future<std::vector<directory_entry> > readdir(
+                boost::uint64_t const handle, size_t const count)
+        {
+            typedef server::local_file::readdir_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    handle, count);
+        }
+
+        std::vector<directory_entry> readdir_sync(
+                boost::uint64_t const handle, size_t const count)
+        {
+            return readdir(handle, count).get();
+        }
+
+        lcos::future<int> closedir(boost::uint64_t const handle)
+        {
+            typedef server::local_file::closedir_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    handle);
+        }
+
+        int closedir_sync(boost::uint64_t const handle)
+        {
+            return closedir(handle).get();
+        }
+
+        // Copy count bytes from src_offset of this file to dst_offset of
+        // dest. The copy runs on this file's locality and moves the data
+        // straight between the components, inside the kernel if both are on
+        // the same locality. copy_status and copy_wait are used by the
+        // returned file_copy.
+        file_copy<local_file> copy_to(local_file const& dest,
+                off_t const src_offset, off_t const dst_offset,
+                boost::uint64_t const count)
+        {
+            typedef server::local_file::copy_to_action action_type;
+            naming::id_type const gid = this->base_type::get_gid();
+            return file_copy<local_file>(gid, hpx::async<action_type>(gid,
+                    gid, dest.get_gid(), src_offset, dst_offset, count));
+        }
+
+        lcos::future<copy_progress> copy_status(boost::uint64_t const handle)
+        {
+            typedef server::local_file::copy_status_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    handle);
+        }
+
+        copy_progress copy_status_sync(boost::uint64_t const handle)
+        {
+            return copy_status(handle).get();
+        }
+
+        lcos::future<ssize_t> copy_wait(boost::uint64_t const handle)
+        {
+            typedef server::local_file::copy_wait_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    handle);
         }
 
-        int lseek_sync(off_t const offset, int const whence)
+        ssize_t copy_wait_sync(boost::uint64_t const handle)
         {
-            return lseek(offset, whence).get();
+            return copy_wait(handle).get();
         }
     };
 
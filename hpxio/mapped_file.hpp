@@ -0,0 +1,207 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_MAPPED_FILE_HPP_JUL_01_2015_1140AM)
+#define HPX_COMPONENTS_IO_MAPPED_FILE_HPP_JUL_01_2015_1140AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/include/client.hpp>
+#include <hpx/runtime/get_ptr.hpp>
+#include <hpxio/server/mapped_file.hpp>
+#include <hpxio/server/vector_buffer.hpp>
+
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // A read-only view into a file mapping, it keeps the mapping alive.
+    class mapped_span
+    {
+      public:
+        mapped_span() : data_(0), size_(0) {}
+
+        mapped_span(server::file_mapping_ptr const& mapping,
+                char const* data, size_t size)
+          : mapping_(mapping), data_(data), size_(size)
+        {}
+
+        char const* data() const
+        {
+            return data_;
+        }
+
+        size_t size() const
+        {
+            return size_;
+        }
+
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        char const* begin() const
+        {
+            return data_;
+        }
+
+        char const* end() const
+        {
+            return data_ + size_;
+        }
+
+      private:
+        server::file_mapping_ptr mapping_;
+        char const* data_;
+        size_t size_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // The \a mapped_file class is the client side representation of a
+    // concrete \a server#mapped_file component
+    class mapped_file :
+        public components::client_base<mapped_file, server::mapped_file>
+    {
+    private:
+        typedef components::client_base<mapped_file, server::mapped_file>
+            base_type;
+
+    public:
+        typedef server::mapped_file::buffer_type buffer_type;
+
+        mapped_file(naming::id_type gid) : base_type(gid) {}
+
+        mapped_file(hpx::future<naming::id_type> && gid)
+          : base_type(std::move(gid))
+        {}
+
+        lcos::future<void> open(std::string const& name, std::string const& mode)
+        {
+            typedef server::mapped_file::open_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    name, mode);
+        }
+
+        void open_sync(std::string const& name, std::string const& mode)
+        {
+            return open(name, mode).get();
+        }
+
+        lcos::future<bool> is_open()
+        {
+            typedef server::mapped_file::is_open_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid());
+        }
+
+        bool is_open_sync()
+        {
+            return is_open().get();
+        }
+
+        lcos::future<void> close()
+        {
+            typedef server::mapped_file::close_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid());
+        }
+
+        void close_sync()
+        {
+            return close().get();
+        }
+
+        lcos::future<size_t> size()
+        {
+            typedef server::mapped_file::size_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid());
+        }
+
+        size_t size_sync()
+        {
+            return size().get();
+        }
+
+        // copies the data, this works for remote components as well
+        lcos::future<std::vector<char> > pread(size_t const count,
+                off_t const offset)
+        {
+            naming::id_type const gid = this->base_type::get_gid();
+            if (naming::get_locality_from_id(gid) == hpx::find_here())
+            {
+                return hpx::get_ptr<server::mapped_file>(gid).then(
+                    [=](lcos::future<boost::shared_ptr<server::mapped_file> > f)
+                    {
+                        return f.get()->pread(count, offset);
+                    });
+            }
+            return pread_buffer(count, offset).then(
+                [](lcos::future<buffer_type> f)
+                {
+                    return server::to_vector(f.get());
+                });
+        }
+
+        std::vector<char> pread_sync(size_t const count, off_t const offset)
+        {
+            return pread(count, offset).get();
+        }
+
+        // the data arrives as a zero-copy buffer
+        lcos::future<buffer_type> pread_buffer(size_t const count,
+                off_t const offset)
+        {
+            typedef server::mapped_file::pread_buffer_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    count, offset);
+        }
+
+        buffer_type pread_buffer_sync(size_t const count, off_t const offset)
+        {
+            return pread_buffer(count, offset).get();
+        }
+
+        // the future becomes ready once the range is resident in memory
+        lcos::future<int> prefetch(off_t const offset, size_t const count)
+        {
+            typedef server::mapped_file::prefetch_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    offset, count);
+        }
+
+        int prefetch_sync(off_t const offset, size_t const count)
+        {
+            return prefetch(offset, count).get();
+        }
+
+        // Direct access to the mapping, only possible if the component is
+        // local. The span is cut to the end of the file and is empty if the
+        // component is remote, not open or offset is out of range. Touching
+        // pages which are not resident faults them in on the calling thread,
+        // use prefetch() first for cold data.
+        mapped_span span(off_t const offset, size_t const count)
+        {
+            naming::id_type const gid = this->base_type::get_gid();
+            if (offset < 0 ||
+                naming::get_locality_from_id(gid) != hpx::find_here())
+            {
+                return mapped_span();
+            }
+
+            server::file_mapping_ptr m =
+                hpx::get_ptr<server::mapped_file>(gid).get()->get_mapping();
+            if (!m || size_t(offset) >= m->size())
+            {
+                return mapped_span();
+            }
+
+            return mapped_span(m, m->data() + offset,
+                (std::min)(count, size_t(m->size() - offset)));
+        }
+    };
+
+}} // hpx::io
+
+#endif
@@ -0,0 +1,59 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_OPEN_MODE_HPP_JUL_08_2015_0910AM)
+#define HPX_COMPONENTS_IO_OPEN_MODE_HPP_JUL_08_2015_0910AM
+
+#include <string>
+
+#include <fcntl.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Translate a fopen() style mode string into open() flags, returns -1 for
+    // an invalid mode. Besides "r", "w", "a" and '+' the mode may contain
+    // 'x' (O_EXCL) and 'd' (O_DIRECT, where supported).
+    inline int mode_to_flags(std::string const& mode)
+    {
+        if (mode.empty())
+        {
+            return -1;
+        }
+
+        bool const plus = mode.find('+') != std::string::npos;
+        int flags = 0;
+        switch (mode[0])
+        {
+        case 'r':
+            flags = plus ? O_RDWR : O_RDONLY;
+            break;
+        case 'w':
+            flags = (plus ? O_RDWR : O_WRONLY) | O_CREAT | O_TRUNC;
+            break;
+        case 'a':
+            flags = (plus ? O_RDWR : O_WRONLY) | O_CREAT | O_APPEND;
+            break;
+        default:
+            return -1;
+        }
+
+        if (mode.find('x') != std::string::npos)
+        {
+            flags |= O_EXCL;
+        }
+#if defined(O_DIRECT)
+        if (mode.find('d') != std::string::npos)
+        {
+            flags |= O_DIRECT;
+        }
+#endif
+        return flags;
+    }
+
+}} // hpx::io
+
+#endif
@@ -9,8 +9,14 @@
 
 #include <hpx/hpx_fwd.hpp>
 #include <hpx/include/client.hpp>
+#include <hpxio/file_copy.hpp>
+#include <hpxio/io_hints.hpp>
+#include <hpxio/local_file.hpp>
 #include <hpxio/server/orangefs_file.hpp>
 
+#include <cstring>
+#include <utility>
+
 ///////////////////////////////////////////////////////////////////////////////
 namespace hpx { namespace io
 {
@@ -26,6 +32,8 @@ namespace hpx { namespace io
             base_type;
 
     public:
+        typedef server::orangefs_file::buffer_type buffer_type;
+
         orangefs_file(naming::id_type gid) : base_type(gid) {}
 
         orangefs_file(hpx::future<naming::id_type> && gid)
@@ -55,13 +63,14 @@ namespace hpx { namespace io
             return is_open().get();
         }
 
-        lcos::future<void> close()
+        // returns -1 if staged data could not be written out
+        lcos::future<int> close()
         {
             typedef server::orangefs_file::close_action action_type;
             return hpx::async<action_type>(this->base_type::get_gid());
         }
 
-        void close_sync()
+        int close_sync()
         {
             return close().get();
         }
@@ -78,66 +87,554 @@ namespace hpx { namespace io
             return remove_file(file_name).get();
         }
 
-        lcos::future<std::vector<char> > read(size_t const count)
+        // The reads and writes (vectored ones included), flush and lseek
+        // take io_hints, the priority class, client and deadline the
+        // io_scheduler of the component admits their work to the io_pool
+        // with.
+        //
+        // The vector based reads receive the data as a zero-copy buffer and
+        // copy it into the vector once, use the *_buffer functions to avoid
+        // this copy. All requests go through the actions, even to a local
+        // component, as its locking_hook serializes them with open, close
+        // and lseek.
+        lcos::future<std::vector<char> > read(size_t const count,
+                io_hints const& hints = io_hints())
         {
-            typedef server::orangefs_file::read_action action_type;
-            return hpx::async<action_type>(this->base_type::get_gid(),
-                    count);
+            return read_buffer(count, hints).then(
+                [](lcos::future<buffer_type> f)
+                {
+                    return server::to_vector(f.get());
+                });
         }
 
-        std::vector<char> read_sync(size_t const count)
+        std::vector<char> read_sync(size_t const count,
+                io_hints const& hints = io_hints())
         {
-            return read(count).get();
+            return read(count, hints).get();
         }
 
         lcos::future<std::vector<char> > pread(ssize_t const count,
-                off_t const offset)
+                off_t const offset, io_hints const& hints = io_hints())
+        {
+            return pread_buffer(count, offset, hints).then(
+                [](lcos::future<buffer_type> f)
+                {
+                    return server::to_vector(f.get());
+                });
+        }
+
+        std::vector<char> pread_sync(size_t const count, off_t const offset,
+                io_hints const& hints = io_hints())
+        {
+            return pread(count, offset, hints).get();
+        }
+
+        lcos::future<buffer_type> read_buffer(size_t const count,
+                io_hints const& hints = io_hints())
         {
-            typedef server::orangefs_file::pread_action action_type;
+            typedef server::orangefs_file::read_buffer_action action_type;
             return hpx::async<action_type>(this->base_type::get_gid(),
-                    count, offset);
+                    count, hints);
+        }
+
+        buffer_type read_buffer_sync(size_t const count,
+                io_hints const& hints = io_hints())
+        {
+            return read_buffer(count, hints).get();
+        }
+
+        lcos::future<buffer_type> pread_buffer(size_t const count,
+                off_t const offset, io_hints const& hints = io_hints())
+        {
+            typedef server::orangefs_file::pread_buffer_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    count, offset, hints);
+        }
+
+        buffer_type pread_buffer_sync(size_t const count,
+                off_t const offset, io_hints const& hints = io_hints())
+        {
+            return pread_buffer(count, offset, hints).get();
+        }
+
+        // Read into memory owned by the caller, which has to stay valid until
+        // the returned future becomes ready. The data is copied from the
+        // received buffer exactly once. The requests always go through the
+        // actions, the locking_hook of the component serializes them with
+        // open, close and lseek.
+        lcos::future<ssize_t> read(char* buf, size_t const count,
+                io_hints const& hints = io_hints())
+        {
+            return read_buffer(count, hints).then(
+                [buf](lcos::future<buffer_type> f) -> ssize_t
+                {
+                    buffer_type data = f.get();
+                    std::memcpy(buf, data.data(), data.size());
+                    return data.size();
+                });
+        }
+
+        ssize_t read_sync(char* buf, size_t const count,
+                io_hints const& hints = io_hints())
+        {
+            return read(buf, count, hints).get();
+        }
+
+        lcos::future<ssize_t> pread(char* buf, size_t const count,
+                off_t const offset, io_hints const& hints = io_hints())
+        {
+            return pread_buffer(count, offset, hints).then(
+                [buf](lcos::future<buffer_type> f) -> ssize_t
+                {
+                    buffer_type data = f.get();
+                    std::memcpy(buf, data.data(), data.size());
+                    return data.size();
+                });
         }
 
-        std::vector<char> pread_sync(size_t const count, off_t const offset)
+        ssize_t pread_sync(char* buf, size_t const count,
+                off_t const offset, io_hints const& hints = io_hints())
         {
-            return pread(count, offset).get();
+            return pread(buf, count, offset, hints).get();
         }
 
-        lcos::future<ssize_t> write(std::vector<char> const& buf)
+        // The data is sent as a zero-copy buffer. A vector passed as an
+        // rvalue is handed over as is, otherwise it is copied once.
+        lcos::future<ssize_t> write(buffer_type const& buf,
+                io_hints const& hints = io_hints())
         {
             typedef server::orangefs_file::write_action action_type;
             return hpx::async<action_type>(this->base_type::get_gid(),
-                    buf);
+                    buf, hints);
         }
 
-        ssize_t write_sync(std::vector<char> const& buf)
+        lcos::future<ssize_t> write(std::vector<char> const& buf,
+                io_hints const& hints = io_hints())
         {
-            return write(buf).get();
+            return write(server::to_buffer(buf), hints);
         }
 
-        lcos::future<ssize_t> pwrite(std::vector<char> const& buf,
-                off_t const offset)
+        lcos::future<ssize_t> write(std::vector<char>&& buf,
+                io_hints const& hints = io_hints())
+        {
+            return write(server::to_buffer(std::move(buf)), hints);
+        }
+
+        ssize_t write_sync(buffer_type const& buf,
+                io_hints const& hints = io_hints())
+        {
+            return write(buf, hints).get();
+        }
+
+        ssize_t write_sync(std::vector<char> const& buf,
+                io_hints const& hints = io_hints())
+        {
+            return write(buf, hints).get();
+        }
+
+        lcos::future<ssize_t> pwrite(buffer_type const& buf,
+                off_t const offset, io_hints const& hints = io_hints())
         {
             typedef server::orangefs_file::pwrite_action action_type;
             return hpx::async<action_type>(this->base_type::get_gid(),
-                    buf, offset);
+                    buf, offset, hints);
+        }
+
+        lcos::future<ssize_t> pwrite(std::vector<char> const& buf,
+                off_t const offset, io_hints const& hints = io_hints())
+        {
+            return pwrite(server::to_buffer(buf), offset, hints);
+        }
+
+        lcos::future<ssize_t> pwrite(std::vector<char>&& buf,
+                off_t const offset, io_hints const& hints = io_hints())
+        {
+            return pwrite(server::to_buffer(std::move(buf)), offset,
+                hints);
+        }
+
+        ssize_t pwrite_sync(buffer_type const& buf, off_t const offset,
+                io_hints const& hints = io_hints())
+        {
+            return pwrite(buf, offset, hints).get();
+        }
+
+        ssize_t pwrite_sync(std::vector<char> const& buf, off_t const offset,
+                io_hints const& hints = io_hints())
+        {
+            return pwrite(buf, offset, hints).get();
+        }
+
+        lcos::future<std::vector<char> > preadv(
+                std::vector<extent> const& extents,
+                io_hints const& hints = io_hints())
+        {
+            return preadv_buffer(extents, hints).then(
+                [](lcos::future<buffer_type> f)
+                {
+                    return server::to_vector(f.get());
+                });
         }
 
-        ssize_t pwrite_sync(std::vector<char> const& buf, off_t const offset)
+        std::vector<char> preadv_sync(std::vector<extent> const& extents,
+                io_hints const& hints = io_hints())
         {
-            return pwrite(buf, offset).get();
+            return preadv(extents, hints).get();
         }
 
-        lcos::future<off_t> lseek(off_t const offset, int const whence)
+        lcos::future<buffer_type> preadv_buffer(
+                std::vector<extent> const& extents,
+                io_hints const& hints = io_hints())
+        {
+            typedef server::orangefs_file::preadv_buffer_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    extents, hints);
+        }
+
+        buffer_type preadv_buffer_sync(std::vector<extent> const& extents,
+                io_hints const& hints = io_hints())
+        {
+            return preadv_buffer(extents, hints).get();
+        }
+
+        lcos::future<ssize_t> pwritev(std::vector<extent> const& extents,
+                buffer_type const& buf, io_hints const& hints = io_hints())
+        {
+            typedef server::orangefs_file::pwritev_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    extents, buf, hints);
+        }
+
+        lcos::future<ssize_t> pwritev(std::vector<extent> const& extents,
+                std::vector<char> const& buf,
+                io_hints const& hints = io_hints())
+        {
+            return pwritev(extents, server::to_buffer(buf), hints);
+        }
+
+        lcos::future<ssize_t> pwritev(std::vector<extent> const& extents,
+                std::vector<char>&& buf, io_hints const& hints = io_hints())
+        {
+            return pwritev(extents, server::to_buffer(std::move(buf)),
+                hints);
+        }
+
+        ssize_t pwritev_sync(std::vector<extent> const& extents,
+                buffer_type const& buf, io_hints const& hints = io_hints())
+        {
+            return pwritev(extents, buf, hints).get();
+        }
+
+        ssize_t pwritev_sync(std::vector<extent> const& extents,
+                std::vector<char> const& buf,
+                io_hints const& hints = io_hints())
+        {
+            return pwritev(extents, buf, hints).get();
+        }
+
+        // the staged data is written with the given hints
+        lcos::future<int> flush(io_hints const& hints = io_hints())
+        {
+            typedef server::orangefs_file::flush_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    hints);
+        }
+
+        int flush_sync(io_hints const& hints = io_hints())
+        {
+            return flush(hints).get();
+        }
+
+        // flushes staged data first, the future returns 0 once the file
+        // reached stable storage
+        lcos::future<int> fsync()
+        {
+            typedef server::orangefs_file::fsync_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid());
+        }
+
+        int fsync_sync()
+        {
+            return fsync().get();
+        }
+
+        lcos::future<int> fdatasync()
+        {
+            typedef server::orangefs_file::fdatasync_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid());
+        }
+
+        int fdatasync_sync()
+        {
+            return fdatasync().get();
+        }
+
+        // Contribute to round number round of a collective operation with
+        // participants contributors in total, the component acts as the
+        // aggregator. Use collective_file rather than calling these directly.
+        lcos::future<ssize_t> collective_write(boost::uint64_t const round,
+                size_t const participants, std::vector<extent> const& extents,
+                buffer_type const& buf)
+        {
+            typedef server::orangefs_file::collective_write_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    round, participants, extents, buf);
+        }
+
+        lcos::future<buffer_type> collective_read(
+                boost::uint64_t const round, size_t const participants,
+                std::vector<extent> const& extents)
+        {
+            typedef server::orangefs_file::collective_read_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    round, participants, extents);
+        }
+
+        lcos::future<off_t> lseek(off_t const offset, int const whence,
+                io_hints const& hints = io_hints())
         {
             typedef server::orangefs_file::lseek_action action_type;
             return hpx::async<action_type>(this->base_type::get_gid(),
-                    offset, whence);
+                    offset, whence, hints);
+        }
+
+        off_t lseek_sync(off_t const offset, int const whence,
+                io_hints const& hints = io_hints())
+        {
+            return lseek(offset, whence, hints).get();
+        }
+
+        // Batched metadata operations, one action for a whole list of paths.
+        // The paths are handled on the component's locality, in parallel.
+
+        // open each path in a new orangefs_file component on the locality of
+        // this one, paths which could not be opened get an invalid id
+        lcos::future<std::vector<naming::id_type> > open_many(
+                std::vector<std::string> const& names,
+                int const flag)
+        {
+            typedef server::orangefs_file::open_many_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    names, flag);
+        }
+
+        std::vector<naming::id_type> open_many_sync(
+                std::vector<std::string> const& names,
+                int const flag)
+        {
+            return open_many(names, flag).get();
+        }
+
+        lcos::future<std::vector<file_status> > stat_many(
+                std::vector<std::string> const& paths)
+        {
+            typedef server::orangefs_file::stat_many_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    paths);
+        }
+
+        std::vector<file_status> stat_many_sync(
+                std::vector<std::string> const& paths)
+        {
+            return stat_many(paths).get();
+        }
+
+        // 0 for each path removed, -1 otherwise
+        lcos::future<std::vector<int> > unlink_many(
+                std::vector<std::string> const& paths)
+        {
+            typedef server::orangefs_file::unlink_many_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    paths);
+        }
+
+        std::vector<int> unlink_many_sync(
+                std::vector<std::string> const& paths)
+        {
+            return unlink_many(paths).get();
+        }
+
+        // create empty files, 0 for each file created, -1 otherwise
+        lcos::future<std::vector<int> > create_many(
+                std::vector<std::string> const& paths)
+        {
+            typedef server::orangefs_file::create_many_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    paths);
+        }
+
+        std::vector<int> create_many_sync(
+                std::vector<std::string> const& paths)
+        {
+            return create_many(paths).get();
+        }
+
+        // Metadata operations on arbitrary paths, executed on the
+        // component's locality. The int results are 0 on success, -1
+        // otherwise.
+        lcos::future<file_status> stat(std::string const& path)
+        {
+            typedef server::orangefs_file::stat_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    path);
+        }
+
+        file_status stat_sync(std::string const& path)
+        {
+            return stat(path).get();
+        }
+
+        lcos::future<int> mkdir(std::string const& path, int const mode = 0755)
+        {
+            typedef server::orangefs_file::mkdir_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    path, mode);
+        }
+
+        int mkdir_sync(std::string const& path, int const mode = 0755)
+        {
+            return mkdir(path, mode).get();
+        }
+
+        lcos::future<int> rmdir(std::string const& path)
+        {
+            typedef server::orangefs_file::rmdir_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    path);
+        }
+
+        int rmdir_sync(std::string const& path)
+        {
+            return rmdir(path).get();
+        }
+
+        lcos::future<int> rename(std::string const& from,
+                std::string const& to)
+        {
+            typedef server::orangefs_file::rename_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    from, to);
+        }
+
+        int rename_sync(std::string const& from, std::string const& to)
+        {
+            return rename(from, to).get();
+        }
+
+        lcos::future<int> truncate(std::string const& path,
+                off_t const length)
+        {
+            typedef server::orangefs_file::truncate_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    path, length);
+        }
+
+        int truncate_sync(std::string const& path, off_t const length)
+        {
+            return truncate(path, length).get();
+        }
+
+        // Streamed directory listings, see directory_reader for a
+        // convenient interface. opendir returns 0 on failure, readdir an
+        // empty batch at the end of the directory.
+        lcos::future<boost::uint64_t> opendir(std::string const& path)
+        {
+            typedef server::orangefs_file::opendir_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    path);
+        }
+
+        boost::uint64_t opendir_sync(std::string const& path)
+        {
+            return opendir(path).get();
+        }
+
+        lcos::future<std::vector<directory_entry> > readdir(
+                boost::uint64_t const handle, size_t const count)
+        {
+            typedef server::orangefs_file::readdir_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    handle, count);
+        }
+
+        std::vector<directory_entry> readdir_sync(
+                boost::uint64_t const handle, size_t const count)
+        {
+            return readdir(handle, count).get();
+        }
+
+        lcos::future<int> closedir(boost::uint64_t const handle)
+        {
+            typedef server::orangefs_file::closedir_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    handle);
+        }
+
+        int closedir_sync(boost::uint64_t const handle)
+        {
+            return closedir(handle).get();
+        }
+
+        // Copy count bytes from src_offset of this file to dst_offset of
+        // dest, or with copy_from from src_offset of src to dst_offset of
+        // this file, staging data out of or into OrangeFS. The copy runs on
+        // this file's locality and moves the data straight between the
+        // components. copy_status and copy_wait are used by the returned
+        // file_copy.
+        file_copy<orangefs_file> copy_to(orangefs_file const& dest,
+                off_t const src_offset, off_t const dst_offset,
+                boost::uint64_t const count)
+        {
+            typedef server::orangefs_file::copy_to_action action_type;
+            naming::id_type const gid = this->base_type::get_gid();
+            return file_copy<orangefs_file>(gid, hpx::async<action_type>(gid,
+                    gid, dest.get_gid(), src_offset, dst_offset, count));
+        }
+
+        file_copy<orangefs_file> copy_to(local_file const& dest,
+                off_t const src_offset, off_t const dst_offset,
+                boost::uint64_t const count)
+        {
+            typedef server::orangefs_file::copy_to_local_file_action
+                action_type;
+            naming::id_type const gid = this->base_type::get_gid();
+            return file_copy<orangefs_file>(gid, hpx::async<action_type>(gid,
+                    gid, dest.get_gid(), src_offset, dst_offset, count));
+        }
+
+        file_copy<orangefs_file> copy_from(local_file const& src,
+                off_t const src_offset, off_t const dst_offset,
+                boost::uint64_t const count)
+        {
+            typedef server::orangefs_file::copy_from_local_file_action
+                action_type;
+            naming::id_type const gid = this->base_type::get_gid();
+            return file_copy<orangefs_file>(gid, hpx::async<action_type>(gid,
+                    gid, src.get_gid(), src_offset, dst_offset, count));
+        }
+
+        lcos::future<copy_progress> copy_status(boost::uint64_t const handle)
+        {
+            typedef server::orangefs_file::copy_status_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    handle);
+        }
+
+        copy_progress copy_status_sync(boost::uint64_t const handle)
+        {
+            return copy_status(handle).get();
+        }
+
+        lcos::future<ssize_t> copy_wait(boost::uint64_t const handle)
+        {
+            typedef server::orangefs_file::copy_wait_action action_type;
+            return hpx::async<action_type>(this->base_type::get_gid(),
+                    handle);
         }
 
-        off_t lseek_sync(off_t const offset, int const whence)
+        ssize_t copy_wait_sync(boost::uint64_t const handle)
         {
-            return lseek(offset, whence).get();
+            return copy_wait(handle).get();
         }
 
     };
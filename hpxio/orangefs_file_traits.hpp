@@ -0,0 +1,100 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_ORANGEFS_FILE_TRAITS_HPP_JUL_08_2015_1130AM)
+#define HPX_COMPONENTS_IO_ORANGEFS_FILE_TRAITS_HPP_JUL_08_2015_1130AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpxio/file.hpp>
+#include <hpxio/open_mode.hpp>
+#include <hpxio/orangefs_file.hpp>
+#include <hpxio/pxfs_file.hpp>
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // orangefs_file is opened with open() flags
+    template <>
+    struct file_traits<orangefs_file>
+      : default_file_traits<orangefs_file>
+    {
+        static char const* name()
+        {
+            return "orangefs_file";
+        }
+
+        static lcos::future<int> open(orangefs_file& f,
+            std::string const& name, std::string const& mode)
+        {
+            int const flags = mode_to_flags(mode);
+            if (flags < 0)
+            {
+                return hpx::make_ready_future(-1);
+            }
+
+            orangefs_file c(f);
+            return f.open(name, flags).then(
+                [c](lcos::future<void> r) mutable -> int
+                {
+                    r.get();
+                    return c.is_open_sync() ? 0 : -1;
+                });
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // pxfs_file talks to OrangeFS directly from the calling locality, it
+    // cannot be copied and ignores the locality given to create()
+    template <>
+    struct file_traits<pxfs_file>
+      : default_file_traits<pxfs_file>
+    {
+        static char const* name()
+        {
+            return "pxfs_file";
+        }
+
+        static lcos::future<int> open(pxfs_file& f, std::string const& name,
+            std::string const& mode)
+        {
+            int const flags = mode_to_flags(mode);
+            if (flags < 0)
+            {
+                return hpx::make_ready_future(-1);
+            }
+
+            return f.open(name, flags).then(
+                [](lcos::future<int> r) -> int
+                {
+                    return (r.get() < 0) ? -1 : 0;
+                });
+        }
+
+        static lcos::future<bool> is_open(pxfs_file& f)
+        {
+            return hpx::make_ready_future(f.is_open());
+        }
+
+        static lcos::future<int> close(pxfs_file& f)
+        {
+            return f.close();
+        }
+
+        static boost::shared_ptr<pxfs_file> create(naming::id_type const&)
+        {
+            return boost::make_shared<pxfs_file>();
+        }
+    };
+
+}} // hpx::io
+
+#endif
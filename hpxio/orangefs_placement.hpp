@@ -0,0 +1,78 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_ORANGEFS_PLACEMENT_HPP_JUN_29_2015_0340PM)
+#define HPX_COMPONENTS_IO_ORANGEFS_PLACEMENT_HPP_JUN_29_2015_0340PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/include/thread_executors.hpp>
+#include <hpxio/orangefs_file.hpp>
+#include <hpxio/placement.hpp>
+#include <hpxio/server/orangefs_placement.hpp>
+
+#include <boost/cstdint.hpp>
+
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // An orangefs_file is best served by the locality running on the host
+    // of most of the OrangeFS servers which hold the file's datafiles, the
+    // weight of a locality is the number of datafiles on its host.
+    template <>
+    struct placement_traits<orangefs_file>
+    {
+        static char const* name()
+        {
+            return "orangefs_file";
+        }
+
+        static lcos::future<std::vector<boost::uint64_t> > scores(
+            std::string const& path,
+            std::vector<naming::id_type> const& localities)
+        {
+            typedef server::local_host_share_action action_type;
+
+            // the layout query blocks, it is run on the io_pool
+            std::vector<std::string> hosts;
+            {
+                hpx::threads::executors::io_pool_executor scheduler;
+                scheduler.add(
+                    [&hosts, &path]()
+                    {
+                        hosts = server::orangefs_data_hosts(path);
+                    });
+            }
+
+            std::vector<lcos::future<boost::uint64_t> > lazy_results;
+            lazy_results.reserve(localities.size());
+            for (std::size_t i = 0; i != localities.size(); ++i)
+            {
+                lazy_results.push_back(hosts.empty() ?
+                    hpx::make_ready_future(boost::uint64_t(0)) :
+                    hpx::async<action_type>(localities[i], hosts));
+            }
+            return hpx::when_all(lazy_results).then(
+                [](lcos::future<std::vector<lcos::future<boost::uint64_t> > > f)
+                {
+                    std::vector<lcos::future<boost::uint64_t> > r = f.get();
+
+                    std::vector<boost::uint64_t> result;
+                    result.reserve(r.size());
+                    for (std::size_t i = 0; i != r.size(); ++i)
+                    {
+                        result.push_back(r[i].get());
+                    }
+                    return result;
+                });
+        }
+    };
+
+}} // hpx::io
+
+#endif
@@ -0,0 +1,458 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_PARTITIONED_FILE_HPP_JUN_24_2015_1120AM)
+#define HPX_COMPONENTS_IO_PARTITIONED_FILE_HPP_JUN_24_2015_1120AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/runtime.hpp>
+#include <hpxio/extent.hpp>
+#include <hpxio/local_file.hpp>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // One logical file striped round-robin across local_file components on
+    // several localities. Stripe s of the logical file is stored on partition
+    // s % width, at offset (s / width) * stripe_size of that partition's
+    // file, so the pieces are dense. Partition i keeps its piece in the file
+    // name + "." + i on its own locality.
+    //
+    // pread and pwrite are split at stripe boundaries and issue a single
+    // preadv/pwritev per partition involved, all partitions are accessed in
+    // parallel. As for a plain file the result of a transfer is the number
+    // of bytes handled before the first gap, e.g. the end of file.
+    //
+    // Only positional I/O is supported, there is no shared file position.
+    class partitioned_file
+    {
+      private:
+        // the part of a request falling into one stripe
+        struct segment
+        {
+            std::size_t partition;
+            extent local;           // range within the partition's piece
+            std::size_t pos;        // position within the request buffer
+        };
+
+        struct plan
+        {
+            std::vector<segment> segments;
+
+            // the segments of each partition in request order
+            std::vector<std::vector<std::size_t> > by_partition;
+        };
+
+      public:
+        // stripe_width == 0 stripes across all localities
+        explicit partitioned_file(std::size_t stripe_size = 1024 * 1024,
+                std::size_t stripe_width = 0)
+          : stripe_size_((std::max)(stripe_size, std::size_t(1)))
+        {
+            std::vector<naming::id_type> localities =
+                hpx::find_all_localities();
+            if (stripe_width == 0 || stripe_width > localities.size())
+            {
+                stripe_width = localities.size();
+            }
+            localities.resize(stripe_width);
+            create_partitions(localities);
+        }
+
+        // place the partitions on the given localities, in this order
+        partitioned_file(std::vector<naming::id_type> const& localities,
+                std::size_t stripe_size)
+          : stripe_size_((std::max)(stripe_size, std::size_t(1)))
+        {
+            create_partitions(localities);
+        }
+
+        std::size_t stripe_size() const
+        {
+            return stripe_size_;
+        }
+
+        std::size_t stripe_width() const
+        {
+            return partitions_.size();
+        }
+
+        lcos::future<void> open(std::string const& name,
+                std::string const& mode)
+        {
+            std::vector<lcos::future<void> > lazy_results;
+            lazy_results.reserve(partitions_.size());
+            for (std::size_t i = 0; i != partitions_.size(); ++i)
+            {
+                lazy_results.push_back(
+                    partitions_[i].open(piece_name(name, i), mode));
+            }
+            return hpx::when_all(lazy_results).then(
+                [](lcos::future<std::vector<lcos::future<void> > > f)
+                {
+                    std::vector<lcos::future<void> > r = f.get();
+                    for (std::size_t i = 0; i != r.size(); ++i)
+                    {
+                        r[i].get();
+                    }
+                });
+        }
+
+        void open_sync(std::string const& name, std::string const& mode)
+        {
+            return open(name, mode).get();
+        }
+
+        // the logical file is open if all of its pieces are
+        lcos::future<bool> is_open()
+        {
+            std::vector<lcos::future<bool> > lazy_results;
+            lazy_results.reserve(partitions_.size());
+            for (std::size_t i = 0; i != partitions_.size(); ++i)
+            {
+                lazy_results.push_back(partitions_[i].is_open());
+            }
+            return hpx::when_all(lazy_results).then(
+                [](lcos::future<std::vector<lcos::future<bool> > > f)
+                {
+                    std::vector<lcos::future<bool> > r = f.get();
+                    bool result = !r.empty();
+                    for (std::size_t i = 0; i != r.size(); ++i)
+                    {
+                        result = r[i].get() && result;
+                    }
+                    return result;
+                });
+        }
+
+        bool is_open_sync()
+        {
+            return is_open().get();
+        }
+
+        // returns -1 if any of the partitions failed to close cleanly
+        lcos::future<int> close()
+        {
+            std::vector<lcos::future<int> > lazy_results;
+            lazy_results.reserve(partitions_.size());
+            for (std::size_t i = 0; i != partitions_.size(); ++i)
+            {
+                lazy_results.push_back(partitions_[i].close());
+            }
+            return hpx::when_all(lazy_results).then(
+                [](lcos::future<std::vector<lcos::future<int> > > f) -> int
+                {
+                    std::vector<lcos::future<int> > r = f.get();
+                    int result = 0;
+                    for (std::size_t i = 0; i != r.size(); ++i)
+                    {
+                        if (r[i].get() != 0)
+                        {
+                            result = -1;
+                        }
+                    }
+                    return result;
+                });
+        }
+
+        int close_sync()
+        {
+            return close().get();
+        }
+
+        // removes all pieces, returns 0 if all of them were removed
+        lcos::future<int> remove_file(std::string const& file_name)
+        {
+            std::vector<lcos::future<int> > lazy_results;
+            lazy_results.reserve(partitions_.size());
+            for (std::size_t i = 0; i != partitions_.size(); ++i)
+            {
+                lazy_results.push_back(
+                    partitions_[i].remove_file(piece_name(file_name, i)));
+            }
+            return combine_status(lazy_results);
+        }
+
+        int remove_file_sync(std::string const& file_name)
+        {
+            return remove_file(file_name).get();
+        }
+
+        lcos::future<std::vector<char> > pread(size_t const count,
+                off_t const offset)
+        {
+            if (count == 0 || offset < 0 || partitions_.empty())
+            {
+                return hpx::make_ready_future(std::vector<char>());
+            }
+
+            boost::shared_ptr<plan> p = make_plan(count, offset);
+
+            // the data of the partitions arrives as zero-copy buffers and is
+            // copied into its place in the result once
+            typedef local_file::buffer_type buffer_type;
+            std::vector<lcos::future<buffer_type> > lazy_results;
+            lazy_results.reserve(p->by_partition.size());
+            for (std::size_t i = 0; i != p->by_partition.size(); ++i)
+            {
+                if (p->by_partition[i].empty())
+                {
+                    lazy_results.push_back(
+                        hpx::make_ready_future(buffer_type()));
+                    continue;
+                }
+                lazy_results.push_back(partitions_[i].preadv_buffer(
+                    local_extents(*p, i)));
+            }
+
+            return hpx::when_all(lazy_results).then(
+                [p, count](lcos::future<
+                    std::vector<lcos::future<buffer_type> > > f)
+                {
+                    std::vector<lcos::future<buffer_type> > r = f.get();
+
+                    std::vector<char> result(count);
+                    std::vector<std::size_t> done(p->segments.size(), 0);
+                    for (std::size_t i = 0; i != r.size(); ++i)
+                    {
+                        buffer_type data = r[i].get();
+                        std::vector<std::size_t> const& segs =
+                            p->by_partition[i];
+
+                        std::size_t pos = 0;
+                        for (std::size_t j = 0;
+                             j != segs.size() && pos < data.size(); ++j)
+                        {
+                            segment const& s = p->segments[segs[j]];
+                            std::size_t len = (std::min)(s.local.count,
+                                data.size() - pos);
+                            std::memcpy(result.data() + s.pos,
+                                data.data() + pos, len);
+                            done[segs[j]] = len;
+                            pos += len;
+                        }
+                    }
+
+                    result.resize(contiguous_length(*p, done));
+                    return result;
+                });
+        }
+
+        std::vector<char> pread_sync(size_t const count, off_t const offset)
+        {
+            return pread(count, offset).get();
+        }
+
+        lcos::future<ssize_t> pwrite(std::vector<char> const& buf,
+                off_t const offset)
+        {
+            if (buf.empty() || offset < 0 || partitions_.empty())
+            {
+                return hpx::make_ready_future(ssize_t(0));
+            }
+
+            boost::shared_ptr<plan> p = make_plan(buf.size(), offset);
+
+            std::vector<lcos::future<ssize_t> > lazy_results;
+            lazy_results.reserve(p->by_partition.size());
+            for (std::size_t i = 0; i != p->by_partition.size(); ++i)
+            {
+                std::vector<std::size_t> const& segs = p->by_partition[i];
+                if (segs.empty())
+                {
+                    lazy_results.push_back(hpx::make_ready_future(ssize_t(0)));
+                    continue;
+                }
+
+                // gather the data of the partition's stripes back to back
+                std::vector<char> data;
+                for (std::size_t j = 0; j != segs.size(); ++j)
+                {
+                    segment const& s = p->segments[segs[j]];
+                    data.insert(data.end(), buf.begin() + s.pos,
+                        buf.begin() + s.pos + s.local.count);
+                }
+                lazy_results.push_back(partitions_[i].pwritev(
+                    local_extents(*p, i), std::move(data)));
+            }
+
+            return hpx::when_all(lazy_results).then(
+                [p](lcos::future<std::vector<lcos::future<ssize_t> > > f)
+                    -> ssize_t
+                {
+                    std::vector<lcos::future<ssize_t> > r = f.get();
+
+                    std::vector<std::size_t> done(p->segments.size(), 0);
+                    for (std::size_t i = 0; i != r.size(); ++i)
+                    {
+                        ssize_t len = r[i].get();
+                        std::size_t left = (len > 0) ? len : 0;
+
+                        std::vector<std::size_t> const& segs =
+                            p->by_partition[i];
+                        for (std::size_t j = 0; j != segs.size(); ++j)
+                        {
+                            std::size_t n = (std::min)(left,
+                                p->segments[segs[j]].local.count);
+                            done[segs[j]] = n;
+                            left -= n;
+                        }
+                    }
+
+                    return contiguous_length(*p, done);
+                });
+        }
+
+        ssize_t pwrite_sync(std::vector<char> const& buf, off_t const offset)
+        {
+            return pwrite(buf, offset).get();
+        }
+
+        lcos::future<int> flush()
+        {
+            std::vector<lcos::future<int> > lazy_results;
+            lazy_results.reserve(partitions_.size());
+            for (std::size_t i = 0; i != partitions_.size(); ++i)
+            {
+                lazy_results.push_back(partitions_[i].flush());
+            }
+            return combine_status(lazy_results);
+        }
+
+        int flush_sync()
+        {
+            return flush().get();
+        }
+
+        lcos::future<int> fsync()
+        {
+            std::vector<lcos::future<int> > lazy_results;
+            lazy_results.reserve(partitions_.size());
+            for (std::size_t i = 0; i != partitions_.size(); ++i)
+            {
+                lazy_results.push_back(partitions_[i].fsync());
+            }
+            return combine_status(lazy_results);
+        }
+
+        int fsync_sync()
+        {
+            return fsync().get();
+        }
+
+      private:
+        void create_partitions(std::vector<naming::id_type> const& localities)
+        {
+            partitions_.reserve(localities.size());
+            for (std::size_t i = 0; i != localities.size(); ++i)
+            {
+                partitions_.push_back(local_file::create(localities[i]));
+            }
+        }
+
+        static std::string piece_name(std::string const& name, std::size_t i)
+        {
+            return name + "." + boost::lexical_cast<std::string>(i);
+        }
+
+        boost::shared_ptr<plan> make_plan(std::size_t count,
+            off_t offset) const
+        {
+            off_t const ss = stripe_size_;
+            off_t const width = partitions_.size();
+
+            boost::shared_ptr<plan> p = boost::make_shared<plan>();
+            p->by_partition.resize(partitions_.size());
+            p->segments.reserve(count / stripe_size_ + 2);
+
+            off_t const end = offset + count;
+            for (off_t pos = offset; pos < end; /**/)
+            {
+                off_t const stripe = pos / ss;
+                off_t const next = (std::min)((stripe + 1) * ss, end);
+
+                segment s;
+                s.partition = stripe % width;
+                s.local = extent((stripe / width) * ss + pos % ss,
+                    next - pos);
+                s.pos = pos - offset;
+
+                p->by_partition[s.partition].push_back(p->segments.size());
+                p->segments.push_back(s);
+                pos = next;
+            }
+            return p;
+        }
+
+        static std::vector<extent> local_extents(plan const& p,
+            std::size_t partition)
+        {
+            std::vector<std::size_t> const& segs = p.by_partition[partition];
+
+            std::vector<extent> extents;
+            extents.reserve(segs.size());
+            for (std::size_t j = 0; j != segs.size(); ++j)
+            {
+                extents.push_back(p.segments[segs[j]].local);
+            }
+            return extents;
+        }
+
+        // the bytes transferred up to the first short segment
+        static ssize_t contiguous_length(plan const& p,
+            std::vector<std::size_t> const& done)
+        {
+            std::size_t total = 0;
+            for (std::size_t i = 0; i != p.segments.size(); ++i)
+            {
+                total += done[i];
+                if (done[i] < p.segments[i].local.count)
+                {
+                    break;
+                }
+            }
+            return total;
+        }
+
+        // 0 if all partitions succeeded, the first failure otherwise
+        static lcos::future<int> combine_status(
+            std::vector<lcos::future<int> >& lazy_results)
+        {
+            return hpx::when_all(lazy_results).then(
+                [](lcos::future<std::vector<lcos::future<int> > > f)
+                {
+                    std::vector<lcos::future<int> > r = f.get();
+                    int result = 0;
+                    for (std::size_t i = 0; i != r.size(); ++i)
+                    {
+                        int status = r[i].get();
+                        if (result == 0)
+                        {
+                            result = status;
+                        }
+                    }
+                    return result;
+                });
+        }
+
+        std::size_t stripe_size_;
+        std::vector<local_file> partitions_;
+    };
+
+}} // hpx::io
+
+#endif
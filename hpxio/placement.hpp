@@ -0,0 +1,179 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_PLACEMENT_HPP_JUN_29_2015_0230PM)
+#define HPX_COMPONENTS_IO_PLACEMENT_HPP_JUN_29_2015_0230PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/include/async.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/runtime.hpp>
+#include <hpx/runtime/agas/interface.hpp>
+#include <hpxio/local_file.hpp>
+#include <hpxio/server/placement.hpp>
+
+#include <boost/cstdint.hpp>
+
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // placement_traits<File> tells how close each locality is to the data of
+    // a file: scores() returns one weight per locality, the component is
+    // created on the locality with the highest weight. If all weights are 0
+    // the data is equally far from everybody and the caller's locality is
+    // used.
+    template <typename File>
+    struct placement_traits;
+
+    // local files are best served by the locality holding them on a local
+    // disk, files on shared file systems stay with the caller
+    template <>
+    struct placement_traits<local_file>
+    {
+        static char const* name()
+        {
+            return "local_file";
+        }
+
+        static lcos::future<std::vector<boost::uint64_t> > scores(
+            std::string const& path,
+            std::vector<naming::id_type> const& localities)
+        {
+            typedef server::local_data_size_action action_type;
+
+            std::vector<lcos::future<boost::uint64_t> > lazy_results;
+            lazy_results.reserve(localities.size());
+            for (std::size_t i = 0; i != localities.size(); ++i)
+            {
+                lazy_results.push_back(
+                    hpx::async<action_type>(localities[i], path));
+            }
+            return hpx::when_all(lazy_results).then(
+                [](lcos::future<std::vector<lcos::future<boost::uint64_t> > > f)
+                {
+                    std::vector<lcos::future<boost::uint64_t> > r = f.get();
+
+                    std::vector<boost::uint64_t> result;
+                    result.reserve(r.size());
+                    for (std::size_t i = 0; i != r.size(); ++i)
+                    {
+                        result.push_back(r[i].get());
+                    }
+                    return result;
+                });
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Creates or locates the file component for a path on the locality
+    // closest to the file's data, so reads do not have to cross the network.
+    // There is at most one placed component per path and file type in the
+    // whole application. It is registered with AGAS under
+    // /hpxio/placement/<file type>/<path> and stays alive until release()
+    // is called for the path.
+    template <typename File>
+    class file_placement
+    {
+      public:
+        file_placement()
+          : localities_(hpx::find_all_localities())
+        {}
+
+        lcos::future<File> locate(std::string const& path) const
+        {
+            std::vector<naming::id_type> localities = localities_;
+            return hpx::async(
+                [path, localities]()
+                {
+                    return locate_impl(path, localities);
+                });
+        }
+
+        File locate_sync(std::string const& path) const
+        {
+            return locate_impl(path, localities_);
+        }
+
+        // the locality a new component for path would be placed on
+        lcos::future<naming::id_type> where(std::string const& path) const
+        {
+            std::vector<naming::id_type> localities = localities_;
+            return placement_traits<File>::scores(path, localities).then(
+                [localities](
+                    lcos::future<std::vector<boost::uint64_t> > f)
+                {
+                    return best_locality(localities, f.get());
+                });
+        }
+
+        // drop the registration, the component goes away with its last user
+        void release(std::string const& path) const
+        {
+            hpx::agas::unregister_name_sync(registry_key(path));
+        }
+
+      private:
+        static std::string registry_key(std::string const& path)
+        {
+            return std::string("/hpxio/placement/") +
+                placement_traits<File>::name() + "/" + path;
+        }
+
+        static naming::id_type best_locality(
+            std::vector<naming::id_type> const& localities,
+            std::vector<boost::uint64_t> const& scores)
+        {
+            naming::id_type result = hpx::find_here();
+            boost::uint64_t best = 0;
+            for (std::size_t i = 0; i != scores.size(); ++i)
+            {
+                if (scores[i] > best)
+                {
+                    best = scores[i];
+                    result = localities[i];
+                }
+            }
+            return result;
+        }
+
+        static File locate_impl(std::string const& path,
+            std::vector<naming::id_type> const& localities)
+        {
+            std::string const key = registry_key(path);
+
+            error_code ec(lightweight);
+            naming::id_type id = hpx::agas::resolve_name_sync(key, ec);
+            if (!ec && id)
+            {
+                return File(id);
+            }
+
+            naming::id_type const locality = best_locality(localities,
+                placement_traits<File>::scores(path, localities).get());
+
+            File f = File::create(locality);
+            if (!hpx::agas::register_name_sync(key, f.get_gid()))
+            {
+                // somebody else was faster, use theirs
+                error_code ec(lightweight);
+                id = hpx::agas::resolve_name_sync(key, ec);
+                if (!ec && id)
+                {
+                    return File(id);
+                }
+            }
+            return f;
+        }
+
+        std::vector<naming::id_type> localities_;
+    };
+
+}} // hpx::io
+
+#endif
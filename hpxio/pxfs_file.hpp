@@ -8,24 +8,51 @@
 // 1. pxfs callback functions will be executed on pxfs threads, so avoid hpx
 //    calls, make it as simple as possible. Otherwise will trigger the 
 //    "Runtime is not available, reporting error locally." error.
-//    Put all operations inside the set_value function.
+//    The callbacks only hand the completion to the completion_queue, all
+//    operations are done inside the complete_* functions.
 // 2. When using intrusive_ptr and shard_ptr, do not use reference, always copy
 //    value.
-// 3. Need to use Boost 1.56.0 or above for the intrusive_ptr detach() API.
+// 3. Every pending pxfs request owns one reference to its request data,
+//    taken by retain() and adopted by the complete_* functions. Request data
+//    and read buffers are recycled through the pools in request_pool.hpp.
 // 4. Need to use pxfs patched version of OrangeFS at 
 //    https://github.com/STEllAR-GROUP/hpxfs/tree/master/
 //    orangefs-stable-with-asyncio-changes
+// 5. The pxfs_* calls only queue a request and return, they are issued
+//    directly from the calling HPX thread. Results are delivered through
+//    the callbacks only, the returned future is the only way to wait.
+// 6. Requests are timed from retain() to their complete_* function. The
+//    /hpxio/pxfs_file/... performance counters are installed by passing
+//    register_pxfs_counters to hpx::register_startup_function.
+// 7. The statistics are kept by server::io_statistics, which is exported
+//    from the local_file component. Programs using this header have to link
+//    against local_file_component.
 
 #if !defined(HPX_COMPONENTS_IO_PXFS_FILE_HPP_SEP_11_2014_0550PM)
 #define HPX_COMPONENTS_IO_PXFS_FILE_HPP_SEP_11_2014_0550PM
 
 #include <hpx/hpx_fwd.hpp>
 #include <hpx/include/iostreams.hpp>
-#include <hpx/include/thread_executors.hpp>
+#include <hpx/include/lcos.hpp>
 #include <hpx/include/runtime.hpp>
 
-#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/atomic.hpp>
 #include <boost/intrusive_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/lockfree/queue.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <string>
+#include <vector>
+
+#include <hpx/util/serialize_buffer.hpp>
+
+#include <hpxio/extent.hpp>
+#include <hpxio/file_status.hpp>
+#include <hpxio/request_pool.hpp>
+#include <hpxio/server/group_commit.hpp>
+#include <hpxio/server/io_statistics.hpp>
 
 /* ------------------------  added pvfs header stuff --------------- */
 
@@ -67,7 +94,7 @@ namespace hpx { namespace io
         bool requires_deregistration_;
     };
 
-    struct general_data
+    struct general_data : server::timed_request
     {
         lcos::local::promise<int> p_;
         boost::atomic<std::size_t> count_;
@@ -90,43 +117,75 @@ namespace hpx { namespace io
         {
             if (0 == --p->count_)
             {
-                delete p;
+                request_pool<general_data>::destroy(p);
             }
         }
     };
 
-    struct read_data
+    // The read buffer is drawn uninitialized from the buffer_pool and
+    // handed over as is for Result == buffer_type. A std::vector result is
+    // built from the bytes actually read once the request completes and
+    // the buffer goes back to the pool.
+    template <typename Result>
+    struct basic_read_data : server::timed_request
     {
-        lcos::local::promise<std::vector<char> > p_;
-        std::vector<char> buf_;
+        lcos::local::promise<Result> p_;
+        char* buf_;
+        std::size_t capacity_;
         ssize_t len_;
 
         boost::atomic<std::size_t> count_;
         hpx::runtime *rt_p_;
 
-        read_data(hpx::runtime* rt_p) :
-            len_(0), count_(0), rt_p_(rt_p) {}
+        basic_read_data(hpx::runtime* rt_p) :
+            buf_(0), capacity_(0), len_(0), count_(0), rt_p_(rt_p) {}
 
-        lcos::future<std::vector<char> > get_future()
+        ~basic_read_data()
+        {
+            release_buffer();
+        }
+
+        lcos::future<Result> get_future()
         {
             return p_.get_future();
         }
 
-        friend void intrusive_ptr_add_ref(read_data* p)
+        char* acquire_buffer(std::size_t count)
+        {
+            capacity_ = buffer_pool::capacity(count);
+            buf_ = buffer_pool::allocate(capacity_);
+            return buf_;
+        }
+
+        void release_buffer()
+        {
+            if (buf_ != 0)
+            {
+                buffer_pool::deallocate(buf_, capacity_);
+                buf_ = 0;
+            }
+        }
+
+        friend void intrusive_ptr_add_ref(basic_read_data* p)
         {
             ++p->count_;
         }
 
-        friend void intrusive_ptr_release(read_data* p)
+        friend void intrusive_ptr_release(basic_read_data* p)
         {
             if (0 == --p->count_)
             {
-                delete p;
+                request_pool<basic_read_data>::destroy(p);
             }
         }
     };
 
-    struct write_data
+    typedef hpx::util::serialize_buffer<char> buffer_type;
+
+    typedef basic_read_data<std::vector<char> > read_data;
+    typedef basic_read_data<buffer_type> read_buffer_data;
+
+    struct write_data : server::timed_request
     {
         lcos::local::promise<ssize_t> p_;
         ssize_t len_;
@@ -151,12 +210,12 @@ namespace hpx { namespace io
         {
             if (0 == --p->count_)
             {
-                delete p;
+                request_pool<write_data>::destroy(p);
             }
         }
     };
 
-    struct lseek_data
+    struct lseek_data : server::timed_request
     {
         lcos::local::promise<off_t> p_;
         off_t offset_;
@@ -181,29 +240,81 @@ namespace hpx { namespace io
         {
             if (0 == --p->count_)
             {
-                delete p;
+                request_pool<lseek_data>::destroy(p);
             }
         }
     };
 
-    void set_int_value(hpx::lcos::local::promise<int>& p,
+    struct stat_data : server::timed_request
+    {
+        lcos::local::promise<file_status> p_;
+        struct stat st_;
+
+        boost::atomic<std::size_t> count_;
+        hpx::runtime *rt_p_;
+
+        stat_data(hpx::runtime* rt_p) :
+            count_(0), rt_p_(rt_p) {}
+
+        lcos::future<file_status> get_future()
+        {
+            return p_.get_future();
+        }
+
+        friend void intrusive_ptr_add_ref(stat_data* p)
+        {
+            ++p->count_;
+        }
+
+        friend void intrusive_ptr_release(stat_data* p)
+        {
+            if (0 == --p->count_)
+            {
+                request_pool<stat_data>::destroy(p);
+            }
+        }
+    };
+
+    inline void set_int_value(hpx::lcos::local::promise<int>& p,
                 int const result)
     {
         // notify the waiting HPX thread and return a value
         p.set_value(result);
     }
 
-    void set_char_vector_value(
+    inline void set_char_vector_value(
             boost::intrusive_ptr<read_data> p)
     {
-        // format result
-        std::vector<char> result(p->buf_.begin(),
-                p->buf_.begin() + p->len_);
+        // copy what was actually read, the buffer goes back to the pool
+        std::vector<char> result;
+        if (p->len_ > 0)
+        {
+            result.assign(p->buf_, p->buf_ + p->len_);
+        }
+        p->release_buffer();
+        // notify the waiting HPX thread and return a value
+        p->p_.set_value(std::move(result));
+    }
+
+    inline void set_buffer_value(
+            boost::intrusive_ptr<read_buffer_data> p)
+    {
+        if (p->len_ <= 0)
+        {
+            p->release_buffer();
+            p->p_.set_value(buffer_type());
+            return;
+        }
+
+        // the buffer returns to the pool once the caller releases it
+        buffer_type result(p->buf_, p->len_, buffer_type::take,
+            buffer_pool::deleter(p->capacity_));
+        p->buf_ = 0;
         // notify the waiting HPX thread and return a value
-        p->p_.set_value(result);
+        p->p_.set_value(std::move(result));
     }
 
-    void set_ssize_t_value(
+    inline void set_ssize_t_value(
             hpx::lcos::local::promise<ssize_t>& p,
                 ssize_t const result)
     {
@@ -211,7 +322,7 @@ namespace hpx { namespace io
         p.set_value(result);
     }
 
-    void set_off_t_value(
+    inline void set_off_t_value(
             hpx::lcos::local::promise<off_t>& p,
                 off_t const result)
     {
@@ -219,97 +330,185 @@ namespace hpx { namespace io
         p.set_value(result);
     }
 
-    int set_read_promise_cb(void *cdat, int status)
+    ///////////////////////////////////////////////////////////////////////////
+    // Completions reported by the pxfs callback threads are pushed into a
+    // lock-free queue and handled in batches by a single HPX thread, which
+    // is only spawned if none is draining the queue already. Each pxfs
+    // thread registers itself once with the runtime, on its first callback.
+    class completion_queue
     {
-        boost::intrusive_ptr<read_data> p(
-                reinterpret_cast<read_data*>(cdat));
+      private:
+        typedef void (*complete_fn)(void* cdat, int status);
 
-        // create a unique thread name based on UTC clock
-        boost::posix_time::ptime now =
-            boost::posix_time::microsec_clock::universal_time();
-        std::string thread_name = std::string("pxfs_read_") +
-            boost::posix_time::to_iso_string(now);
+        struct entry
+        {
+            complete_fn fn;
+            void* cdat;
+            int status;
+        };
 
-        // register this thread in order to be able to
-        // call HPX functionality
-        registration_wrapper wrap(p->rt_p_, thread_name.c_str());
+      public:
+        completion_queue()
+          : queue_(128), draining_(false), thread_count_(0)
+        {}
 
-        // Create an HPX thread to guarantee that the promise::set_value
-        // function can be invoked safely.
-        hpx::threads::register_thread(hpx::util::bind(
-                    &set_char_vector_value, p));
+        static completion_queue& get()
+        {
+            static completion_queue queue;
+            return queue;
+        }
 
-        return status;
-    }
+        // called on a pxfs thread
+        void push(hpx::runtime* rt, complete_fn fn, void* cdat, int status)
+        {
+            if (registration_.get() == 0)
+            {
+                std::string thread_name = std::string("pxfs_callback#") +
+                    boost::lexical_cast<std::string>(++thread_count_);
+                registration_.reset(
+                    new registration_wrapper(rt, thread_name.c_str()));
+            }
 
-    int set_write_promise_cb(void *cdat, int status)
-    {
-        boost::intrusive_ptr<write_data> p(
-                reinterpret_cast<write_data*>(cdat));
+            entry e = { fn, cdat, status };
+            queue_.push(e);
 
-        // create a unique thread name based on UTC clock
-        boost::posix_time::ptime now =
-            boost::posix_time::microsec_clock::universal_time();
-        std::string thread_name = std::string("pxfs_write_") +
-            boost::posix_time::to_iso_string(now);
+            if (!draining_.exchange(true))
+            {
+                // Create an HPX thread to guarantee that the
+                // promise::set_value functions can be invoked safely.
+                hpx::threads::register_thread(hpx::util::bind(
+                    &completion_queue::drain, this));
+            }
+        }
+
+      private:
+        void drain()
+        {
+            for (;;)
+            {
+                entry e;
+                while (queue_.pop(e))
+                {
+                    e.fn(e.cdat, e.status);
+                }
+
+                draining_.store(false);
+
+                // an entry pushed meanwhile may have seen the flag still set
+                if (queue_.empty() || draining_.exchange(true))
+                {
+                    return;
+                }
+            }
+        }
 
-        // register this thread in order to be able to
-        // call HPX functionality
-        registration_wrapper wrap(p->rt_p_, thread_name.c_str());
+        boost::lockfree::queue<entry> queue_;
+        boost::atomic<bool> draining_;
+        boost::atomic<std::size_t> thread_count_;
 
-        // Create an HPX thread to guarantee that the promise::set_value
-        // function can be invoked safely.
-        hpx::threads::register_thread(hpx::util::bind(
-                    &set_ssize_t_value,
-                    boost::ref(p->p_), p->len_));
+        // unregisters each pxfs thread when it exits
+        boost::thread_specific_ptr<registration_wrapper> registration_;
+    };
 
-        return status;
+    // A reference to the request data is handed to pxfs with every call, it
+    // is adopted again once the request has completed.
+    template <typename Data>
+    inline void* retain(boost::intrusive_ptr<Data> const& p)
+    {
+        p->start();
+        intrusive_ptr_add_ref(p.get());
+        return p.get();
     }
 
-    int set_lseek_promise_cb(void *cdat, int status)
+    inline void complete_read(void* cdat, int)
     {
-        boost::intrusive_ptr<lseek_data> p(
-                reinterpret_cast<lseek_data*>(cdat));
+        boost::intrusive_ptr<read_data> p(
+            static_cast<read_data*>(cdat), false);
+        p->finish(p->len_);
+        set_char_vector_value(p);
+    }
+
+    inline void complete_read_buffer(void* cdat, int)
+    {
+        boost::intrusive_ptr<read_buffer_data> p(
+            static_cast<read_buffer_data*>(cdat), false);
+        p->finish(p->len_);
+        set_buffer_value(p);
+    }
+
+    inline void complete_write(void* cdat, int)
+    {
+        boost::intrusive_ptr<write_data> p(
+            static_cast<write_data*>(cdat), false);
+        p->finish(p->len_);
+        set_ssize_t_value(p->p_, p->len_);
+    }
 
-        // create a unique thread name based on UTC clock
-        boost::posix_time::ptime now =
-            boost::posix_time::microsec_clock::universal_time();
-        std::string thread_name = std::string("pxfs_lseek_") +
-            boost::posix_time::to_iso_string(now);
+    inline void complete_lseek(void* cdat, int)
+    {
+        boost::intrusive_ptr<lseek_data> p(
+            static_cast<lseek_data*>(cdat), false);
+        p->finish(0);
+        set_off_t_value(p->p_, p->offset_);
+    }
 
-        // register this thread in order to be able to
-        // call HPX functionality
-        registration_wrapper wrap(p->rt_p_, thread_name.c_str());
+    inline void complete_stat(void* cdat, int status)
+    {
+        boost::intrusive_ptr<stat_data> p(
+            static_cast<stat_data*>(cdat), false);
+        p->finish(0);
+        p->p_.set_value(status < 0 ? file_status() : file_status(p->st_));
+    }
 
-        // Create an HPX thread to guarantee that the promise::set_value
-        // function can be invoked safely.
-        hpx::threads::register_thread(hpx::util::bind(
-                    &set_off_t_value,
-                    boost::ref(p->p_), p->offset_));
+    inline void complete_general(void* cdat, int status)
+    {
+        boost::intrusive_ptr<general_data> p(
+            static_cast<general_data*>(cdat), false);
+        p->finish(0);
+        set_int_value(p->p_, status);
+    }
 
+    // the callbacks run on pxfs threads, they only queue the completion
+    inline int set_read_promise_cb(void *cdat, int status)
+    {
+        completion_queue::get().push(static_cast<read_data*>(cdat)->rt_p_,
+            &complete_read, cdat, status);
         return status;
     }
 
-    int set_promise_cb(void *cdat, int status)
+    inline int set_read_buffer_promise_cb(void *cdat, int status)
     {
-        boost::intrusive_ptr<general_data> p(
-                reinterpret_cast<general_data*>(cdat));
+        completion_queue::get().push(
+            static_cast<read_buffer_data*>(cdat)->rt_p_,
+            &complete_read_buffer, cdat, status);
+        return status;
+    }
 
-        // create a unique thread name based on UTC clock
-        boost::posix_time::ptime now =
-            boost::posix_time::microsec_clock::universal_time();
-        std::string thread_name = std::string("pxfs_") +
-            boost::posix_time::to_iso_string(now);
+    inline int set_write_promise_cb(void *cdat, int status)
+    {
+        completion_queue::get().push(static_cast<write_data*>(cdat)->rt_p_,
+            &complete_write, cdat, status);
+        return status;
+    }
 
-        // register this thread in order to be able to
-        // call HPX functionality
-        registration_wrapper wrap(p->rt_p_, thread_name.c_str());
+    inline int set_lseek_promise_cb(void *cdat, int status)
+    {
+        completion_queue::get().push(static_cast<lseek_data*>(cdat)->rt_p_,
+            &complete_lseek, cdat, status);
+        return status;
+    }
 
-        // Create an HPX thread to guarantee that the promise::set_value
-        // function can be invoked safely.
-        hpx::threads::register_thread(hpx::util::bind(
-                    &set_int_value, boost::ref(p->p_), status));
+    inline int set_stat_promise_cb(void *cdat, int status)
+    {
+        completion_queue::get().push(static_cast<stat_data*>(cdat)->rt_p_,
+            &complete_stat, cdat, status);
+        return status;
+    }
 
+    inline int set_promise_cb(void *cdat, int status)
+    {
+        completion_queue::get().push(static_cast<general_data*>(cdat)->rt_p_,
+            &complete_general, cdat, status);
         return status;
     }
 
@@ -317,9 +516,12 @@ namespace hpx { namespace io
     class pxfs_file
     {
     private:
+        typedef hpx::lcos::local::spinlock mutex_type;
 
     public:
-        pxfs_file() : fd_(-1)
+        pxfs_file() : fd_(-1),
+            fsync_commit_(new server::group_commit),
+            fdatasync_commit_(new server::group_commit)
         {
             file_name_.clear();
             rt_p_ = hpx::get_runtime_ptr();
@@ -327,6 +529,7 @@ namespace hpx { namespace io
 
         ~pxfs_file()
         {
+            wait_for_syncs();
             close();
         }
 
@@ -337,19 +540,10 @@ namespace hpx { namespace io
 
         lcos::future<int> open(std::string const& name, int const flag)
         {
-            boost::intrusive_ptr<general_data> od_p(new general_data(rt_p_));
-            {
-                // Get a reference to one of the IO specific HPX io_service objects ...
-                hpx::threads::executors::io_pool_executor scheduler;
-
-                // ... and schedule the handler to run on one of its OS-threads.
-                scheduler.add(hpx::util::bind(&pxfs_file::open_work, this,
-                            boost::ref(name), flag, boost::ref(od_p)));
-
-                // Note that the destructor of the scheduler object will wait for
-                // the scheduled task to finish executing.
-            }
-            return od_p.detach()->get_future();
+            boost::intrusive_ptr<general_data> od_p =
+                make_request<general_data>(server::io_statistics::open);
+            open_work(name, flag, od_p);
+            return od_p->get_future();
         }
 
         void open_work(std::string const& name, int const flag,
@@ -363,11 +557,11 @@ namespace hpx { namespace io
             if (flag & O_CREAT)
             {
                 pxfs_open(file_name_.c_str(), flag, &fd_,
-                        &set_promise_cb, p.get(), 0644);
+                        &set_promise_cb, retain(p), 0644);
             } else
             {
                 pxfs_open(file_name_.c_str(), flag, &fd_,
-                        &set_promise_cb, p.get());
+                        &set_promise_cb, retain(p));
             }
         }
 
@@ -388,19 +582,10 @@ namespace hpx { namespace io
 
         lcos::future<int> close()
         {
-            boost::intrusive_ptr<general_data> gd_p(new general_data(rt_p_));
-            {
-                // Get a reference to one of the IO specific HPX io_service objects ...
-                hpx::threads::executors::io_pool_executor scheduler;
-
-                // ... and schedule the handler to run on one of its OS-threads.
-                scheduler.add(hpx::util::bind(&pxfs_file::close_work,
-                            this, boost::ref(gd_p)));
-
-                // Note that the destructor of the scheduler object will wait for
-                // the scheduled task to finish executing.
-            }
-            return gd_p.detach()->get_future();
+            boost::intrusive_ptr<general_data> gd_p =
+                make_request<general_data>(server::io_statistics::close);
+            close_work(gd_p);
+            return gd_p->get_future();
         }
 
         void close_work(boost::intrusive_ptr<general_data>& p)
@@ -408,7 +593,7 @@ namespace hpx { namespace io
             file_name_.clear();
             if (fd_ >= 0)
             {
-                pxfs_close(fd_, &set_promise_cb, p.get());
+                pxfs_close(fd_, &set_promise_cb, retain(p));
                 fd_ = -1;
             } else
             {
@@ -423,19 +608,16 @@ namespace hpx { namespace io
 
         lcos::future<int> remove_file(std::string const& file_name)
         {
-            boost::intrusive_ptr<general_data> gd_p(new general_data(rt_p_));
-            {
-                hpx::threads::executors::io_pool_executor scheduler;
-                scheduler.add(hpx::util::bind(&pxfs_file::remove_file_work,
-                            this, boost::ref(file_name), boost::ref(gd_p)));
-            }
-            return gd_p.detach()->get_future();
+            boost::intrusive_ptr<general_data> gd_p =
+                make_request<general_data>(server::io_statistics::metadata);
+            remove_file_work(file_name, gd_p);
+            return gd_p->get_future();
         }
 
         void remove_file_work(std::string const& file_name,
                 boost::intrusive_ptr<general_data>& p)
         {
-            pxfs_unlink(file_name.c_str(), &set_promise_cb, p.get());
+            pxfs_unlink(file_name.c_str(), &set_promise_cb, retain(p));
         }
 
         std::vector<char> read_sync(size_t const count)
@@ -445,13 +627,10 @@ namespace hpx { namespace io
 
         lcos::future<std::vector<char> > read(size_t const count)
         {
-            boost::intrusive_ptr<read_data> rd_p(new read_data(rt_p_));
-            {
-                hpx::threads::executors::io_pool_executor scheduler;
-                scheduler.add(hpx::util::bind(&pxfs_file::read_work,
-                            this, count, rd_p));
-            }
-            return rd_p.detach()->get_future();
+            boost::intrusive_ptr<read_data> rd_p(make_request<read_data>(
+                server::io_statistics::read));
+            read_work(count, rd_p);
+            return rd_p->get_future();
         }
 
         void read_work(size_t const count,
@@ -464,9 +643,8 @@ namespace hpx { namespace io
                 return;
             }
 
-            p->buf_.assign(count, 0);
-            pxfs_read(fd_, p->buf_.data(), count, &p->len_,
-                    &set_read_promise_cb, p.get());
+            pxfs_read(fd_, p->acquire_buffer(count), count, &p->len_,
+                    &set_read_promise_cb, retain(p));
         }
 
         std::vector<char> pread_sync(size_t const count, off_t const offset)
@@ -477,13 +655,10 @@ namespace hpx { namespace io
         lcos::future<std::vector<char> > pread(ssize_t const count,
                 off_t const offset)
         {
-            boost::intrusive_ptr<read_data> rd_p(new read_data(rt_p_));
-            {
-                hpx::threads::executors::io_pool_executor scheduler;
-                scheduler.add(hpx::util::bind(&pxfs_file::pread_work,
-                            this, count, offset, rd_p));
-            }
-            return rd_p.detach()->get_future();
+            boost::intrusive_ptr<read_data> rd_p(make_request<read_data>(
+                server::io_statistics::pread));
+            pread_work(count, offset, rd_p);
+            return rd_p->get_future();
         }
 
         void pread_work(size_t const count, off_t const offset,
@@ -496,32 +671,136 @@ namespace hpx { namespace io
                 return;
             }
 
-            p->buf_.assign(count, 0);
-            pxfs_pread(fd_, p->buf_.data(), count, offset,
+            pxfs_pread(fd_, p->acquire_buffer(count), count, offset,
                     &p->len_,
-                    &set_read_promise_cb, p.get());
+                    &set_read_promise_cb, retain(p));
         }
 
-        ssize_t write_sync(std::vector<char> const& buf)
+        // The buffer returned by read_buffer and pread_buffer is filled by
+        // pxfs directly and goes back to the buffer_pool once the caller
+        // releases it, no copy is made on the way.
+        buffer_type read_buffer_sync(size_t const count)
         {
-            return write(buf).get();
+            return read_buffer(count).get();
         }
 
-        lcos::future<ssize_t> write(std::vector<char> const& buf)
+        lcos::future<buffer_type> read_buffer(size_t const count)
+        {
+            boost::intrusive_ptr<read_buffer_data> rd_p =
+                make_request<read_buffer_data>(server::io_statistics::read);
+            read_buffer_work(count, rd_p);
+            return rd_p->get_future();
+        }
+
+        void read_buffer_work(size_t const count,
+                boost::intrusive_ptr<read_buffer_data> p)
         {
-            boost::intrusive_ptr<write_data> wd_p(new write_data(rt_p_));
+            if (fd_ < 0 || count <= 0)
             {
-                // Get a reference to one of the IO specific HPX io_service objects ...
-                hpx::threads::executors::io_pool_executor scheduler;
+                p->p_.set_value(buffer_type());
+                return;
+            }
+
+            pxfs_read(fd_, p->acquire_buffer(count), count, &p->len_,
+                    &set_read_buffer_promise_cb, retain(p));
+        }
+
+        buffer_type pread_buffer_sync(size_t const count, off_t const offset)
+        {
+            return pread_buffer(count, offset).get();
+        }
+
+        lcos::future<buffer_type> pread_buffer(size_t const count,
+                off_t const offset)
+        {
+            boost::intrusive_ptr<read_buffer_data> rd_p =
+                make_request<read_buffer_data>(server::io_statistics::pread);
+            pread_buffer_work(count, offset, rd_p);
+            return rd_p->get_future();
+        }
+
+        void pread_buffer_work(size_t const count, off_t const offset,
+                boost::intrusive_ptr<read_buffer_data> p)
+        {
+            if (fd_ < 0 || count <= 0 || offset < 0)
+            {
+                p->p_.set_value(buffer_type());
+                return;
+            }
+
+            pxfs_pread(fd_, p->acquire_buffer(count), count, offset,
+                    &p->len_,
+                    &set_read_buffer_promise_cb, retain(p));
+        }
+
+        // Read into memory owned by the caller, which has to stay valid until
+        // the returned future becomes ready. pxfs fills buf directly, the
+        // future returns the number of bytes read.
+        ssize_t read_sync(char* buf, size_t const count)
+        {
+            return read(buf, count).get();
+        }
+
+        lcos::future<ssize_t> read(char* buf, size_t const count)
+        {
+            // write_data just carries a length, it serves reads as well
+            boost::intrusive_ptr<write_data> rd_p(make_request<write_data>(
+                server::io_statistics::read));
+            read_into_work(buf, count, rd_p);
+            return rd_p->get_future();
+        }
+
+        void read_into_work(char* buf, size_t const count,
+                boost::intrusive_ptr<write_data> p)
+        {
+            if (fd_ < 0 || count <= 0)
+            {
+                p->p_.set_value(0);
+                return;
+            }
+
+            pxfs_read(fd_, buf, count, &p->len_,
+                    &set_write_promise_cb, retain(p));
+        }
+
+        ssize_t pread_sync(char* buf, size_t const count, off_t const offset)
+        {
+            return pread(buf, count, offset).get();
+        }
 
-                // ... and schedule the handler to run on one of its OS-threads.
-                scheduler.add(hpx::util::bind(&pxfs_file::write_work,
-                            this, boost::ref(buf), wd_p));
+        lcos::future<ssize_t> pread(char* buf, size_t const count,
+                off_t const offset)
+        {
+            boost::intrusive_ptr<write_data> rd_p(make_request<write_data>(
+                server::io_statistics::pread));
+            pread_into_work(buf, count, offset, rd_p);
+            return rd_p->get_future();
+        }
 
-                // Note that the destructor of the scheduler object will wait for
-                // the scheduled task to finish executing.
+        void pread_into_work(char* buf, size_t const count,
+                off_t const offset, boost::intrusive_ptr<write_data> p)
+        {
+            if (fd_ < 0 || count <= 0 || offset < 0)
+            {
+                p->p_.set_value(0);
+                return;
             }
-            return wd_p.detach()->get_future();
+
+            pxfs_pread(fd_, buf, count, offset, &p->len_,
+                    &set_write_promise_cb, retain(p));
+        }
+
+        ssize_t write_sync(std::vector<char> const& buf)
+        {
+            return write(buf).get();
+        }
+
+        lcos::future<ssize_t> write(std::vector<char> const& buf)
+        {
+            boost::intrusive_ptr<write_data> wd_p(make_request<write_data>(
+                server::io_statistics::write));
+            write_work(buf, wd_p);
+            return wd_p->get_future();
         }
 
         void write_work(std::vector<char> const& buf,
@@ -533,7 +812,7 @@ namespace hpx { namespace io
                 return;
             }
             pxfs_write(fd_, buf.data(), buf.size(), &p->len_,
-                    &set_write_promise_cb, p.get());
+                    &set_write_promise_cb, retain(p));
         }
 
         ssize_t pwrite_sync(std::vector<char> const& buf, off_t const offset)
@@ -545,19 +824,10 @@ namespace hpx { namespace io
         lcos::future<ssize_t> pwrite(std::vector<char> const& buf,
                 off_t const offset)
         {
-            boost::intrusive_ptr<write_data> wd_p(new write_data(rt_p_));
-            {
-                // Get a reference to one of the IO specific HPX io_service objects ...
-                hpx::threads::executors::io_pool_executor scheduler;
-
-                // ... and schedule the handler to run on one of its OS-threads.
-                scheduler.add(hpx::util::bind(&pxfs_file::pwrite_work,
-                            this, boost::ref(buf), offset, wd_p));
-
-                // Note that the destructor of the scheduler object will wait for
-                // the scheduled task to finish executing.
-            }
-            return wd_p.detach()->get_future();
+            boost::intrusive_ptr<write_data> wd_p(make_request<write_data>(
+                server::io_statistics::pwrite));
+            pwrite_work(buf, offset, wd_p);
+            return wd_p->get_future();
         }
 
         void pwrite_work(std::vector<char> const& buf, off_t const offset,
@@ -569,29 +839,169 @@ namespace hpx { namespace io
                 return;
             }
             pxfs_pwrite(fd_, buf.data(), buf.size(), offset, &p->len_,
-                    &set_write_promise_cb, p.get());
+                    &set_write_promise_cb, retain(p));
         }
 
-        off_t lseek_sync(off_t const offset, int const whence)
+        // Write from memory owned by the caller, which has to stay valid
+        // until the returned future becomes ready.
+        ssize_t pwrite_sync(char const* buf, size_t const count,
+                off_t const offset)
         {
-            return lseek(offset, whence).get();
+            return pwrite(buf, count, offset).get();
         }
 
-        lcos::future<off_t> lseek(off_t const offset, int const whence)
+        lcos::future<ssize_t> pwrite(char const* buf, size_t const count,
+                off_t const offset)
+        {
+            boost::intrusive_ptr<write_data> wd_p(make_request<write_data>(
+                server::io_statistics::pwrite));
+            pwrite_from_work(buf, count, offset, wd_p);
+            return wd_p->get_future();
+        }
+
+        void pwrite_from_work(char const* buf, size_t const count,
+                off_t const offset, boost::intrusive_ptr<write_data> p)
+        {
+            if (fd_ < 0 || count <= 0 || offset < 0)
+            {
+                p->p_.set_value(0);
+                return;
+            }
+            pxfs_pwrite(fd_, buf, count, offset, &p->len_,
+                    &set_write_promise_cb, retain(p));
+        }
+
+        // Vectored positional I/O: one pxfs request per extent is issued
+        // right away and a single future completes once all of them are
+        // done. The data of the extents is concatenated in list order, a
+        // short transfer of one extent ends the result.
+        std::vector<char> preadv_sync(std::vector<extent> const& extents)
+        {
+            return preadv(extents).get();
+        }
+
+        lcos::future<std::vector<char> > preadv(
+                std::vector<extent> const& extents)
         {
-            boost::intrusive_ptr<lseek_data> ld_p(new lseek_data(rt_p_));
+            boost::shared_ptr<std::vector<char> > buf(
+                new std::vector<char>(total_count(extents)));
+
+            std::vector<lcos::future<ssize_t> > lazy_results;
+            lazy_results.reserve(extents.size());
+
+            size_t pos = 0;
+            for (size_t i = 0; i != extents.size(); ++i)
             {
-                // Get a reference to one of the IO specific HPX io_service objects ...
-                hpx::threads::executors::io_pool_executor scheduler;
+                lazy_results.push_back(pread(buf->data() + pos,
+                    extents[i].count, extents[i].offset));
+                pos += extents[i].count;
+            }
+
+            return hpx::when_all(lazy_results).then(
+                [extents, buf](
+                    lcos::future<std::vector<lcos::future<ssize_t> > > f)
+                {
+                    std::vector<lcos::future<ssize_t> > r = f.get();
+                    buf->resize(sum_transfers(extents, r));
+                    return std::move(*buf);
+                });
+        }
 
-                // ... and schedule the handler to run on one of its OS-threads.
-                scheduler.add(hpx::util::bind(&pxfs_file::lseek_work,
-                            this, offset, whence, ld_p));
+        ssize_t pwritev_sync(std::vector<extent> const& extents,
+                std::vector<char> const& buf)
+        {
+            return pwritev(extents, buf).get();
+        }
+
+        lcos::future<ssize_t> pwritev(std::vector<extent> const& extents,
+                std::vector<char> const& buf)
+        {
+            if (buf.empty() || total_count(extents) != buf.size())
+            {
+                return hpx::make_ready_future(ssize_t(0));
+            }
+
+            std::vector<lcos::future<ssize_t> > lazy_results;
+            lazy_results.reserve(extents.size());
+
+            size_t pos = 0;
+            for (size_t i = 0; i != extents.size(); ++i)
+            {
+                lazy_results.push_back(pwrite(buf.data() + pos,
+                    extents[i].count, extents[i].offset));
+                pos += extents[i].count;
+            }
+
+            return hpx::when_all(lazy_results).then(
+                [extents](
+                    lcos::future<std::vector<lcos::future<ssize_t> > > f)
+                {
+                    std::vector<lcos::future<ssize_t> > r = f.get();
+                    return sum_transfers(extents, r);
+                });
+        }
+
+        // writes are not staged on this side, there is nothing to flush
+        int flush_sync()
+        {
+            return flush().get();
+        }
+
+        lcos::future<int> flush()
+        {
+            return hpx::make_ready_future(0);
+        }
+
+        // force the file to stable storage, the future returns 0 on success
+        int fsync_sync()
+        {
+            return fsync().get();
+        }
+
+        lcos::future<int> fsync()
+        {
+            return sync_file(fsync_commit_, false);
+        }
+
+        int fdatasync_sync()
+        {
+            return fdatasync().get();
+        }
+
+        lcos::future<int> fdatasync()
+        {
+            return sync_file(fdatasync_commit_, true);
+        }
+
+        void sync_work(bool const datasync,
+                boost::intrusive_ptr<general_data> p)
+        {
+            if (fd_ < 0)
+            {
+                p->p_.set_value(-1);
+                return;
+            }
 
-                // Note that the destructor of the scheduler object will wait for
-                // the scheduled task to finish executing.
+            if (datasync)
+            {
+                pxfs_fdatasync(fd_, &set_promise_cb, retain(p));
+            } else
+            {
+                pxfs_fsync(fd_, &set_promise_cb, retain(p));
             }
-            return ld_p.detach()->get_future();
+        }
+
+        off_t lseek_sync(off_t const offset, int const whence)
+        {
+            return lseek(offset, whence).get();
+        }
+
+        lcos::future<off_t> lseek(off_t const offset, int const whence)
+        {
+            boost::intrusive_ptr<lseek_data> ld_p(make_request<lseek_data>(
+                server::io_statistics::lseek));
+            lseek_work(offset, whence, ld_p);
+            return ld_p->get_future();
         }
 
         void lseek_work(off_t const offset, int const whence,
@@ -603,16 +1013,214 @@ namespace hpx { namespace io
                 return;
             }
             pxfs_lseek(fd_, offset, whence, &p->offset_,
-                    &set_lseek_promise_cb, p.get());
+                    &set_lseek_promise_cb, retain(p));
+        }
+
+        // Metadata operations on arbitrary paths through the asynchronous
+        // pxfs calls, the int results are the pxfs status.
+        file_status stat_sync(std::string const& path)
+        {
+            return stat(path).get();
+        }
+
+        lcos::future<file_status> stat(std::string const& path)
+        {
+            boost::intrusive_ptr<stat_data> sd_p(make_request<stat_data>(
+                server::io_statistics::metadata));
+            pxfs_stat(path.c_str(), &sd_p->st_, &set_stat_promise_cb,
+                    retain(sd_p));
+            return sd_p->get_future();
+        }
+
+        int mkdir_sync(std::string const& path, int const mode = 0755)
+        {
+            return mkdir(path, mode).get();
+        }
+
+        lcos::future<int> mkdir(std::string const& path, int const mode = 0755)
+        {
+            boost::intrusive_ptr<general_data> gd_p =
+                make_request<general_data>(server::io_statistics::metadata);
+            pxfs_mkdir(path.c_str(), mode, &set_promise_cb, retain(gd_p));
+            return gd_p->get_future();
+        }
+
+        int rmdir_sync(std::string const& path)
+        {
+            return rmdir(path).get();
+        }
+
+        lcos::future<int> rmdir(std::string const& path)
+        {
+            boost::intrusive_ptr<general_data> gd_p =
+                make_request<general_data>(server::io_statistics::metadata);
+            pxfs_rmdir(path.c_str(), &set_promise_cb, retain(gd_p));
+            return gd_p->get_future();
+        }
+
+        int rename_sync(std::string const& from, std::string const& to)
+        {
+            return rename(from, to).get();
+        }
+
+        lcos::future<int> rename(std::string const& from,
+                std::string const& to)
+        {
+            boost::intrusive_ptr<general_data> gd_p =
+                make_request<general_data>(server::io_statistics::metadata);
+            pxfs_rename(from.c_str(), to.c_str(), &set_promise_cb,
+                    retain(gd_p));
+            return gd_p->get_future();
+        }
+
+        int truncate_sync(std::string const& path, off_t const length)
+        {
+            return truncate(path, length).get();
+        }
+
+        lcos::future<int> truncate(std::string const& path,
+                off_t const length)
+        {
+            boost::intrusive_ptr<general_data> gd_p =
+                make_request<general_data>(server::io_statistics::metadata);
+            pxfs_truncate(path.c_str(), length, &set_promise_cb,
+                    retain(gd_p));
+            return gd_p->get_future();
         }
 
       private:
+        // request control blocks are recycled through the request_pool,
+        // op is what the request is accounted for in io_statistics
+        template <typename Data>
+        boost::intrusive_ptr<Data> make_request(
+            server::io_statistics::operation op) const
+        {
+            boost::intrusive_ptr<Data> p(request_pool<Data>::create(rt_p_));
+            p->stats_ = &statistics();
+            p->op_ = op;
+            return p;
+        }
+
+        static server::io_statistics& statistics()
+        {
+            static server::io_statistics& stats =
+                server::io_statistics::get("pxfs_file");
+            return stats;
+        }
+
+        lcos::future<int> sync_direct(bool const datasync)
+        {
+            boost::intrusive_ptr<general_data> gd_p =
+                make_request<general_data>(datasync ?
+                    server::io_statistics::fdatasync :
+                    server::io_statistics::fsync);
+            sync_work(datasync, gd_p);
+            return gd_p->get_future();
+        }
+
+        // with group commit a separate HPX thread waits for its batch, the
+        // destructor waits for all of them as they use the file
+        lcos::future<int> sync_file(
+            boost::shared_ptr<server::group_commit> const& commit,
+            bool const datasync)
+        {
+            if (!commit->enabled())
+            {
+                return sync_direct(datasync);
+            }
+
+            hpx::shared_future<int> f = hpx::async(
+                [this, commit, datasync]() -> int
+                {
+                    return commit->run(
+                        [this, datasync]()
+                        {
+                            return sync_direct(datasync).get();
+                        });
+                });
+
+            {
+                mutex_type::scoped_lock l(syncs_mtx_);
+
+                // forget about the syncs which are done already
+                std::vector<hpx::shared_future<int> >::iterator it =
+                    syncs_.begin();
+                while (it != syncs_.end())
+                {
+                    if (it->is_ready())
+                    {
+                        it = syncs_.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+                syncs_.push_back(f);
+            }
+
+            return f.then(
+                [](hpx::shared_future<int> r) -> int
+                {
+                    return r.get();
+                });
+        }
+
+        void wait_for_syncs()
+        {
+            std::vector<hpx::shared_future<int> > syncs;
+            {
+                mutex_type::scoped_lock l(syncs_mtx_);
+                syncs.swap(syncs_);
+            }
+            for (std::size_t i = 0; i != syncs.size(); ++i)
+            {
+                syncs[i].wait();
+            }
+
+            fsync_commit_->wait();
+            fdatasync_commit_->wait();
+        }
+
+        static ssize_t sum_transfers(std::vector<extent> const& extents,
+            std::vector<lcos::future<ssize_t> >& lazy_results)
+        {
+            size_t done = 0;
+            for (size_t i = 0; i != lazy_results.size(); ++i)
+            {
+                ssize_t len = lazy_results[i].get();
+                if (len > 0)
+                {
+                    done += len;
+                }
+                if (len < static_cast<ssize_t>(extents[i].count))
+                {
+                    break;
+                }
+            }
+            return done;
+        }
+
         // PVFS2TAB_FILE env need to be set in the shell
         int fd_;
         std::string file_name_;
         hpx::runtime *rt_p_;
+
+        boost::shared_ptr<server::group_commit> fsync_commit_;
+        boost::shared_ptr<server::group_commit> fdatasync_commit_;
+
+        mutex_type syncs_mtx_;
+        std::vector<hpx::shared_future<int> > syncs_;
     };
 
+    ///////////////////////////////////////////////////////////////////////////
+    // pxfs_file lives in the application, which has to install its counters
+    // on startup: hpx::register_startup_function(&register_pxfs_counters)
+    inline void register_pxfs_counters()
+    {
+        server::register_counters("pxfs_file");
+    }
+
 }} // hpx::io
 
 
@@ -0,0 +1,235 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_REQUEST_POOL_HPP_JUN_22_2015_0940AM)
+#define HPX_COMPONENTS_IO_REQUEST_POOL_HPP_JUN_22_2015_0940AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/runtime/get_config_entry.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/lockfree/stack.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // The pools below are shared by all threads and keep their free storage
+    // on lock-free stacks. Requests completed through the completion_queue
+    // are released by the thread draining the queue, their storage is
+    // available to every thread issuing requests right away.
+    //
+    // The pools are sized through the ini entries
+    //
+    //     hpxio.pool.requests      request objects kept per type
+    //                              (default: 256)
+    //     hpxio.pool.buffer_bytes  bytes of read buffers kept (default: 64M)
+    //
+    // Everything left in a pool is released on exit.
+    namespace detail
+    {
+        inline std::size_t pool_config_entry(char const* key,
+            char const* default_value)
+        {
+            return boost::lexical_cast<std::size_t>(
+                hpx::get_config_entry(key, default_value));
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Storage for request control blocks of type T. create() constructs an
+    // object in recycled storage, destroy() runs its destructor and keeps
+    // the storage for the next request.
+    template <typename T>
+    class request_pool : boost::noncopyable
+    {
+      private:
+        // the nodes of the stack are allocated up front, a push fails once
+        // max_cached items are kept
+        struct free_list
+        {
+            free_list()
+              : items_(detail::pool_config_entry("hpxio.pool.requests", "256"))
+            {}
+
+            ~free_list()
+            {
+                void* mem = 0;
+                while (items_.pop(mem))
+                {
+                    ::operator delete(mem);
+                }
+            }
+
+            boost::lockfree::stack<void*> items_;
+        };
+
+        static free_list& get()
+        {
+            static free_list list;
+            return list;
+        }
+
+      public:
+        template <typename Arg>
+        static T* create(Arg const& arg)
+        {
+            void* mem = 0;
+            if (!get().items_.pop(mem))
+            {
+                mem = ::operator new(sizeof(T));
+            }
+
+            try {
+                return new (mem) T(arg);
+            }
+            catch (...) {
+                recycle(mem);
+                throw;
+            }
+        }
+
+        static void destroy(T* p)
+        {
+            p->~T();
+            recycle(p);
+        }
+
+      private:
+        static void recycle(void* mem)
+        {
+            if (!get().items_.bounded_push(mem))
+            {
+                ::operator delete(mem);
+            }
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Uninitialized read buffers in power of two size classes from 4k up to
+    // 64M, larger requests are served by plain new[] and are not kept.
+    class buffer_pool : boost::noncopyable
+    {
+      private:
+        static std::size_t const min_class = 12;
+        static std::size_t const max_class = 26;
+        static std::size_t const class_count = max_class - min_class + 1;
+
+        typedef boost::lockfree::stack<char*> stack_type;
+
+        struct free_list
+        {
+            free_list()
+              : max_bytes_(detail::pool_config_entry(
+                    "hpxio.pool.buffer_bytes", "67108864")),
+                bytes_(0)
+            {
+                // every class may use up the whole budget on its own
+                for (std::size_t c = 0; c != class_count; ++c)
+                {
+                    std::size_t const size = std::size_t(1) << (c + min_class);
+                    items_[c] = new stack_type(
+                        (std::max)(max_bytes_ / size, std::size_t(1)));
+                }
+            }
+
+            ~free_list()
+            {
+                for (std::size_t c = 0; c != class_count; ++c)
+                {
+                    char* p = 0;
+                    while (items_[c]->pop(p))
+                    {
+                        delete [] p;
+                    }
+                    delete items_[c];
+                }
+            }
+
+            std::size_t const max_bytes_;
+            boost::atomic<std::size_t> bytes_;
+            stack_type* items_[class_count];
+        };
+
+        static free_list& get()
+        {
+            static free_list list;
+            return list;
+        }
+
+        static std::size_t size_class(std::size_t count)
+        {
+            std::size_t c = min_class;
+            while (c <= max_class && (std::size_t(1) << c) < count)
+            {
+                ++c;
+            }
+            return c;
+        }
+
+      public:
+        // the number of bytes actually reserved for a request of count bytes,
+        // this has to be handed back to deallocate()
+        static std::size_t capacity(std::size_t count)
+        {
+            std::size_t const c = size_class(count);
+            return (c > max_class) ? count : (std::size_t(1) << c);
+        }
+
+        static char* allocate(std::size_t capacity)
+        {
+            std::size_t const c = size_class(capacity);
+            if (c <= max_class)
+            {
+                free_list& l = get();
+                char* p = 0;
+                if (l.items_[c - min_class]->pop(p))
+                {
+                    l.bytes_ -= capacity;
+                    return p;
+                }
+            }
+            return new char[capacity];
+        }
+
+        static void deallocate(char* p, std::size_t capacity)
+        {
+            std::size_t const c = size_class(capacity);
+            if (c <= max_class)
+            {
+                free_list& l = get();
+                if (l.bytes_.fetch_add(capacity) + capacity <= l.max_bytes_ &&
+                    l.items_[c - min_class]->bounded_push(p))
+                {
+                    return;
+                }
+                l.bytes_ -= capacity;
+            }
+            delete [] p;
+        }
+
+        // deleter handing a buffer back to the pool
+        struct deleter
+        {
+            explicit deleter(std::size_t capacity) : capacity_(capacity) {}
+
+            void operator()(char* p) const
+            {
+                buffer_pool::deallocate(p, capacity_);
+            }
+
+            std::size_t capacity_;
+        };
+    };
+
+}} // hpx::io
+
+#endif
@@ -0,0 +1,81 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_ALIGNED_BUFFER_HPP_JUL_03_2015_0900AM)
+#define HPX_COMPONENTS_IO_SERVER_ALIGNED_BUFFER_HPP_JUL_03_2015_0900AM
+
+#include <boost/noncopyable.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Memory aligned to a power of two as required for O_DIRECT transfers.
+    // An allocation failure leaves the buffer empty.
+    class aligned_buffer : boost::noncopyable
+    {
+      public:
+        aligned_buffer(std::size_t size, std::size_t alignment)
+          : data_(allocate(size, alignment)), size_(data_ ? size : 0)
+        {}
+
+        ~aligned_buffer()
+        {
+            std::free(data_);
+        }
+
+        char* data() const
+        {
+            return data_;
+        }
+
+        std::size_t size() const
+        {
+            return size_;
+        }
+
+        // hand the memory over, it has to be released through deleter
+        char* release()
+        {
+            char* p = data_;
+            data_ = 0;
+            size_ = 0;
+            return p;
+        }
+
+        static char* allocate(std::size_t size, std::size_t alignment)
+        {
+            void* p = 0;
+            if (size == 0 || ::posix_memalign(&p, alignment, size) != 0)
+            {
+                return 0;
+            }
+            return static_cast<char*>(p);
+        }
+
+        struct deleter
+        {
+            void operator()(char* p) const
+            {
+                std::free(p);
+            }
+        };
+
+        static bool is_aligned(void const* p, std::size_t alignment)
+        {
+            return reinterpret_cast<std::size_t>(p) % alignment == 0;
+        }
+
+      private:
+        char* data_;
+        std::size_t size_;
+    };
+
+}}} // hpx::io::server
+
+#endif
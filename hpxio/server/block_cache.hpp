@@ -0,0 +1,456 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_BLOCK_CACHE_HPP_JUN_10_2015_1140AM)
+#define HPX_COMPONENTS_IO_SERVER_BLOCK_CACHE_HPP_JUN_10_2015_1140AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/config/export_definitions.hpp>
+#include <hpx/include/performance_counters.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/runtime/get_config_entry.hpp>
+#include <hpx/util/bind.hpp>
+#include <hpxio/server/io_statistics.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Per-locality cache of fixed size file blocks sitting beneath read and
+    // pread of the file components. Blocks are identified by file name and
+    // block number and evicted in LRU order. A miss on a sequential stream
+    // (the block right after the last one read from that file) fetches the
+    // following read_ahead blocks with the same request.
+    //
+    // The cache is configured through the ini entries
+    //
+    //     hpxio.cache.enabled     1 to enable the cache (default: 0)
+    //     hpxio.cache.block_size  size of a block in bytes (default: 64k)
+    //     hpxio.cache.capacity    number of blocks kept (default: 1024)
+    //     hpxio.cache.read_ahead  blocks fetched ahead (default: 4)
+    //
+    // Requests covering more than a quarter of the blocks (at least one)
+    // bypass the cache.
+    //
+    // Writes going through the components invalidate the affected blocks
+    // through a write_scope, modifications made behind the back of the
+    // components are not seen. get() hands out the same instance to every
+    // module of the process, so a client reading through the direct path
+    // sees the invalidations of writes arriving through actions.
+    class HPX_COMPONENT_EXPORT block_cache : boost::noncopyable
+    {
+      private:
+        typedef hpx::lcos::local::spinlock mutex_type;
+
+        typedef std::vector<char> block_type;
+        typedef boost::shared_ptr<block_type const> block_ptr;
+
+        typedef std::pair<std::string, off_t> key_type;
+        typedef std::pair<key_type, block_ptr> entry_type;
+        typedef std::list<entry_type> lru_list_type;
+        typedef boost::unordered_map<
+                key_type, lru_list_type::iterator, boost::hash<key_type>
+            > index_type;
+
+      public:
+        block_cache()
+          : enabled_(false), block_size_(65536), capacity_(1024),
+            read_ahead_(4), generation_(0), hits_(0), misses_(0),
+            read_ahead_blocks_(0)
+        {
+            enabled_ = hpx::get_config_entry("hpxio.cache.enabled", "0") == "1";
+            block_size_ = (std::max)(size_t(1),
+                boost::lexical_cast<size_t>(hpx::get_config_entry(
+                    "hpxio.cache.block_size", "65536")));
+            capacity_ = (std::max)(size_t(1),
+                boost::lexical_cast<size_t>(hpx::get_config_entry(
+                    "hpxio.cache.capacity", "1024")));
+            read_ahead_ = boost::lexical_cast<size_t>(hpx::get_config_entry(
+                    "hpxio.cache.read_ahead", "4"));
+        }
+
+        static block_cache& get();
+
+        bool enabled() const
+        {
+            return enabled_;
+        }
+
+        // Read count bytes at offset from the given file into buf. Missing
+        // blocks are fetched by calling fetch(char* buf, size_t count,
+        // off_t offset) which has to return the number of bytes read.
+        template <typename F>
+        ssize_t read(std::string const& name, char* buf, size_t count,
+            off_t offset, F const& fetch)
+        {
+            if (count == 0 || offset < 0)
+            {
+                return 0;
+            }
+
+            off_t const bs = block_size_;
+            off_t const first = offset / bs;
+            off_t const last = (offset + count - 1) / bs;
+
+            // requests larger than a quarter of the cache would only flush it
+            if (size_t(last - first + 1) > (std::max)(size_t(1), capacity_ / 4))
+            {
+                return fetch(buf, count, offset);
+            }
+
+            bool sequential = is_sequential(name, first);
+
+            size_t done = 0;
+            for (off_t b = first; b <= last; ++b)
+            {
+                block_ptr blk = lookup(name, b);
+                if (!blk)
+                {
+                    size_t blocks = sequential ? read_ahead_ + 1 : 1;
+                    blk = fill(name, b, blocks, fetch);
+                    if (!blk)
+                    {
+                        break;
+                    }
+                    sequential = false;
+                }
+
+                size_t start = (b == first) ? size_t(offset - b * bs) : 0;
+                if (blk->size() <= start)
+                {
+                    break;
+                }
+
+                size_t len = (std::min)(blk->size() - start, count - done);
+                std::memcpy(buf + done, blk->data() + start, len);
+                done += len;
+
+                // a partial block marks the end of the file
+                if (blk->size() < size_t(bs))
+                {
+                    break;
+                }
+            }
+
+            mutex_type::scoped_lock l(mtx_);
+            last_block_[name] = last;
+
+            // the read positions of files not read any more are forgotten
+            if (last_block_.size() > capacity_)
+            {
+                last_block_.erase(last_block_.begin());
+            }
+            return done;
+        }
+
+        // drop all cached blocks overlapping the given range
+        void invalidate(std::string const& name, off_t offset, size_t count)
+        {
+            if (!enabled_ || count == 0)
+            {
+                return;
+            }
+
+            off_t const first = offset / off_t(block_size_);
+            off_t const last = (offset + count - 1) / off_t(block_size_);
+
+            mutex_type::scoped_lock l(mtx_);
+            ++generation_;
+            for (off_t b = first; b <= last; ++b)
+            {
+                erase_locked(key_type(name, b));
+            }
+
+            // a write behind the cached end of the file makes it grow, the
+            // short block at the old end is not the end any more
+            boost::unordered_map<std::string, off_t>::iterator eof =
+                eof_block_.find(name);
+            if (eof != eof_block_.end() && eof->second < first)
+            {
+                erase_locked(key_type(name, eof->second));
+            }
+        }
+
+        // drop all cached blocks of a file
+        void invalidate(std::string const& name)
+        {
+            if (!enabled_)
+            {
+                return;
+            }
+
+            mutex_type::scoped_lock l(mtx_);
+            ++generation_;
+            for (lru_list_type::iterator it = lru_.begin(); it != lru_.end();
+                 /**/)
+            {
+                if (it->first.first == name)
+                {
+                    index_.erase(it->first);
+                    it = lru_.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            last_block_.erase(name);
+            eof_block_.erase(name);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Invalidates the ranges of a file written to, when the write starts
+        // and again once it is done. A read filling a block from the old
+        // contents while the write is in flight would otherwise leave a
+        // stale block behind with nothing to evict it.
+        class write_scope : boost::noncopyable
+        {
+          public:
+            explicit write_scope(std::string const& name)
+              : name_(name), whole_file_(false)
+            {}
+
+            write_scope(std::string const& name, off_t offset, size_t count)
+              : name_(name), whole_file_(false)
+            {
+                add(offset, count);
+            }
+
+            ~write_scope()
+            {
+                block_cache& cache = block_cache::get();
+                if (whole_file_)
+                {
+                    cache.invalidate(name_);
+                    return;
+                }
+                for (std::size_t i = 0; i != ranges_.size(); ++i)
+                {
+                    cache.invalidate(name_, ranges_[i].first,
+                        ranges_[i].second);
+                }
+            }
+
+            void add(off_t offset, size_t count)
+            {
+                block_cache& cache = block_cache::get();
+                if (cache.enabled() && !whole_file_ && offset >= 0)
+                {
+                    cache.invalidate(name_, offset, count);
+                    ranges_.push_back(std::make_pair(offset, count));
+                }
+            }
+
+            // the position written to is not known
+            void add_file()
+            {
+                block_cache& cache = block_cache::get();
+                if (cache.enabled())
+                {
+                    cache.invalidate(name_);
+                    whole_file_ = true;
+                }
+            }
+
+          private:
+            std::string const name_;
+            bool whole_file_;
+            std::vector<std::pair<off_t, size_t> > ranges_;
+        };
+
+        boost::uint64_t hits() const
+        {
+            return hits_;
+        }
+
+        boost::uint64_t misses() const
+        {
+            return misses_;
+        }
+
+        boost::uint64_t read_ahead_blocks() const
+        {
+            return read_ahead_blocks_;
+        }
+
+      private:
+        friend void register_cache_counters();
+
+        // remove a block, the lock is held
+        void erase_locked(key_type const& key)
+        {
+            index_type::iterator it = index_.find(key);
+            if (it == index_.end())
+            {
+                return;
+            }
+
+            lru_.erase(it->second);
+            index_.erase(it);
+
+            boost::unordered_map<std::string, off_t>::iterator eof =
+                eof_block_.find(key.first);
+            if (eof != eof_block_.end() && eof->second == key.second)
+            {
+                eof_block_.erase(eof);
+            }
+        }
+
+        bool is_sequential(std::string const& name, off_t block)
+        {
+            mutex_type::scoped_lock l(mtx_);
+            boost::unordered_map<std::string, off_t>::const_iterator it =
+                last_block_.find(name);
+            return it != last_block_.end() &&
+                (it->second == block || it->second + 1 == block);
+        }
+
+        block_ptr lookup(std::string const& name, off_t block)
+        {
+            mutex_type::scoped_lock l(mtx_);
+            index_type::iterator it = index_.find(key_type(name, block));
+            if (it == index_.end())
+            {
+                ++misses_;
+                return block_ptr();
+            }
+
+            ++hits_;
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->second;
+        }
+
+        // fetch count blocks starting at first with a single request, insert
+        // them and return the first one
+        template <typename F>
+        block_ptr fill(std::string const& name, off_t first, size_t count,
+            F const& fetch)
+        {
+            size_t const bs = block_size_;
+            boost::uint64_t generation = 0;
+            {
+                mutex_type::scoped_lock l(mtx_);
+                generation = generation_;
+            }
+
+            std::vector<char> data(count * bs);
+            ssize_t len = fetch(data.data(), data.size(), first * off_t(bs));
+            if (len <= 0)
+            {
+                return block_ptr();
+            }
+
+            std::vector<block_ptr> blocks;
+            for (size_t pos = 0; pos < size_t(len); pos += bs)
+            {
+                size_t n = (std::min)(bs, size_t(len) - pos);
+                blocks.push_back(boost::make_shared<block_type const>(
+                    data.begin() + pos, data.begin() + pos + n));
+            }
+
+            read_ahead_blocks_ += blocks.size() - 1;
+
+            mutex_type::scoped_lock l(mtx_);
+
+            // something was invalidated meanwhile, the data may be stale
+            if (generation != generation_)
+            {
+                return blocks.front();
+            }
+
+            for (size_t i = 0; i != blocks.size(); ++i)
+            {
+                key_type key(name, first + off_t(i));
+                erase_locked(key);
+
+                lru_.push_front(entry_type(key, blocks[i]));
+                index_[key] = lru_.begin();
+            }
+
+            // remember where the file ended, a write beyond has to drop
+            // this block again
+            if (blocks.back()->size() < bs)
+            {
+                key_type const& key = lru_.front().first;
+                boost::unordered_map<std::string, off_t>::iterator eof =
+                    eof_block_.find(name);
+                if (eof != eof_block_.end() && eof->second != key.second)
+                {
+                    erase_locked(key_type(name, eof->second));
+                }
+                eof_block_[name] = key.second;
+            }
+
+            while (lru_.size() > capacity_)
+            {
+                erase_locked(key_type(lru_.back().first));
+            }
+
+            return blocks.front();
+        }
+
+        bool enabled_;
+        size_t block_size_;
+        size_t capacity_;
+        size_t read_ahead_;
+
+        mutable mutex_type mtx_;
+        lru_list_type lru_;
+        index_type index_;
+        boost::unordered_map<std::string, off_t> last_block_;
+        boost::unordered_map<std::string, off_t> eof_block_;
+        boost::uint64_t generation_;
+
+        boost::atomic<boost::uint64_t> hits_;
+        boost::atomic<boost::uint64_t> misses_;
+        boost::atomic<boost::uint64_t> read_ahead_blocks_;
+    };
+
+    // Register the performance counters of the block cache of this
+    // locality, this has to be done once at startup:
+    //
+    //   /hpxio{locality#*/total}/cache/hits        blocks found in the cache
+    //   /hpxio{locality#*/total}/cache/misses      blocks fetched
+    //   /hpxio{locality#*/total}/cache/read_ahead  blocks fetched ahead
+    inline void register_cache_counters()
+    {
+        using hpx::performance_counters::install_counter_type;
+        using hpx::util::bind;
+        using hpx::util::placeholders::_1;
+
+        block_cache& cache = block_cache::get();
+
+        install_counter_type("/hpxio/cache/hits",
+            bind(&detail::total_value, &cache.hits_, _1),
+            "returns the number of blocks read from the block cache");
+        install_counter_type("/hpxio/cache/misses",
+            bind(&detail::total_value, &cache.misses_, _1),
+            "returns the number of blocks missing in the block cache");
+        install_counter_type("/hpxio/cache/read_ahead",
+            bind(&detail::total_value, &cache.read_ahead_blocks_, _1),
+            "returns the number of blocks the block cache fetched ahead");
+    }
+
+}}} // hpx::io::server
+
+#endif
@@ -0,0 +1,267 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_COLLECTIVE_BUFFER_HPP_JUN_26_2015_0310PM)
+#define HPX_COMPONENTS_IO_SERVER_COLLECTIVE_BUFFER_HPP_JUN_26_2015_0310PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/lcos/local/promise.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpxio/extent.hpp>
+#include <hpxio/server/write_behind_buffer.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include <sys/types.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Aggregation side of two-phase collective I/O. All participants of a
+    // collective operation hand their extents of the aggregator's file
+    // domain to write() or read() with the same round number. The last one
+    // to arrive merges the extents of all participants into contiguous
+    // ranges and performs the file access for everybody, the others wait
+    // for it. Rounds are independent of each other, they are identified by
+    // the number the participants agree on.
+    //
+    // write() and read() have to be called from an HPX thread.
+    class collective_buffer : boost::noncopyable
+    {
+      private:
+        typedef hpx::lcos::local::spinlock mutex_type;
+
+        struct write_round
+        {
+            write_round() : arrived_(0), f_(p_.get_future()) {}
+
+            // merged as in write_behind_buffer, which itself is not used
+            // per round as it reads its configuration when constructed
+            std::size_t arrived_;
+            write_behind_buffer::extent_map staged_;
+
+            lcos::local::promise<int> p_;
+            hpx::shared_future<int> f_;
+        };
+
+        struct read_round
+        {
+            read_round() : arrived_(0), f_(p_.get_future()) {}
+
+            std::size_t arrived_;
+            std::vector<extent> requested_;
+
+            // the merged ranges as read from the file
+            std::map<off_t, std::vector<char> > data_;
+
+            lcos::local::promise<void> p_;
+            hpx::shared_future<void> f_;
+        };
+
+      public:
+        typedef write_behind_buffer::extent_map extent_map;
+
+        // Stage the data of the extents (laid out back to back in buf) for
+        // the given round, buf is anything with data() and size(). The
+        // function write_extents(extent_map const&) writes the merged data
+        // of all participants and returns 0 on success. Every participant
+        // gets back the number of bytes it contributed, or -1 if the round
+        // could not be written. A participant whose extents do not match
+        // the size of its data still takes part in the round, contributing
+        // nothing, and only gets back -1 itself.
+        template <typename Buffer, typename F>
+        ssize_t write(boost::uint64_t round, std::size_t participants,
+            std::vector<extent> const& extents, Buffer const& buf,
+            F const& write_extents)
+        {
+            bool const valid = total_count(extents) == buf.size();
+
+            boost::shared_ptr<write_round> r;
+            bool last = false;
+            {
+                mutex_type::scoped_lock l(mtx_);
+                boost::shared_ptr<write_round>& slot = writes_[round];
+                if (!slot)
+                {
+                    slot = boost::make_shared<write_round>();
+                }
+                r = slot;
+
+                std::size_t pos = 0;
+                for (std::size_t i = 0; valid && i != extents.size(); ++i)
+                {
+                    write_behind_buffer::insert(r->staged_,
+                        buf.data() + pos, extents[i].count,
+                        extents[i].offset);
+                    pos += extents[i].count;
+                }
+
+                last = ++r->arrived_ >= participants;
+                if (last)
+                {
+                    writes_.erase(round);
+                }
+            }
+
+            if (last)
+            {
+                extent_map staged;
+                staged.swap(r->staged_);
+                r->p_.set_value(write_extents(staged));
+            }
+
+            if (!valid)
+            {
+                return -1;
+            }
+            return (r->f_.get() == 0) ? static_cast<ssize_t>(buf.size()) : -1;
+        }
+
+        // Register the extents wanted by one participant for the given round.
+        // fetch(char* buf, size_t count, off_t offset) reads one merged range
+        // and returns the number of bytes read. The data of the extents is
+        // returned back to back, a short extent ends the result.
+        template <typename F>
+        std::vector<char> read(boost::uint64_t round,
+            std::size_t participants, std::vector<extent> const& extents,
+            F const& fetch)
+        {
+            boost::shared_ptr<read_round> r;
+            bool last = false;
+            {
+                mutex_type::scoped_lock l(mtx_);
+                boost::shared_ptr<read_round>& slot = reads_[round];
+                if (!slot)
+                {
+                    slot = boost::make_shared<read_round>();
+                }
+                r = slot;
+
+                r->requested_.insert(r->requested_.end(), extents.begin(),
+                    extents.end());
+
+                last = ++r->arrived_ >= participants;
+                if (last)
+                {
+                    reads_.erase(round);
+                }
+            }
+
+            if (last)
+            {
+                read_merged(*r, fetch);
+                r->p_.set_value();
+            }
+
+            r->f_.get();
+            return extract(*r, extents);
+        }
+
+      private:
+        template <typename F>
+        static void read_merged(read_round& r, F const& fetch)
+        {
+            std::vector<extent> ranges = merge(r.requested_);
+            for (std::size_t i = 0; i != ranges.size(); ++i)
+            {
+                std::vector<char> data(ranges[i].count);
+                ssize_t len = fetch(data.data(), data.size(),
+                    ranges[i].offset);
+                data.resize(len > 0 ? len : 0);
+                r.data_[ranges[i].offset].swap(data);
+            }
+        }
+
+        // sort the extents and join those overlapping or touching
+        static std::vector<extent> merge(std::vector<extent> extents)
+        {
+            std::sort(extents.begin(), extents.end(),
+                [](extent const& lhs, extent const& rhs)
+                {
+                    return lhs.offset < rhs.offset;
+                });
+
+            std::vector<extent> ranges;
+            for (std::size_t i = 0; i != extents.size(); ++i)
+            {
+                extent const& e = extents[i];
+                if (e.offset < 0 || e.count == 0)
+                {
+                    continue;
+                }
+
+                if (!ranges.empty() &&
+                    ranges.back().offset + off_t(ranges.back().count) >=
+                        e.offset)
+                {
+                    extent& back = ranges.back();
+                    off_t end = (std::max)(back.offset + off_t(back.count),
+                        off_t(e.offset + e.count));
+                    back.count = end - back.offset;
+                }
+                else
+                {
+                    ranges.push_back(e);
+                }
+            }
+            return ranges;
+        }
+
+        static std::vector<char> extract(read_round const& r,
+            std::vector<extent> const& extents)
+        {
+            std::vector<char> result(total_count(extents));
+
+            std::size_t done = 0;
+            for (std::size_t i = 0; i != extents.size(); ++i)
+            {
+                extent const& e = extents[i];
+
+                // the merged range containing the start of the extent
+                std::map<off_t, std::vector<char> >::const_iterator it =
+                    r.data_.upper_bound(e.offset);
+                if (e.offset < 0 || it == r.data_.begin())
+                {
+                    break;
+                }
+                --it;
+
+                off_t const start = e.offset - it->first;
+                std::size_t len = 0;
+                if (start < off_t(it->second.size()))
+                {
+                    len = (std::min)(e.count, it->second.size() - start);
+                    std::memcpy(result.data() + done,
+                        it->second.data() + start, len);
+                }
+
+                done += len;
+                if (len < e.count)
+                {
+                    break;
+                }
+            }
+
+            result.resize(done);
+            return result;
+        }
+
+        mutex_type mtx_;
+        std::map<boost::uint64_t, boost::shared_ptr<write_round> > writes_;
+        std::map<boost::uint64_t, boost::shared_ptr<read_round> > reads_;
+    };
+
+}}} // hpx::io::server
+
+#endif
@@ -0,0 +1,134 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_DIRECTORY_TABLE_HPP_JUL_10_2015_1000AM)
+#define HPX_COMPONENTS_IO_SERVER_DIRECTORY_TABLE_HPP_JUL_10_2015_1000AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpxio/directory_entry.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // The directory streams a component keeps open for its clients, they are
+    // known to the clients by a number which is never 0. A stream stays alive
+    // while it is being read, even if it is removed meanwhile.
+    template <typename Stream>
+    class directory_table : boost::noncopyable
+    {
+      private:
+        typedef hpx::lcos::local::spinlock mutex_type;
+
+      public:
+        typedef boost::shared_ptr<Stream> stream_ptr;
+
+        directory_table() : next_(0) {}
+
+        boost::uint64_t add(stream_ptr const& s)
+        {
+            mutex_type::scoped_lock l(mtx_);
+            boost::uint64_t const handle = ++next_;
+            streams_[handle] = s;
+            return handle;
+        }
+
+        stream_ptr get(boost::uint64_t handle) const
+        {
+            mutex_type::scoped_lock l(mtx_);
+            typename std::map<boost::uint64_t, stream_ptr>::const_iterator it =
+                streams_.find(handle);
+            return (it == streams_.end()) ? stream_ptr() : it->second;
+        }
+
+        stream_ptr remove(boost::uint64_t handle)
+        {
+            stream_ptr s;
+            mutex_type::scoped_lock l(mtx_);
+            typename std::map<boost::uint64_t, stream_ptr>::iterator it =
+                streams_.find(handle);
+            if (it != streams_.end())
+            {
+                s.swap(it->second);
+                streams_.erase(it);
+            }
+            return s;
+        }
+
+      private:
+        mutable mutex_type mtx_;
+        boost::uint64_t next_;
+        std::map<boost::uint64_t, stream_ptr> streams_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // A directory of the local file system, read() blocks and has to be run
+    // on the io_pool.
+    class local_directory : boost::noncopyable
+    {
+      public:
+        explicit local_directory(std::string const& path)
+          : dir_(::opendir(path.c_str()))
+        {}
+
+        ~local_directory()
+        {
+            if (dir_ != 0)
+            {
+                ::closedir(dir_);
+            }
+        }
+
+        bool is_open() const
+        {
+            return dir_ != 0;
+        }
+
+        // up to count entries, without "." and "..", none at the end
+        std::vector<directory_entry> read(std::size_t count)
+        {
+            std::vector<directory_entry> result;
+            if (dir_ == 0)
+            {
+                return result;
+            }
+
+            result.reserve(count);
+            while (result.size() < count)
+            {
+                struct dirent* e = ::readdir(dir_);
+                if (e == 0)
+                {
+                    break;
+                }
+                if (std::strcmp(e->d_name, ".") == 0 ||
+                    std::strcmp(e->d_name, "..") == 0)
+                {
+                    continue;
+                }
+                result.push_back(directory_entry(e->d_name, e->d_type));
+            }
+            return result;
+        }
+
+      private:
+        DIR* dir_;
+    };
+
+}}} // hpx::io::server
+
+#endif
@@ -0,0 +1,270 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_FILE_COPY_HPP_JUL_15_2015_1000AM)
+#define HPX_COMPONENTS_IO_SERVER_FILE_COPY_HPP_JUL_15_2015_1000AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/runtime/get_config_entry.hpp>
+#include <hpx/util/serialize_buffer.hpp>
+#include <hpxio/copy_progress.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Server-side copies move hpxio.copy.chunk_size (default: 4 MiB) bytes
+    // at a time with up to hpxio.copy.window (default: 4) chunks in flight.
+    inline std::size_t copy_chunk_size()
+    {
+        static std::size_t const size = (std::max)(std::size_t(1),
+            boost::lexical_cast<std::size_t>(hpx::get_config_entry(
+                "hpxio.copy.chunk_size", "4194304")));
+        return size;
+    }
+
+    inline std::size_t copy_window()
+    {
+        static std::size_t const window = (std::max)(std::size_t(1),
+            boost::lexical_cast<std::size_t>(hpx::get_config_entry(
+                "hpxio.copy.window", "4")));
+        return window;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // One copy running in the background, the component keeps it in a
+    // directory_table until the client asked for its result.
+    class copy_job : boost::noncopyable
+    {
+      public:
+        explicit copy_job(boost::uint64_t count)
+          : count_(count), copied_(0)
+        {}
+
+        boost::uint64_t count() const
+        {
+            return count_;
+        }
+
+        void add_copied(boost::uint64_t n)
+        {
+            copied_ += n;
+        }
+
+        void start(lcos::future<ssize_t> && f)
+        {
+            result_ = f.share();
+        }
+
+        ssize_t wait() const
+        {
+            return result_.get();
+        }
+
+        copy_progress progress() const
+        {
+            copy_progress p;
+            p.count = count_;
+            p.copied = copied_.load();
+            p.done = result_.is_ready();
+            if (p.done)
+            {
+                p.result = result_.get();
+            }
+            return p;
+        }
+
+      private:
+        boost::uint64_t const count_;
+        boost::atomic<boost::uint64_t> copied_;
+        lcos::shared_future<ssize_t> result_;
+    };
+
+    // the progress reported for a handle which is not known (any more)
+    inline copy_progress unknown_copy()
+    {
+        copy_progress p;
+        p.done = true;
+        p.result = -1;
+        return p;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Copy the data of job from src_offset to dst_offset chunk by chunk.
+    // read(size_t count, off_t offset) returns a future to a buffer with the
+    // data of one chunk, write(buffer const&, off_t offset) a future to the
+    // number of bytes written. Reading a chunk overlaps with writing the
+    // previous ones, the memory used stays bounded by the window. The copy
+    // stops at the first short transfer, the result is the number of bytes
+    // copied without a gap, -1 if an error occurred before any data was
+    // copied. Has to be called from an HPX thread.
+    template <typename Read, typename Write>
+    ssize_t pipelined_copy(Read const& read, Write const& write,
+        off_t const src_offset, off_t const dst_offset, copy_job& job)
+    {
+        typedef hpx::util::serialize_buffer<char> buffer_type;
+
+        std::size_t const chunk = copy_chunk_size();
+        std::size_t const window = copy_window();
+
+        // the expected size of the chunks in flight, in file order
+        std::deque<std::pair<std::size_t, lcos::future<ssize_t> > > pending;
+
+        boost::uint64_t issued = 0;
+        boost::uint64_t copied = 0;
+        bool stopped = false;
+        bool failed = false;
+        for (;;)
+        {
+            while (!stopped && issued < job.count() &&
+                pending.size() < window)
+            {
+                std::size_t const n = static_cast<std::size_t>(
+                    (std::min)(job.count() - issued, boost::uint64_t(chunk)));
+                off_t const dst = dst_offset + issued;
+
+                pending.push_back(std::make_pair(n,
+                    read(n, src_offset + issued).then(
+                        [write, dst](lcos::future<buffer_type> f) -> ssize_t
+                        {
+                            buffer_type data = f.get();
+                            if (data.size() == 0)
+                            {
+                                return 0;
+                            }
+                            return write(data, dst).get();
+                        })));
+                issued += n;
+            }
+
+            if (pending.empty())
+            {
+                break;
+            }
+
+            // the chunks behind a short one are waited for, not counted
+            std::size_t const n = pending.front().first;
+            ssize_t const len = pending.front().second.get();
+            pending.pop_front();
+
+            if (!stopped)
+            {
+                if (len > 0)
+                {
+                    copied += len;
+                    job.add_copied(len);
+                }
+                if (len < static_cast<ssize_t>(n))
+                {
+                    stopped = true;
+                    failed = len < 0;
+                }
+            }
+        }
+
+        return (failed && copied == 0) ? -1 : static_cast<ssize_t>(copied);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Copy the data of job between two descriptors of this locality without
+    // moving it through user space: with copy_file_range where the kernel
+    // offers it, with sendfile otherwise. sendfile writes at the file
+    // position of its target, it gets a descriptor of its own on out_name.
+    // Returns -1 if the kernel could not copy any of the data, the caller
+    // falls back to a pipelined copy then. Blocks, run it on the io_pool.
+    inline ssize_t kernel_copy(int const in, off_t const in_offset,
+        int const out, std::string const& out_name, off_t const out_offset,
+        copy_job& job)
+    {
+        boost::uint64_t const count = job.count();
+        boost::uint64_t const chunk = copy_chunk_size();
+        boost::uint64_t done = 0;
+        bool failed = false;
+
+#if defined(SYS_copy_file_range)
+        while (done < count)
+        {
+            loff_t i = in_offset + done;
+            loff_t o = out_offset + done;
+            ssize_t len = ::syscall(SYS_copy_file_range, in, &i, out, &o,
+                static_cast<std::size_t>((std::min)(count - done, chunk)), 0u);
+            if (len < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (len <= 0)
+            {
+                failed = len < 0;
+                break;
+            }
+            done += len;
+            job.add_copied(len);
+        }
+
+        // EXDEV, ENOSYS, EINVAL, ... right away: try sendfile
+        if (!failed || done != 0)
+        {
+            return done;
+        }
+        failed = false;
+#else
+        (void)out;
+#endif
+
+        int const fd = ::open(out_name.c_str(), O_WRONLY);
+        if (fd < 0)
+        {
+            return -1;
+        }
+        if (::lseek(fd, out_offset, SEEK_SET) < 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+
+        while (done < count)
+        {
+            off_t i = in_offset + done;
+            ssize_t len = ::sendfile(fd, in, &i,
+                static_cast<std::size_t>((std::min)(count - done, chunk)));
+            if (len < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (len <= 0)
+            {
+                failed = len < 0;
+                break;
+            }
+            done += len;
+            job.add_copied(len);
+        }
+        ::close(fd);
+
+        return (failed && done == 0) ? -1 : static_cast<ssize_t>(done);
+    }
+
+}}} // hpx::io::server
+
+#endif
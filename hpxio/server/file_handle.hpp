@@ -0,0 +1,44 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_FILE_HANDLE_HPP_JUL_17_2015_0900AM)
+#define HPX_COMPONENTS_IO_SERVER_FILE_HANDLE_HPP_JUL_17_2015_0900AM
+
+#include <boost/noncopyable.hpp>
+
+#include <string>
+
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // An open descriptor together with the name and the mode it was opened
+    // with. Requests hold a reference for as long as they use the
+    // descriptor, it is closed when the last reference goes away. A
+    // concurrent open or close therefore never closes the descriptor under
+    // a running request, and its number cannot be reused for another file
+    // meanwhile.
+    struct file_handle : boost::noncopyable
+    {
+        file_handle(int f, std::string const& n, bool d, bool a)
+          : fd(f), name(n), direct(d), append(a)
+        {}
+
+        ~file_handle()
+        {
+            ::close(fd);
+        }
+
+        int const fd;
+        std::string const name;     // the key of the file in the block_cache
+        bool const direct;          // opened with O_DIRECT
+        bool const append;          // O_APPEND emulated for O_DIRECT
+    };
+
+}}} // hpx::io::server
+
+#endif
@@ -0,0 +1,163 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_GROUP_COMMIT_HPP_JUN_18_2015_1050AM)
+#define HPX_COMPONENTS_IO_SERVER_GROUP_COMMIT_HPP_JUN_18_2015_1050AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/include/async.hpp>
+#include <hpx/lcos/local/promise.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/runtime/get_config_entry.hpp>
+#include <hpx/util/bind.hpp>
+
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Merges concurrent durability requests on one file into as few physical
+    // syncs as possible. The first caller runs the sync itself. Everybody
+    // arriving while it is in progress joins the next batch, which is synced
+    // once by a single HPX thread as soon as the current sync is done, as
+    // only a sync started after a request was made covers its writes.
+    //
+    // Group commit is enabled with the ini entry hpxio.group_commit=1,
+    // otherwise every request performs its own sync. run() has to be called
+    // from an HPX thread.
+    //
+    // The batch thread calls the sync function of its owner after the
+    // caller which started it has returned. The owner has to call wait()
+    // before the synced file goes away, the destructor waits as well.
+    class group_commit : boost::noncopyable
+    {
+      private:
+        typedef hpx::lcos::local::spinlock mutex_type;
+
+        struct batch
+        {
+            batch() : f_(p_.get_future()) {}
+
+            lcos::local::promise<int> p_;
+            hpx::shared_future<int> f_;
+        };
+
+      public:
+        group_commit()
+          : enabled_(hpx::get_config_entry("hpxio.group_commit", "0") == "1"),
+            running_(false)
+        {}
+
+        ~group_commit()
+        {
+            wait();
+        }
+
+        bool enabled() const
+        {
+            return enabled_;
+        }
+
+        // sync() performs one physical sync and returns its result
+        template <typename F>
+        int run(F const& sync)
+        {
+            if (!enabled_)
+            {
+                return sync();
+            }
+
+            boost::shared_ptr<batch> b;
+            {
+                mutex_type::scoped_lock l(mtx_);
+                if (running_)
+                {
+                    if (!next_)
+                    {
+                        next_ = boost::make_shared<batch>();
+                    }
+                    b = next_;
+                }
+                else
+                {
+                    running_ = true;
+                }
+            }
+
+            if (b)
+            {
+                // wait for the sync started after the current one
+                return b->f_.get();
+            }
+
+            int result = sync();
+            hand_over(sync);
+            return result;
+        }
+
+        // returns once no batch is synced on a separate HPX thread anymore
+        void wait()
+        {
+            for (;;)
+            {
+                boost::shared_ptr<batch> b;
+                {
+                    mutex_type::scoped_lock l(mtx_);
+                    b = in_flight_;
+                }
+                if (!b)
+                {
+                    return;
+                }
+
+                // the batch hands over to the next one before it is ready
+                b->f_.wait();
+            }
+        }
+
+      private:
+        template <typename F>
+        void hand_over(F const& sync)
+        {
+            boost::shared_ptr<batch> b;
+            {
+                mutex_type::scoped_lock l(mtx_);
+                b.swap(next_);
+                in_flight_ = b;
+                if (!b)
+                {
+                    running_ = false;
+                    return;
+                }
+            }
+
+            // the waiting batch is synced on a new HPX thread, the current
+            // caller returns right away
+            hpx::apply(hpx::util::bind(&group_commit::run_batch<F>, this,
+                b, sync));
+        }
+
+        template <typename F>
+        void run_batch(boost::shared_ptr<batch> b, F const& sync)
+        {
+            int result = sync();
+            hand_over(sync);
+            b->p_.set_value(result);
+        }
+
+        bool const enabled_;
+
+        mutex_type mtx_;
+        bool running_;
+        boost::shared_ptr<batch> next_;
+        boost::shared_ptr<batch> in_flight_;
+    };
+
+}}} // hpx::io::server
+
+#endif
@@ -0,0 +1,432 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_IO_SCHEDULER_HPP_JUL_16_2015_0930AM)
+#define HPX_COMPONENTS_IO_SERVER_IO_SCHEDULER_HPP_JUL_16_2015_0930AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/config/export_definitions.hpp>
+#include <hpx/include/performance_counters.hpp>
+#include <hpx/include/thread_executors.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/lcos/local/promise.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/runtime/get_config_entry.hpp>
+#include <hpx/util/bind.hpp>
+#include <hpxio/io_hints.hpp>
+#include <hpxio/server/io_statistics.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Admission of the blocking work of a backend to the io_pool. At most
+    // hpxio.scheduler.slots (default: hpx.threadpools.io_pool_size) tasks
+    // are handed to the io_pool at a time, further requests wait here
+    // instead of in the FIFO queue of the io_pool. A free slot goes to
+    //
+    //   - the waiting request whose deadline passed first, otherwise
+    //   - the highest priority class with waiting requests. The clients of
+    //     a class are served round robin, the requests of one client in
+    //     the order they arrived.
+    //
+    // Requests without a deadline hint get the default deadline of their
+    // class, hpxio.scheduler.deadline.interactive, .normal and .background
+    // (defaults: 1000, 10000 and 1000000 microseconds), which bounds how
+    // long a lower class can be starved by a higher one.
+    //
+    // The hints of a request are handed to the io_pool_scheduler running
+    // its work, requests without hints are of class normal and client 0.
+    // Work which does not go through the io_pool (the io_uring engine,
+    // cache hits) is not scheduled. hpxio.scheduler.enabled=0 turns
+    // admission control off.
+    //
+    // get(backend) hands out the same instance to every module of the
+    // process, so requests taking the direct path from a client share the
+    // slots with those arriving through actions.
+    class HPX_COMPONENT_EXPORT io_scheduler : boost::noncopyable
+    {
+      private:
+        typedef hpx::lcos::local::spinlock mutex_type;
+        typedef hpx::lcos::local::promise<void> promise_type;
+
+        struct request
+        {
+            std::size_t priority;
+            boost::uint64_t queued;
+            boost::uint64_t deadline;
+            boost::shared_ptr<promise_type> admitted;
+        };
+
+        // the requests of one class, by client; clients_ holds the clients
+        // with waiting requests in round robin order
+        struct priority_class
+        {
+            std::map<boost::uint64_t, std::deque<boost::uint64_t> > queues_;
+            std::deque<boost::uint64_t> clients_;
+        };
+
+      public:
+        struct class_statistics : boost::noncopyable
+        {
+            class_statistics() : queued_(0), admitted_(0), missed_(0) {}
+
+            boost::atomic<boost::int64_t> queued_;
+            boost::atomic<boost::uint64_t> admitted_;
+            boost::atomic<boost::uint64_t> missed_;   // after their deadline
+            latency_histogram wait_;
+        };
+
+        static io_scheduler& get(std::string const& backend);
+
+        static char const* name(std::size_t priority)
+        {
+            static char const* const names[io_priority_count] =
+            {
+                "interactive", "normal", "background"
+            };
+            return names[priority];
+        }
+
+        // Wait for a slot according to the given hints, returns false if no
+        // slot was taken (scheduling is disabled or the caller is not an HPX
+        // thread). A slot taken has to be released.
+        bool acquire(io_hints const& hints)
+        {
+            if (!enabled_ || hpx::threads::get_self_ptr() == 0)
+            {
+                return false;
+            }
+
+            std::size_t const c = (std::min)(std::size_t(hints.priority),
+                std::size_t(io_priority_count - 1));
+            boost::uint64_t const now = io_statistics::now();
+
+            boost::shared_ptr<promise_type> admitted;
+            {
+                mutex_type::scoped_lock l(mtx_);
+                if (running_ < slots_ && requests_.empty())
+                {
+                    ++running_;
+                    stats_[c].admitted_.fetch_add(1,
+                        boost::memory_order_relaxed);
+                    stats_[c].wait_.record(0);
+                    return true;
+                }
+
+                request r;
+                r.priority = c;
+                r.queued = now;
+                r.deadline = now + (hints.deadline != 0 ?
+                    hints.deadline * 1000 : default_deadline_[c]);
+                r.admitted = boost::make_shared<promise_type>();
+                admitted = r.admitted;
+
+                boost::uint64_t const seq = ++next_;
+                requests_[seq] = r;
+                deadlines_.insert(std::make_pair(r.deadline, seq));
+
+                priority_class& pc = classes_[c];
+                std::map<boost::uint64_t, std::deque<boost::uint64_t> >::
+                    iterator it = pc.queues_.find(hints.client);
+                if (it == pc.queues_.end())
+                {
+                    pc.queues_[hints.client].push_back(seq);
+                    pc.clients_.push_back(hints.client);
+                }
+                else
+                {
+                    it->second.push_back(seq);
+                }
+                stats_[c].queued_.fetch_add(1, boost::memory_order_relaxed);
+            }
+
+            // suspend until release() hands a slot over
+            admitted->get_future().get();
+            return true;
+        }
+
+        // hand the slot over to the next request, may be called from any
+        // thread
+        void release()
+        {
+            boost::shared_ptr<promise_type> next;
+            {
+                mutex_type::scoped_lock l(mtx_);
+                next = pick_locked(io_statistics::now());
+                if (!next)
+                {
+                    --running_;
+                    return;
+                }
+            }
+            next->set_value();
+        }
+
+        class_statistics& operator[](std::size_t priority)
+        {
+            return stats_[priority];
+        }
+
+        // the number of slots in use
+        boost::int64_t running() const
+        {
+            mutex_type::scoped_lock l(mtx_);
+            return static_cast<boost::int64_t>(running_);
+        }
+
+        // the statistics of the backend, the time its work waits for an
+        // io_pool thread is recorded there
+        io_statistics& statistics()
+        {
+            return backend_stats_;
+        }
+
+      private:
+        explicit io_scheduler(io_statistics& stats)
+          : backend_stats_(stats),
+            enabled_(hpx::get_config_entry(
+                "hpxio.scheduler.enabled", "1") == "1"),
+            slots_((std::max)(std::size_t(1),
+                boost::lexical_cast<std::size_t>(hpx::get_config_entry(
+                    "hpxio.scheduler.slots", hpx::get_config_entry(
+                        "hpx.threadpools.io_pool_size", "2"))))),
+            running_(0), next_(0)
+        {
+            char const* const defaults[io_priority_count] =
+            {
+                "1000", "10000", "1000000"
+            };
+            for (std::size_t c = 0; c != io_priority_count; ++c)
+            {
+                default_deadline_[c] = 1000 *
+                    boost::lexical_cast<boost::uint64_t>(
+                        hpx::get_config_entry(
+                            std::string("hpxio.scheduler.deadline.") +
+                                name(c), defaults[c]));
+            }
+        }
+
+        // take the next request out of the queues, its slot is handed over
+        boost::shared_ptr<promise_type> pick_locked(boost::uint64_t now)
+        {
+            boost::uint64_t seq = 0;
+            if (!deadlines_.empty() && deadlines_.begin()->first <= now)
+            {
+                seq = deadlines_.begin()->second;
+            }
+            for (std::size_t c = 0; seq == 0 && c != io_priority_count; ++c)
+            {
+                seq = next_in_class_locked(classes_[c]);
+            }
+            if (seq == 0)
+            {
+                return boost::shared_ptr<promise_type>();
+            }
+
+            std::map<boost::uint64_t, request>::iterator it =
+                requests_.find(seq);
+            request const r = it->second;
+            requests_.erase(it);
+            deadlines_.erase(std::make_pair(r.deadline, seq));
+
+            class_statistics& s = stats_[r.priority];
+            s.queued_.fetch_sub(1, boost::memory_order_relaxed);
+            s.admitted_.fetch_add(1, boost::memory_order_relaxed);
+            s.wait_.record(now - r.queued);
+            if (now > r.deadline)
+            {
+                s.missed_.fetch_add(1, boost::memory_order_relaxed);
+            }
+            return r.admitted;
+        }
+
+        // The oldest request of the next client in round robin order.
+        // Requests which were admitted early because of their deadline are
+        // still in the queues and skipped here.
+        boost::uint64_t next_in_class_locked(priority_class& pc)
+        {
+            while (!pc.clients_.empty())
+            {
+                boost::uint64_t const client = pc.clients_.front();
+                pc.clients_.pop_front();
+
+                std::deque<boost::uint64_t>& q = pc.queues_[client];
+                while (!q.empty() && requests_.find(q.front()) ==
+                    requests_.end())
+                {
+                    q.pop_front();
+                }
+                if (q.empty())
+                {
+                    pc.queues_.erase(client);
+                    continue;
+                }
+
+                boost::uint64_t const seq = q.front();
+                q.pop_front();
+                if (q.empty())
+                {
+                    pc.queues_.erase(client);
+                }
+                else
+                {
+                    pc.clients_.push_back(client);
+                }
+                return seq;
+            }
+            return 0;
+        }
+
+        io_statistics& backend_stats_;
+
+        bool const enabled_;
+        std::size_t const slots_;
+        boost::uint64_t default_deadline_[io_priority_count];
+
+        mutable mutex_type mtx_;
+        std::size_t running_;
+        boost::uint64_t next_;
+        std::map<boost::uint64_t, request> requests_;
+        std::set<std::pair<boost::uint64_t, boost::uint64_t> > deadlines_;
+        priority_class classes_[io_priority_count];
+
+        class_statistics stats_[io_priority_count];
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Runs blocking work on the io_pool once the io_scheduler of the
+    // backend admitted it according to the hints of the request, the time
+    // a task waited for an io_pool thread is recorded in the statistics of
+    // the backend. As with the io_pool_executor the destructor waits for
+    // all tasks added.
+    class io_pool_scheduler : boost::noncopyable
+    {
+      private:
+        struct slot
+        {
+            slot(io_scheduler* scheduler, bool taken)
+              : scheduler_(scheduler), taken_(taken)
+            {}
+
+            ~slot()
+            {
+                if (taken_)
+                {
+                    scheduler_->release();
+                }
+            }
+
+            io_scheduler* scheduler_;
+            bool taken_;
+        };
+
+      public:
+        explicit io_pool_scheduler(io_scheduler& scheduler,
+                io_hints const& hints = io_hints())
+          : io_scheduler_(scheduler), hints_(hints)
+        {}
+
+        template <typename F>
+        void add(F f)
+        {
+            io_scheduler* scheduler = &io_scheduler_;
+            bool const taken = scheduler->acquire(hints_);
+            boost::uint64_t const queued = io_statistics::now();
+            scheduler_.add(
+                [f, queued, taken, scheduler]() mutable
+                {
+                    slot s(scheduler, taken);
+                    scheduler->statistics().io_pool_wait().record(
+                        io_statistics::now() - queued);
+                    f();
+                });
+        }
+
+      private:
+        io_scheduler& io_scheduler_;
+        io_hints const hints_;
+        hpx::threads::executors::io_pool_executor scheduler_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+        inline boost::int64_t queued_value(io_scheduler* scheduler,
+            std::size_t priority, bool)
+        {
+            return (*scheduler)[priority].queued_.load();
+        }
+
+        inline boost::int64_t running_value(io_scheduler* scheduler, bool)
+        {
+            return scheduler->running();
+        }
+    }
+
+    // Register the performance counters of the io_scheduler of a backend,
+    // next to the ones of register_counters. For each priority class there
+    // is
+    //
+    //   /hpxio{locality#*/total}/<backend>/scheduler/<class>/queued
+    //   /hpxio{locality#*/total}/<backend>/scheduler/<class>/admitted
+    //   /hpxio{locality#*/total}/<backend>/scheduler/<class>/deadline-misses
+    //   /hpxio{locality#*/total}/<backend>/scheduler/<class>/wait/p50 (...)
+    //
+    // plus <backend>/scheduler/running, the number of slots in use.
+    inline void register_scheduler_counters(std::string const& backend)
+    {
+        using hpx::performance_counters::install_counter_type;
+        using hpx::util::bind;
+        using hpx::util::placeholders::_1;
+
+        io_scheduler& scheduler = io_scheduler::get(backend);
+        std::string const base = "/hpxio/" + backend + "/scheduler";
+
+        for (std::size_t c = 0; c != io_priority_count; ++c)
+        {
+            io_scheduler::class_statistics& s = scheduler[c];
+            std::string const prefix = base + "/" + io_scheduler::name(c);
+            std::string const what = backend + " requests of class " +
+                io_scheduler::name(c);
+
+            install_counter_type(prefix + "/queued",
+                bind(&detail::queued_value, &scheduler, c, _1),
+                "returns the number of " + what + " waiting for a slot");
+            install_counter_type(prefix + "/admitted",
+                bind(&detail::total_value, &s.admitted_, _1),
+                "returns the number of " + what + " admitted to the "
+                "io_pool");
+            install_counter_type(prefix + "/deadline-misses",
+                bind(&detail::total_value, &s.missed_, _1),
+                "returns the number of " + what + " admitted after their "
+                "deadline");
+            detail::install_percentiles(prefix + "/wait", s.wait_,
+                "time " + what + " waited for a slot");
+        }
+
+        install_counter_type(base + "/running",
+            bind(&detail::running_value, &scheduler, _1),
+            "returns the number of " + backend + " io_pool slots in use");
+    }
+
+}}} // hpx::io::server
+
+#endif
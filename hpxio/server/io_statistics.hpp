@@ -0,0 +1,458 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_IO_STATISTICS_HPP_JUL_13_2015_1010AM)
+#define HPX_COMPONENTS_IO_SERVER_IO_STATISTICS_HPP_JUL_13_2015_1010AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/config/export_definitions.hpp>
+#include <hpx/include/performance_counters.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/util/bind.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/ref.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Latency histogram with four buckets per power of two, i.e. a relative
+    // error of at most 25%, covering everything from 1ns up. The counts are
+    // spread over stripes picked by the recording OS-thread, so concurrent
+    // threads do not share cache lines. Recording is a single relaxed atomic
+    // increment, reading sums up all stripes.
+    class latency_histogram : boost::noncopyable
+    {
+      private:
+        static std::size_t const bucket_count = 4 * 64;
+        static std::size_t const stripe_count = 16;
+
+        struct stripe
+        {
+            boost::atomic<boost::uint64_t> counts_[bucket_count];
+        };
+
+      public:
+        latency_histogram()
+        {
+            reset();
+        }
+
+        void record(boost::uint64_t ns)
+        {
+            stripes_[stripe_index()].counts_[bucket(ns)].fetch_add(1,
+                boost::memory_order_relaxed);
+        }
+
+        // the value the given fraction of the recorded values does not
+        // exceed, 0 if nothing was recorded
+        boost::uint64_t percentile(double fraction) const
+        {
+            std::vector<boost::uint64_t> counts(bucket_count, 0);
+            boost::uint64_t total = 0;
+            for (std::size_t s = 0; s != stripe_count; ++s)
+            {
+                for (std::size_t b = 0; b != bucket_count; ++b)
+                {
+                    boost::uint64_t const n = stripes_[s].counts_[b].load(
+                        boost::memory_order_relaxed);
+                    counts[b] += n;
+                    total += n;
+                }
+            }
+            if (total == 0)
+            {
+                return 0;
+            }
+
+            boost::uint64_t const rank = static_cast<boost::uint64_t>(
+                std::ceil(fraction * total));
+            boost::uint64_t seen = 0;
+            for (std::size_t b = 0; b != bucket_count; ++b)
+            {
+                seen += counts[b];
+                if (seen >= rank && counts[b] != 0)
+                {
+                    return lower_bound(b + 1) - 1;
+                }
+            }
+            return lower_bound(bucket_count - 1);
+        }
+
+        void reset()
+        {
+            for (std::size_t s = 0; s != stripe_count; ++s)
+            {
+                for (std::size_t b = 0; b != bucket_count; ++b)
+                {
+                    stripes_[s].counts_[b].store(0,
+                        boost::memory_order_relaxed);
+                }
+            }
+        }
+
+      private:
+        static std::size_t stripe_index()
+        {
+            return boost::hash<boost::thread::id>()(
+                boost::this_thread::get_id()) % stripe_count;
+        }
+
+        static std::size_t log2(boost::uint64_t v)
+        {
+#if defined(__GNUC__)
+            return 63 - __builtin_clzll(v);
+#else
+            std::size_t result = 0;
+            while (v >>= 1)
+            {
+                ++result;
+            }
+            return result;
+#endif
+        }
+
+        // values below 4 have a bucket of their own, above that the power
+        // of two is split into four
+        static std::size_t bucket(boost::uint64_t v)
+        {
+            if (v < 4)
+            {
+                return static_cast<std::size_t>(v);
+            }
+            std::size_t const octave = log2(v);
+            return (octave - 1) * 4 + ((v >> (octave - 2)) & 3);
+        }
+
+        static boost::uint64_t lower_bound(std::size_t b)
+        {
+            if (b < 4)
+            {
+                return b;
+            }
+            return boost::uint64_t(4 + b % 4) << (b / 4 - 1);
+        }
+
+        stripe stripes_[stripe_count];
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // What is recorded for each type of operation.
+    struct operation_statistics : boost::noncopyable
+    {
+        operation_statistics() : count_(0), bytes_(0), in_flight_(0) {}
+
+        void record(boost::uint64_t ns, boost::uint64_t bytes)
+        {
+            latency_.record(ns);
+            count_.fetch_add(1, boost::memory_order_relaxed);
+            if (bytes != 0)
+            {
+                bytes_.fetch_add(bytes, boost::memory_order_relaxed);
+            }
+        }
+
+        latency_histogram latency_;
+        boost::atomic<boost::uint64_t> count_;
+        boost::atomic<boost::uint64_t> bytes_;
+        boost::atomic<boost::int64_t> in_flight_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // The per-locality statistics of one file backend, see register_counters
+    // for how they are exposed. get(backend) hands out the same instance to
+    // every module of the process, so requests taking the direct path from
+    // a client are accounted for next to those arriving through actions.
+    class HPX_COMPONENT_EXPORT io_statistics : boost::noncopyable
+    {
+      public:
+        enum operation
+        {
+            open, close, read, pread, write, pwrite, preadv, pwritev,
+            flush, fsync, fdatasync, lseek, metadata,
+            operation_count
+        };
+
+        static char const* name(operation op)
+        {
+            static char const* const names[operation_count] =
+            {
+                "open", "close", "read", "pread", "write", "pwrite",
+                "preadv", "pwritev", "flush", "fsync", "fdatasync", "lseek",
+                "metadata"
+            };
+            return names[op];
+        }
+
+        static io_statistics& get(std::string const& backend);
+
+        operation_statistics& operator[](operation op)
+        {
+            return ops_[op];
+        }
+
+        // the time requests spent waiting for an io_pool thread
+        latency_histogram& io_pool_wait()
+        {
+            return io_pool_wait_;
+        }
+
+        // the number of operations currently executing
+        boost::int64_t queue_depth() const
+        {
+            boost::int64_t result = 0;
+            for (std::size_t i = 0; i != operation_count; ++i)
+            {
+                result += ops_[i].in_flight_.load(
+                    boost::memory_order_relaxed);
+            }
+            return result;
+        }
+
+        static boost::uint64_t now()
+        {
+            return hpx::util::high_resolution_clock::now();
+        }
+
+      private:
+        operation_statistics ops_[operation_count];
+        latency_histogram io_pool_wait_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Measures one operation from construction to destruction, the number
+    // of bytes it transferred is passed through transferred().
+    class operation_timer : boost::noncopyable
+    {
+      public:
+        operation_timer(io_statistics& stats, io_statistics::operation op)
+          : stats_(stats[op]), start_(io_statistics::now()), bytes_(0)
+        {
+            stats_.in_flight_.fetch_add(1, boost::memory_order_relaxed);
+        }
+
+        ~operation_timer()
+        {
+            stats_.record(io_statistics::now() - start_, bytes_);
+            stats_.in_flight_.fetch_sub(1, boost::memory_order_relaxed);
+        }
+
+        ssize_t transferred(ssize_t len)
+        {
+            if (len > 0)
+            {
+                bytes_ = len;
+            }
+            return len;
+        }
+
+      private:
+        operation_statistics& stats_;
+        boost::uint64_t start_;
+        boost::uint64_t bytes_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Base of request control blocks of asynchronous operations, which are
+    // measured from start() until finish() is called on completion. stats_
+    // has to be set before start().
+    struct timed_request
+    {
+        timed_request()
+          : stats_(0), op_(io_statistics::metadata), start_(0)
+        {}
+
+        void start()
+        {
+            start_ = io_statistics::now();
+            (*stats_)[op_].in_flight_.fetch_add(1,
+                boost::memory_order_relaxed);
+        }
+
+        void finish(ssize_t len)
+        {
+            operation_statistics& s = (*stats_)[op_];
+            s.record(io_statistics::now() - start_, (len > 0) ? len : 0);
+            s.in_flight_.fetch_sub(1, boost::memory_order_relaxed);
+        }
+
+        io_statistics* stats_;
+        io_statistics::operation op_;
+        boost::uint64_t start_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+        // the rate of change of a monotonic value per second, measured
+        // between two subsequent queries; copies share their state
+        class rate_counter
+        {
+          private:
+            typedef hpx::lcos::local::spinlock mutex_type;
+
+            struct state : boost::noncopyable
+            {
+                explicit state(boost::atomic<boost::uint64_t> const& value)
+                  : value_(value), last_value_(value.load()),
+                    last_time_(io_statistics::now())
+                {}
+
+                boost::atomic<boost::uint64_t> const& value_;
+                mutex_type mtx_;
+                boost::uint64_t last_value_;
+                boost::uint64_t last_time_;
+            };
+
+          public:
+            explicit rate_counter(boost::atomic<boost::uint64_t> const& value)
+              : state_(boost::make_shared<state>(boost::cref(value)))
+            {}
+
+            boost::int64_t operator()(bool)
+            {
+                state& s = *state_;
+                boost::uint64_t const value = s.value_.load();
+                boost::uint64_t const time = io_statistics::now();
+
+                mutex_type::scoped_lock l(s.mtx_);
+
+                // the total may have been reset since the last query
+                boost::uint64_t const delta = (value >= s.last_value_) ?
+                    value - s.last_value_ : value;
+                double const elapsed = double(time - s.last_time_) * 1e-9;
+
+                s.last_value_ = value;
+                s.last_time_ = time;
+
+                if (elapsed <= 0.0)
+                {
+                    return 0;
+                }
+                return static_cast<boost::int64_t>(double(delta) / elapsed);
+            }
+
+          private:
+            boost::shared_ptr<state> state_;
+        };
+
+        inline boost::int64_t percentile_value(latency_histogram* h,
+            double fraction, bool reset)
+        {
+            boost::int64_t const result =
+                static_cast<boost::int64_t>(h->percentile(fraction));
+            if (reset)
+            {
+                h->reset();
+            }
+            return result;
+        }
+
+        inline boost::int64_t total_value(
+            boost::atomic<boost::uint64_t>* value, bool reset)
+        {
+            return static_cast<boost::int64_t>(
+                reset ? value->exchange(0) : value->load());
+        }
+
+        inline boost::int64_t queue_depth_value(io_statistics* stats, bool)
+        {
+            return stats->queue_depth();
+        }
+
+        inline void install_percentiles(std::string const& prefix,
+            latency_histogram& h, std::string const& what)
+        {
+            using hpx::performance_counters::install_counter_type;
+            using hpx::util::bind;
+            using hpx::util::placeholders::_1;
+
+            install_counter_type(prefix + "/p50",
+                bind(&percentile_value, &h, 0.5, _1),
+                "returns the median " + what, "ns");
+            install_counter_type(prefix + "/p99",
+                bind(&percentile_value, &h, 0.99, _1),
+                "returns the 99th percentile of the " + what, "ns");
+            install_counter_type(prefix + "/p999",
+                bind(&percentile_value, &h, 0.999, _1),
+                "returns the 99.9th percentile of the " + what, "ns");
+        }
+    }
+
+    // Register the performance counters of a backend on this locality, this
+    // has to be done at startup. For each operation type op there is
+    //
+    //   /hpxio{locality#*/total}/<backend>/<op>/latency/p50 (p99, p999)
+    //   /hpxio{locality#*/total}/<backend>/<op>/count        operations
+    //   /hpxio{locality#*/total}/<backend>/<op>/bytes        bytes moved
+    //   /hpxio{locality#*/total}/<backend>/<op>/count/rate   per second
+    //   /hpxio{locality#*/total}/<backend>/<op>/bytes/rate   per second
+    //
+    // plus <backend>/queue-depth and <backend>/io_pool/wait/p50 (p99, p999).
+    // Resetting a latency counter resets all percentiles of the operation.
+    inline void register_counters(std::string const& backend)
+    {
+        using hpx::performance_counters::install_counter_type;
+        using hpx::util::bind;
+        using hpx::util::placeholders::_1;
+
+        io_statistics& stats = io_statistics::get(backend);
+        std::string const base = "/hpxio/" + backend;
+
+        for (std::size_t i = 0; i != io_statistics::operation_count; ++i)
+        {
+            io_statistics::operation const op =
+                static_cast<io_statistics::operation>(i);
+            operation_statistics& s = stats[op];
+            std::string const prefix = base + "/" + io_statistics::name(op);
+            std::string const what =
+                std::string(io_statistics::name(op)) + " operations";
+
+            detail::install_percentiles(prefix + "/latency", s.latency_,
+                "latency of " + backend + " " + what);
+
+            install_counter_type(prefix + "/count",
+                bind(&detail::total_value, &s.count_, _1),
+                "returns the number of " + backend + " " + what);
+            install_counter_type(prefix + "/bytes",
+                bind(&detail::total_value, &s.bytes_, _1),
+                "returns the number of bytes transferred by " + backend +
+                " " + what, "bytes");
+
+            install_counter_type(prefix + "/count/rate",
+                detail::rate_counter(s.count_),
+                "returns the number of " + backend + " " + what +
+                " per second", "1/s");
+            install_counter_type(prefix + "/bytes/rate",
+                detail::rate_counter(s.bytes_),
+                "returns the number of bytes per second transferred by " +
+                backend + " " + what, "bytes/s");
+        }
+
+        install_counter_type(base + "/queue-depth",
+            bind(&detail::queue_depth_value, &stats, _1),
+            "returns the number of " + backend + " operations in progress");
+        detail::install_percentiles(base + "/io_pool/wait",
+            stats.io_pool_wait(),
+            "time " + backend + " requests waited for an io_pool thread");
+    }
+
+}}} // hpx::io::server
+
+#endif
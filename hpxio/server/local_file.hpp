@@ -8,15 +8,57 @@
 #define HPX_COMPONENTS_IO_SERVER_LOCAL_FILE_HPP_AUG_27_2014_1200AM
 
 #include <hpx/hpx_fwd.hpp>
+#include <hpx/include/runtime.hpp>
 #include <hpx/include/thread_executors.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/lcos/local/mutex.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
 #include <hpx/runtime/actions/component_action.hpp>
-#include <hpx/runtime/components/server/locking_hook.hpp>
+#include <hpx/runtime/components/new.hpp>
 #include <hpx/runtime/components/server/managed_component_base.hpp>
+#include <hpx/runtime/get_ptr.hpp>
+#include <hpx/util/serialize_buffer.hpp>
+#include <hpxio/copy_progress.hpp>
+#include <hpxio/directory_entry.hpp>
+#include <hpxio/extent.hpp>
+#include <hpxio/file_status.hpp>
+#include <hpxio/io_hints.hpp>
+#include <hpxio/open_mode.hpp>
+#include <hpxio/server/aligned_buffer.hpp>
+#include <hpxio/server/block_cache.hpp>
+#include <hpxio/server/collective_buffer.hpp>
+#include <hpxio/server/directory_table.hpp>
+#include <hpxio/server/file_copy.hpp>
+#include <hpxio/server/file_handle.hpp>
+#include <hpxio/server/group_commit.hpp>
+#include <hpxio/server/io_scheduler.hpp>
+#include <hpxio/server/io_statistics.hpp>
+#include <hpxio/server/metadata_batch.hpp>
+#include <hpxio/server/write_behind_buffer.hpp>
+#include <hpxio/server/uring_engine.hpp>
+#include <hpxio/server/vector_buffer.hpp>
 
+#include <boost/checked_delete.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+#include <algorithm>
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
+#include <limits>
 #include <vector>
 #include <string>
 
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #if defined(BOOST_MSVC)
 #ifdef _WIN64
 typedef __int64    ssize_t;
@@ -29,28 +71,119 @@ typedef _W64 int   ssize_t;
 namespace hpx { namespace io { namespace server
 {
     // local file class
-    // uses C style file APIs
+    // uses POSIX file descriptor APIs
+    //
+    // The component is not wrapped into a locking_hook: positional requests
+    // (pread/pwrite) carry their own offset and go straight to ::pread and
+    // ::pwrite, so independent requests on the same file are executed in
+    // parallel on the io_pool OS-threads. Sequential read/write/lseek share
+    // the kernel file offset, exactly like they do for a plain descriptor.
+    // Every request works on the file_handle of the file open when it
+    // started, open and close only replace the handle, so the descriptor
+    // stays valid until the last request using it is done.
+    //
+    // If the io_uring engine is available on this locality all requests but
+    // lseek are submitted to it instead and the calling HPX thread suspends
+    // until the completion arrives, no io_pool OS-thread is held meanwhile.
+    //
+    // read and pread are served from the per-locality block_cache if it is
+    // enabled. With write-behind enabled pwrite and pwritev only stage their
+    // data, it is written out by flush, close or once the staging thresholds
+    // are exceeded, a flush_timer takes care of data staged by the last
+    // write of a burst. close returns -1 if the staged data could not be
+    // written. fsync and fdatasync flush first and may be merged with
+    // concurrent requests through group commit.
+    //
+    // collective_write and collective_read make the component act as the
+    // aggregator of two-phase collective I/O, see collective_buffer.
+    //
+    // A 'd' in the open mode (e.g. "wd") opens the file with O_DIRECT,
+    // bypassing the page cache. Requests which are not aligned to
+    // hpxio.local_file.direct_alignment (default: 4096) in offset, size and
+    // buffer address go through an aligned bounce buffer, partially covered
+    // blocks of unaligned writes are read, modified and written back. Direct
+    // files do not use the block cache and the io_uring engine. File systems
+    // refusing O_DIRECT get a regular descriptor.
+    //
+    // open_many, stat_many, unlink_many and create_many handle whole lists
+    // of paths with one action, independent of the component's own file, as
+    // do the metadata operations stat, mkdir, rmdir, rename, truncate and
+    // the streamed directory listings (opendir, readdir, closedir).
+    //
+    // copy_to copies a range of the file into another local_file next to
+    // the data, see file_copy.
+    //
+    // Work for the io_pool is admitted by the io_scheduler according to the
+    // io_hints passed with the reads and writes, the vectored ones, flush
+    // and lseek and seek. Write-behind data is flushed with the hints of the request
+    // causing the flush. Server-side copies run in the background class.
+    //
+    // Latency, count and bytes of every operation and the time spent
+    // waiting for an io_pool thread are recorded in io_statistics and
+    // exposed as /hpxio/local_file/... performance counters.
     class local_file
-      : public components::locking_hook<
-            components::managed_component_base<local_file> >
+      : public components::managed_component_base<local_file>
     {
       public:
+        typedef hpx::util::serialize_buffer<char> buffer_type;
+
+        // shared with the direct path of the clients
+        static io_statistics& statistics()
+        {
+            static io_statistics& stats = io_statistics::get("local_file");
+            return stats;
+        }
+
+        // the admission of the work of this backend to the io_pool, shared
+        // with the requests a client serves directly
+        static io_scheduler& admission()
+        {
+            static io_scheduler& s = io_scheduler::get("local_file");
+            return s;
+        }
 
         local_file()
         {
-            fp_ = NULL;
-            file_name_.clear();
+            flush_timer_.start(write_behind_,
+                [this]()
+                {
+                    flush_if_due();
+                });
         }
 
         ~local_file()
         {
+            flush_timer_.stop();
+
+            // batches of group commit sync on separate HPX threads
+            fsync_commit_.wait();
+            fdatasync_commit_.wait();
+
             close();
         }
 
         void open(std::string const& name, std::string const& mode)
         {
+            operation_timer t(statistics(), io_statistics::open);
+
+            // staged data belongs to the file opened so far
+            flush(io_hints());
+
+            int const flags = mode_to_flags(mode);
+            if (flags >= 0 && (flags & O_TRUNC))
+            {
+                block_cache::get().invalidate(name);
+            }
+
+            if (uring_engine::get().is_available() &&
+                (flags < 0 || !is_direct(flags)))
+            {
+                open_uring(name, mode);
+                return;
+            }
+
             // Get a reference to one of the IO specific HPX io_service objects ...
-            hpx::threads::executors::io_pool_executor scheduler;
+            io_pool_scheduler scheduler(admission());
 
             // ... and schedule the handler to run on one of its OS-threads.
             scheduler.add(hpx::util::bind(&local_file::open_work, this,
@@ -62,46 +195,78 @@ namespace hpx { namespace io { namespace server
 
         void open_work(std::string const& name, std::string const& mode)
         {
-            if (fp_ != NULL)
+            close_work();
+
+            int flags = mode_to_flags(mode);
+            if (flags < 0)
+            {
+                return;
+            }
+
+            // O_APPEND ignores the offsets of pwrite, which direct writes
+            // need for their aligned blocks
+            bool const direct = is_direct(flags);
+            bool const append = direct && (flags & O_APPEND);
+            if (append)
             {
-                close();
+                flags &= ~O_APPEND;
+            }
+
+            int fd = ::open(name.c_str(), flags, 0644);
+            if (fd < 0 && direct && errno == EINVAL)
+            {
+                fd = ::open(name.c_str(), to_buffered(flags, append), 0644);
+                set_file(fd, name, false, false);
+            }
+            else
+            {
+                set_file(fd, name, direct, append);
             }
-            fp_ = fopen(name.c_str(), mode.c_str());
-            file_name_ = name;
         }
 
         bool is_open() const
         {
-            return fp_ != NULL;
+            return file().get() != 0;
         }
 
-        void close()
+        // returns -1 if staged data could not be written out
+        int close()
         {
-            // Get a reference to one of the IO specific HPX io_service objects ...
-            hpx::threads::executors::io_pool_executor scheduler;
-
-            // ... and schedule the handler to run on one of its OS-threads.
-            scheduler.add(hpx::util::bind(&local_file::close_work, this));
+            operation_timer t(statistics(), io_statistics::close);
+            int const result = flush(io_hints());
 
-            // Note that the destructor of the scheduler object will wait for
-            // the scheduled task to finish executing.
+            // the descriptor is closed by the last reference to its handle,
+            // on the io_pool if that is this one
+            handle_type f = exchange_file(handle_type());
+            if (f)
+            {
+                run_on_io_pool(admission(),
+                    [&f]()
+                    {
+                        f.reset();
+                    });
+            }
+            return result;
         }
 
         void close_work()
         {
-            if (fp_ != NULL)
-            {
-                std::fclose(fp_);
-                fp_ = NULL;
-            }
-            file_name_.clear();
+            exchange_file(handle_type());
         }
 
         int remove_file(std::string const& file_name)
         {
+            operation_timer t(statistics(), io_statistics::metadata);
+            block_cache::get().invalidate(file_name);
+
+            if (uring_engine::get().is_available())
+            {
+                return remove_file_uring(file_name);
+            }
+
             int result;
             {
-                hpx::threads::executors::io_pool_executor scheduler;
+                io_pool_scheduler scheduler(admission());
                 scheduler.add(hpx::util::bind(&local_file::remove_file_work,
                             this, boost::ref(file_name), boost::ref(result)));
             }
@@ -110,169 +275,1622 @@ namespace hpx { namespace io { namespace server
 
         void remove_file_work(std::string const& file_name, int &result)
         {
-            result = remove(file_name.c_str());
+            result = std::remove(file_name.c_str());
         }
 
-        std::vector<char> read(size_t const count)
+        std::vector<char> read(size_t const count,
+            io_hints const& hints = io_hints())
         {
             std::vector<char> result;
+            if (count > 0)
             {
-                hpx::threads::executors::io_pool_executor scheduler;
-                scheduler.add(hpx::util::bind(&local_file::read_work,
-                            this, count, boost::ref(result)));
+                // read straight into the result, no staging buffer
+                result.resize(count);
+                ssize_t len = read_into(result.data(), count, hints);
+                result.resize(len > 0 ? len : 0);
             }
             return result;
         }
 
-        void read_work(size_t const count, std::vector<char>& result)
+        std::vector<char> pread(size_t const count, off_t const offset,
+            io_hints const& hints = io_hints())
         {
-            if (fp_ == NULL || count <= 0)
+            std::vector<char> result;
+            if (count > 0 && offset >= 0)
             {
-                return;
+                result.resize(count);
+                ssize_t len =
+                    pread_into(result.data(), count, offset, hints);
+                result.resize(len > 0 ? len : 0);
+            }
+            return result;
+        }
+
+        // The buffer returned by read_buffer and pread_buffer is allocated
+        // once and filled directly by the kernel. It is handed over to the
+        // caller as is if the component is local and is sent as a zero-copy
+        // chunk if the caller lives on another locality.
+        buffer_type read_buffer(size_t const count, io_hints const& hints)
+        {
+            return read_into_buffer(count, -1, hints);
+        }
+
+        buffer_type pread_buffer(size_t const count, off_t const offset,
+            io_hints const& hints)
+        {
+            if (offset < 0)
+            {
+                return buffer_type();
+            }
+            return read_into_buffer(count, offset, hints);
+        }
+
+        // read into a caller supplied buffer, this is not exposed as an
+        // action and can only be used if the component is local
+        ssize_t read_into(char* buf, size_t const count,
+            io_hints const& hints = io_hints())
+        {
+            operation_timer t(statistics(), io_statistics::read);
+            flush_overlapping(0, std::numeric_limits<off_t>::max(), hints);
+
+            handle_type const f = file();
+            if (!f)
+            {
+                return 0;
+            }
+
+            if (block_cache::get().enabled() && !f->direct)
+            {
+                // go through the cache at the current file position
+                off_t const pos = ::lseek(f->fd, 0, SEEK_CUR);
+                if (pos < 0)
+                {
+                    return -1;
+                }
+
+                ssize_t len = pread_cached(*f, buf, count, pos, hints);
+                if (len > 0)
+                {
+                    ::lseek(f->fd, pos + len, SEEK_SET);
+                }
+                return t.transferred(len);
+            }
+
+            if (use_uring(*f))
+            {
+                return t.transferred(pread_uring(*f, buf, count, -1));
             }
 
-            std::unique_ptr<char> sp(new char[count]);
-            ssize_t len = fread(sp.get(), 1, count, fp_);
+            ssize_t result = 0;
+            {
+                io_pool_scheduler scheduler(admission(), hints);
+                scheduler.add(hpx::util::bind(&local_file::read_work,
+                            this, boost::ref(*f), buf, count,
+                            boost::ref(result)));
+            }
+            return t.transferred(result);
+        }
 
-            if (len == 0)
+        void read_work(file_handle const& f, char* buf, size_t const count,
+                ssize_t& result)
+        {
+            if (count <= 0)
             {
                 return;
             }
 
-            result.assign(sp.get(), sp.get() + len);
+            result = read_file(f, buf, count);
         }
 
-        std::vector<char> pread(size_t const count, off_t const offset)
+        ssize_t pread_into(char* buf, size_t const count, off_t const offset,
+            io_hints const& hints = io_hints())
         {
-            std::vector<char> result;
+            operation_timer t(statistics(), io_statistics::pread);
+            handle_type const f = file();
+            if (!f)
             {
-                hpx::threads::executors::io_pool_executor scheduler;
-                scheduler.add(hpx::util::bind(&local_file::pread_work,
-                            this, count, offset, boost::ref(result)));
+                return 0;
             }
-            return result;
+            return t.transferred(pread_cached(*f, buf, count, offset, hints));
         }
 
-        void pread_work(size_t const count, off_t const offset,
-                std::vector<char>& result)
+        ssize_t pread_cached(file_handle const& f, char* buf,
+                size_t const count, off_t const offset, io_hints const& hints)
         {
-            if (fp_ == NULL || count <= 0 || offset < 0)
+            if (offset < 0)
             {
-                return;
+                return 0;
             }
 
-            fpos_t pos;
-            if (fgetpos(fp_, &pos) != 0)
+            flush_overlapping(offset, count, hints);
+
+            block_cache& cache = block_cache::get();
+            if (cache.enabled() && !f.direct)
             {
-                return;
+                return cache.read(f.name, buf, count, offset,
+                    [this, &f, &hints](char* b, size_t c, off_t o)
+                    {
+                        return pread_direct(f, b, c, o, hints);
+                    });
             }
+            return pread_direct(f, buf, count, offset, hints);
+        }
+
+        // read bypassing the block cache
+        ssize_t pread_direct(file_handle const& f, char* buf,
+                size_t const count, off_t const offset, io_hints const& hints)
+        {
+            if (use_uring(f))
+            {
+                return pread_uring(f, buf, count, offset);
+            }
+
+            ssize_t result = 0;
+            {
+                io_pool_scheduler scheduler(admission(), hints);
+                scheduler.add(hpx::util::bind(&local_file::pread_work,
+                            this, boost::ref(f), buf, count, offset,
+                            boost::ref(result)));
+            }
+            return result;
+        }
 
-            if (fseek(fp_, offset, SEEK_SET) != 0)
+        void pread_work(file_handle const& f, char* buf, size_t const count,
+                off_t const offset, ssize_t& result)
+        {
+            if (count <= 0 || offset < 0)
             {
-                fsetpos(fp_, &pos);
                 return;
             }
 
-            read_work(count, result);
-            fsetpos(fp_, &pos);
+            result = pread_file(f, buf, count, offset);
         }
 
-        ssize_t write(std::vector<char> const& buf)
+        ssize_t write(buffer_type const& buf, io_hints const& hints)
         {
+            operation_timer t(statistics(), io_statistics::write);
+
+            handle_type const f = file();
+            if (!f)
+            {
+                return 0;
+            }
+
+            // the current position is not known here
+            block_cache::write_scope invalidate(f->name);
+            invalidate.add_file();
+            flush(hints);
+
+            if (use_uring(*f))
+            {
+                return t.transferred(pwrite_uring(*f, buf, -1));
+            }
+
             ssize_t result = 0;
             {
-                hpx::threads::executors::io_pool_executor scheduler;
+                io_pool_scheduler scheduler(admission(), hints);
                 scheduler.add(hpx::util::bind(&local_file::write_work,
-                            this, boost::ref(buf), boost::ref(result)));
+                            this, boost::ref(*f), boost::ref(buf),
+                            boost::ref(result)));
             }
-            return result;
+            return t.transferred(result);
         }
 
-        void write_work(std::vector<char> const& buf, ssize_t& result)
+        void write_work(file_handle const& f, buffer_type const& buf,
+                ssize_t& result)
         {
-            if (fp_ == NULL || buf.empty())
+            if (buf.size() == 0)
             {
                 return;
             }
-            result = fwrite(buf.data(), 1, buf.size(), fp_);
+            result = write_file(f, buf.data(), buf.size());
         }
 
-        ssize_t pwrite(std::vector<char> const& buf, off_t const offset)
+        ssize_t pwrite(buffer_type const& buf, off_t const offset,
+            io_hints const& hints)
         {
+            operation_timer t(statistics(), io_statistics::pwrite);
+
+            handle_type const f = file();
+            if (!f)
+            {
+                return 0;
+            }
+            block_cache::write_scope invalidate(f->name, offset, buf.size());
+
+            if (write_behind_.enabled())
+            {
+                if (buf.size() == 0 || offset < 0)
+                {
+                    return 0;
+                }
+                if (write_behind_.stage(buf.data(), buf.size(), offset))
+                {
+                    flush(hints);
+                }
+                return t.transferred(buf.size());
+            }
+
+            if (use_uring(*f))
+            {
+                if (offset < 0)
+                {
+                    return 0;
+                }
+                return t.transferred(pwrite_uring(*f, buf, offset));
+            }
+
             ssize_t result = 0;
             {
-                hpx::threads::executors::io_pool_executor scheduler;
+                io_pool_scheduler scheduler(admission(), hints);
                 scheduler.add(hpx::util::bind(&local_file::pwrite_work,
-                    this, boost::ref(buf), offset, boost::ref(result)));
+                    this, boost::ref(*f), boost::ref(buf), offset,
+                    boost::ref(result)));
             }
-            return result;
+            return t.transferred(result);
         }
 
-        void pwrite_work(std::vector<char> const& buf,
+        void pwrite_work(file_handle const& f, buffer_type const& buf,
                 off_t const offset, ssize_t& result)
         {
-            if (fp_ == NULL || buf.empty() || offset < 0)
+            if (buf.size() == 0 || offset < 0)
             {
                 return;
             }
+            result = pwrite_file(f, buf.data(), buf.size(), offset);
+        }
 
-            fpos_t pos;
-            if (fgetpos(fp_, &pos) != 0)
+        // Vectored positional I/O: all extents are handled by a single
+        // request. The data of the extents is concatenated in list order,
+        // as with ::preadv/::pwritev a short transfer of one extent ends the
+        // operation and only the bytes transferred so far are accounted for.
+        std::vector<char> preadv(std::vector<extent> const& extents,
+            io_hints const& hints = io_hints())
+        {
+            std::vector<char> result(total_count(extents));
+            if (!result.empty())
             {
-                return;
+                ssize_t len = preadv_into(extents, result.data(), hints);
+                result.resize(len > 0 ? len : 0);
+            }
+            return result;
+        }
+
+        buffer_type preadv_buffer(std::vector<extent> const& extents,
+            io_hints const& hints)
+        {
+            size_t const count = total_count(extents);
+            if (count == 0)
+            {
+                return buffer_type();
             }
 
-            if (fseek(fp_, offset, SEEK_SET) != 0)
+            char* data = new char[count];
+            ssize_t len = preadv_into(extents, data, hints);
+            if (len <= 0)
             {
-                fsetpos(fp_, &pos);
-                return;
+                delete [] data;
+                return buffer_type();
             }
 
-            write_work(buf, result);
-            fsetpos(fp_, &pos);
+            return buffer_type(data, len, buffer_type::take,
+                boost::checked_array_deleter<char>());
         }
 
-        int lseek(off_t const offset, int const whence)
+        // not exposed as an action, buf has to hold the data of all extents
+        ssize_t preadv_into(std::vector<extent> const& extents, char* buf,
+            io_hints const& hints = io_hints())
         {
-            int result;
+            operation_timer t(statistics(), io_statistics::preadv);
+            for (size_t i = 0; i != extents.size(); ++i)
+            {
+                flush_overlapping(extents[i].offset, extents[i].count, hints);
+            }
+
+            handle_type const f = file();
+            if (!f)
             {
-                hpx::threads::executors::io_pool_executor scheduler;
+                return 0;
+            }
+
+            ssize_t len = 0;
+            if (use_uring(*f))
+            {
+                len = preadv_uring(*f, extents, buf);
+            }
+            else
+            {
+                io_pool_scheduler scheduler(admission(), hints);
+                scheduler.add(hpx::util::bind(&local_file::preadv_work,
+                    this, boost::ref(*f), boost::ref(extents), buf,
+                    boost::ref(len)));
+            }
+            return t.transferred(len);
+        }
+
+        void preadv_work(file_handle const& f,
+                std::vector<extent> const& extents, char* buf,
+                ssize_t& result)
+        {
+            size_t done = 0;
+            for (size_t i = 0; i != extents.size(); ++i)
+            {
+                extent const& e = extents[i];
+                if (e.offset < 0)
+                {
+                    break;
+                }
+
+                ssize_t len = pread_file(f, buf + done, e.count, e.offset);
+                if (len > 0)
+                {
+                    done += len;
+                }
+                if (len < static_cast<ssize_t>(e.count))
+                {
+                    break;
+                }
+            }
+            result = done;
+        }
+
+        ssize_t pwritev(std::vector<extent> const& extents,
+                buffer_type const& buf, io_hints const& hints)
+        {
+            operation_timer t(statistics(), io_statistics::pwritev);
+            if (buf.size() == 0 || total_count(extents) != buf.size())
+            {
+                return 0;
+            }
+
+            handle_type const f = file();
+            if (!f)
+            {
+                return 0;
+            }
+
+            block_cache::write_scope invalidate(f->name);
+            for (size_t i = 0; i != extents.size(); ++i)
+            {
+                invalidate.add(extents[i].offset, extents[i].count);
+            }
+
+            if (write_behind_.enabled())
+            {
+                bool flush_due = false;
+                size_t pos = 0;
+                for (size_t i = 0; i != extents.size(); ++i)
+                {
+                    if (extents[i].offset < 0)
+                    {
+                        break;
+                    }
+                    flush_due = write_behind_.stage(buf.data() + pos,
+                        extents[i].count, extents[i].offset) || flush_due;
+                    pos += extents[i].count;
+                }
+
+                if (flush_due)
+                {
+                    flush(hints);
+                }
+                return t.transferred(pos);
+            }
+
+            if (use_uring(*f))
+            {
+                return t.transferred(
+                    pwritev_uring(*f, extents, buf.data()));
+            }
+
+            ssize_t result = 0;
+            {
+                io_pool_scheduler scheduler(admission(), hints);
+                scheduler.add(hpx::util::bind(&local_file::pwritev_work,
+                    this, boost::ref(*f), boost::ref(extents), buf.data(),
+                    boost::ref(result)));
+            }
+            return t.transferred(result);
+        }
+
+        void pwritev_work(file_handle const& f,
+                std::vector<extent> const& extents, char const* buf,
+                ssize_t& result)
+        {
+            size_t done = 0;
+            for (size_t i = 0; i != extents.size(); ++i)
+            {
+                extent const& e = extents[i];
+                if (e.offset < 0)
+                {
+                    break;
+                }
+
+                ssize_t len = pwrite_file(f, buf + done, e.count, e.offset);
+                if (len > 0)
+                {
+                    done += len;
+                }
+                if (len < static_cast<ssize_t>(e.count))
+                {
+                    break;
+                }
+            }
+            result = done;
+        }
+
+        // Write out everything staged by write-behind, returns -1 if any of
+        // the staged data could not be written. The data is written with the
+        // hints of the request causing the flush.
+        int flush(io_hints const& hints)
+        {
+            if (!write_behind_.enabled())
+            {
+                return 0;
+            }
+
+            flush_mutex_type::scoped_lock l(flush_mtx_);
+            if (write_behind_.empty())
+            {
+                return 0;
+            }
+
+            operation_timer t(statistics(), io_statistics::flush);
+            return flush_locked(hints);
+        }
+
+        // called by the flush_timer
+        void flush_if_due()
+        {
+            if (write_behind_.due())
+            {
+                flush(io_hints());
+            }
+        }
+
+        void flush_work(file_handle const& f,
+                write_behind_buffer::extent_map const& extents, int& result)
+        {
+            typedef write_behind_buffer::extent_map::const_iterator iterator;
+            for (iterator it = extents.begin(); it != extents.end(); ++it)
+            {
+                ssize_t len = pwrite_file(f, it->second.data(),
+                    it->second.size(), it->first);
+                if (len != static_cast<ssize_t>(it->second.size()))
+                {
+                    result = -1;
+                }
+            }
+        }
+
+        // Write out staged data and force the file to stable storage,
+        // returns 0 on success and -1 otherwise. fdatasync skips metadata
+        // which is not needed to read the data back.
+        int fsync()
+        {
+            operation_timer t(statistics(), io_statistics::fsync);
+            return sync_file(fsync_commit_, false);
+        }
+
+        int fdatasync()
+        {
+            operation_timer t(statistics(), io_statistics::fdatasync);
+            return sync_file(fdatasync_commit_, true);
+        }
+
+        void sync_work(file_handle const& f, bool const datasync,
+                int& result)
+        {
+            result = datasync ? ::fdatasync(f.fd) : ::fsync(f.fd);
+        }
+
+        // Two-phase collective I/O: the extents of all participants of a
+        // round are merged and written (or read) at once by the last
+        // participant to arrive.
+        ssize_t collective_write(boost::uint64_t const round,
+                size_t const participants, std::vector<extent> const& extents,
+                buffer_type const& buf)
+        {
+            // every participant has to join the round, even without a file
+            handle_type const f = file();
+
+            // the aggregator has written the round once write returns
+            block_cache::write_scope invalidate(f ? f->name : std::string());
+            for (size_t i = 0; i != extents.size(); ++i)
+            {
+                invalidate.add(extents[i].offset, extents[i].count);
+            }
+
+            return collective_.write(round, participants, extents, buf,
+                [this](write_behind_buffer::extent_map const& merged) -> int
+                {
+                    flush(io_hints());
+                    return write_extents(merged, io_hints());
+                });
+        }
+
+        buffer_type collective_read(boost::uint64_t const round,
+                size_t const participants, std::vector<extent> const& extents)
+        {
+            return to_buffer(collective_.read(round, participants, extents,
+                [this](char* b, size_t c, off_t o)
+                {
+                    return pread_into(b, c, o);
+                }));
+        }
+
+        // returns 0 on success and -1 otherwise
+        int lseek(off_t const offset, int const whence, io_hints const& hints)
+        {
+            return (seek(offset, whence, hints) < 0) ? -1 : 0;
+        }
+
+        // as lseek, but returns the resulting offset as the other file
+        // types do
+        off_t seek(off_t const offset, int const whence,
+            io_hints const& hints)
+        {
+            operation_timer t(statistics(), io_statistics::lseek);
+            handle_type const f = file();
+            if (!f)
+            {
+                return -1;
+            }
+
+            off_t result;
+            {
+                io_pool_scheduler scheduler(admission(), hints);
                 scheduler.add(hpx::util::bind(&local_file::lseek_work,
-                    this, offset, whence, boost::ref(result)));
+                    this, boost::ref(*f), offset, whence,
+                    boost::ref(result)));
             }
             return result;
         }
 
-        void lseek_work(off_t const offset, int const whence, int& result)
+        void lseek_work(file_handle const& f, off_t const offset,
+                int const whence, off_t& result)
         {
-            if (fp_ == NULL)
+            result = ::lseek(f.fd, offset, whence);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Batched metadata operations, the paths are handled in parallel on
+        // the io_pool and the results are returned in the order of the paths.
+        // They do not touch the file opened by this component.
+
+        // create and open one local_file component on this locality for each
+        // path, an invalid id marks the paths which could not be opened
+        std::vector<naming::id_type> open_many(
+            std::vector<std::string> const& names, std::string const& mode)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            int const flags = mode_to_flags(mode);
+            if (flags >= 0 && (flags & O_TRUNC))
             {
-                result = -1;
-                return;
+                for (std::size_t i = 0; i != names.size(); ++i)
+                {
+                    block_cache::get().invalidate(names[i]);
+                }
+            }
+
+            std::vector<lcos::future<naming::id_type> > lazy_ids;
+            lazy_ids.reserve(names.size());
+            for (std::size_t i = 0; i != names.size(); ++i)
+            {
+                lazy_ids.push_back(hpx::new_<local_file>(hpx::find_here()));
+            }
+
+            std::vector<naming::id_type> ids;
+            std::vector<boost::shared_ptr<local_file> > files;
+            ids.reserve(names.size());
+            files.reserve(names.size());
+            for (std::size_t i = 0; i != names.size(); ++i)
+            {
+                ids.push_back(lazy_ids[i].get());
+                files.push_back(hpx::get_ptr<local_file>(ids.back()).get());
             }
 
-            result = fseek(fp_, offset, whence);
+            run_batch(admission(), names.size(),
+                [&files, &names, &mode](std::size_t i)
+                {
+                    files[i]->open_work(names[i], mode);
+                });
+
+            for (std::size_t i = 0; i != files.size(); ++i)
+            {
+                if (!files[i]->is_open())
+                {
+                    ids[i] = naming::invalid_id;
+                }
+            }
+            return ids;
         }
 
-        ///////////////////////////////////////////////////////////////////////
-        // Each of the exposed functions needs to be encapsulated into a action
-        // type, allowing to generate all require boilerplate code for threads,
-        // serialization, etc.
-        HPX_DEFINE_COMPONENT_ACTION(local_file, open);
-        HPX_DEFINE_COMPONENT_ACTION(local_file, is_open);
-        HPX_DEFINE_COMPONENT_ACTION(local_file, close);
-        HPX_DEFINE_COMPONENT_ACTION(local_file, remove_file);
-        HPX_DEFINE_COMPONENT_ACTION(local_file, read);
-        HPX_DEFINE_COMPONENT_ACTION(local_file, pread);
-        HPX_DEFINE_COMPONENT_ACTION(local_file, write);
-        HPX_DEFINE_COMPONENT_ACTION(local_file, pwrite);
-        HPX_DEFINE_COMPONENT_ACTION(local_file, lseek);
+        std::vector<file_status> stat_many(
+            std::vector<std::string> const& paths)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            std::vector<file_status> result(paths.size());
+            run_batch(admission(), paths.size(),
+                [&result, &paths](std::size_t i)
+                {
+                    struct stat st;
+                    if (::stat(paths[i].c_str(), &st) == 0)
+                    {
+                        result[i] = file_status(st);
+                    }
+                });
+            return result;
+        }
 
-      private:
-        typedef components::managed_component_base<local_file> base_type;
+        // returns 0 for each path removed, -1 otherwise
+        std::vector<int> unlink_many(std::vector<std::string> const& paths)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            for (std::size_t i = 0; i != paths.size(); ++i)
+            {
+                block_cache::get().invalidate(paths[i]);
+            }
+
+            std::vector<int> result(paths.size(), -1);
+            run_batch(admission(), paths.size(),
+                [&result, &paths](std::size_t i)
+                {
+                    result[i] = (::unlink(paths[i].c_str()) == 0) ? 0 : -1;
+                });
+            return result;
+        }
+
+        // create empty files, existing ones are truncated; returns 0 for
+        // each file created, -1 otherwise
+        std::vector<int> create_many(std::vector<std::string> const& paths)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            for (std::size_t i = 0; i != paths.size(); ++i)
+            {
+                block_cache::get().invalidate(paths[i]);
+            }
+
+            std::vector<int> result(paths.size(), -1);
+            run_batch(admission(), paths.size(),
+                [&result, &paths](std::size_t i)
+                {
+                    int const fd = ::open(paths[i].c_str(),
+                        O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                    if (fd >= 0)
+                    {
+                        result[i] = (::close(fd) == 0) ? 0 : -1;
+                    }
+                });
+            return result;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Metadata operations on arbitrary paths, the calls are run on the
+        // io_pool. The int results are 0 on success and -1 otherwise.
+        file_status stat(std::string const& path)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            file_status result;
+            run_on_io_pool(admission(),
+                [&result, &path]()
+                {
+                    struct stat st;
+                    if (::stat(path.c_str(), &st) == 0)
+                    {
+                        result = file_status(st);
+                    }
+                });
+            return result;
+        }
+
+        int mkdir(std::string const& path, int const mode)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            int result = -1;
+            run_on_io_pool(admission(),
+                [&result, &path, mode]()
+                {
+                    result = (::mkdir(path.c_str(), mode) == 0) ? 0 : -1;
+                });
+            return result;
+        }
+
+        int rmdir(std::string const& path)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            int result = -1;
+            run_on_io_pool(admission(),
+                [&result, &path]()
+                {
+                    result = (::rmdir(path.c_str()) == 0) ? 0 : -1;
+                });
+            return result;
+        }
+
+        int rename(std::string const& from, std::string const& to)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            block_cache::get().invalidate(from);
+            block_cache::get().invalidate(to);
+
+            int result = -1;
+            run_on_io_pool(admission(),
+                [&result, &from, &to]()
+                {
+                    result = (::rename(from.c_str(), to.c_str()) == 0) ?
+                        0 : -1;
+                });
+            return result;
+        }
+
+        int truncate(std::string const& path, off_t const length)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            block_cache::get().invalidate(path);
+
+            int result = -1;
+            run_on_io_pool(admission(),
+                [&result, &path, length]()
+                {
+                    result = (::truncate(path.c_str(), length) == 0) ?
+                        0 : -1;
+                });
+            return result;
+        }
+
+        // Directory listings are streamed: opendir returns a handle (0 if
+        // the directory could not be opened), each readdir returns the next
+        // batch of up to count entries, an empty batch marks the end.
+        // closedir releases the handle.
+        boost::uint64_t opendir(std::string const& path)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            boost::shared_ptr<local_directory> dir;
+            run_on_io_pool(admission(),
+                [&dir, &path]()
+                {
+                    dir = boost::make_shared<local_directory>(path);
+                });
+            return dir->is_open() ? directories_.add(dir) : 0;
+        }
+
+        std::vector<directory_entry> readdir(boost::uint64_t const handle,
+            std::size_t const count)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            std::vector<directory_entry> result;
+            boost::shared_ptr<local_directory> dir = directories_.get(handle);
+            if (dir)
+            {
+                run_on_io_pool(admission(),
+                    [&result, &dir, count]()
+                    {
+                        result = dir->read(count);
+                    });
+            }
+            return result;
+        }
+
+        int closedir(boost::uint64_t const handle)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            boost::shared_ptr<local_directory> dir =
+                directories_.remove(handle);
+            if (!dir)
+            {
+                return -1;
+            }
+
+            // the stream is closed by the last reference going away
+            run_on_io_pool(admission(),
+                [&dir]()
+                {
+                    dir.reset();
+                });
+            return 0;
+        }
+
+        // Server-side copy of count bytes from src_offset of this file to
+        // dst_offset of the local_file dest. The copy runs in the background
+        // next to this file's data, copy_to returns a handle for copy_status
+        // and copy_wait, copy_wait returns the number of bytes copied and
+        // releases the handle. self has to refer to this component, it keeps
+        // the component alive while the copy is running.
+        boost::uint64_t copy_to(naming::id_type const& self,
+            naming::id_type const& dest, off_t const src_offset,
+            off_t const dst_offset, boost::uint64_t const count)
+        {
+            boost::shared_ptr<copy_job> job =
+                boost::make_shared<copy_job>(count);
+            job->start(hpx::async(hpx::util::bind(&local_file::copy_work,
+                this, self, dest, src_offset, dst_offset, job)));
+            return copies_.add(job);
+        }
+
+        copy_progress copy_status(boost::uint64_t const handle)
+        {
+            boost::shared_ptr<copy_job> job = copies_.get(handle);
+            return job ? job->progress() : unknown_copy();
+        }
+
+        ssize_t copy_wait(boost::uint64_t const handle)
+        {
+            boost::shared_ptr<copy_job> job = copies_.get(handle);
+            if (!job)
+            {
+                return -1;
+            }
+
+            ssize_t const result = job->wait();
+            copies_.remove(handle);
+            return result;
+        }
+
+        // Both files on this locality are copied by the kernel if possible,
+        // otherwise the chunks read here are written by pwrite actions on
+        // dest, directly from the buffers they were read into.
+        ssize_t copy_work(naming::id_type const&, naming::id_type const& dest,
+            off_t const src_offset, off_t const dst_offset,
+            boost::shared_ptr<copy_job> const& job)
+        {
+            if (!is_open() || src_offset < 0 || dst_offset < 0)
+            {
+                return -1;
+            }
+
+            if (naming::get_locality_from_id(dest) == hpx::find_here())
+            {
+                ssize_t len = copy_local(
+                    *hpx::get_ptr<local_file>(dest).get(), src_offset,
+                    dst_offset, *job);
+                if (len >= 0)
+                {
+                    return len;
+                }
+            }
+
+            // copies do not hold up other requests to the files
+            io_hints const hints(io_priority_background);
+            return pipelined_copy(
+                [this, hints](size_t n, off_t o)
+                {
+                    return hpx::async(hpx::util::bind(
+                        &local_file::pread_buffer, this, n, o, hints));
+                },
+                [dest, hints](buffer_type const& data, off_t o)
+                {
+                    return hpx::async<pwrite_action>(dest, data, o, hints);
+                },
+                src_offset, dst_offset, *job);
+        }
+
+        ssize_t copy_local(local_file& dest, off_t const src_offset,
+            off_t const dst_offset, copy_job& job)
+        {
+            handle_type const in = file();
+            handle_type const out = dest.file();
+            if (!in || !out)
+            {
+                return -1;
+            }
+
+            // the kernel only sees what has been written out, copies do not
+            // hold up other requests to the files
+            io_hints const hints(io_priority_background);
+            flush(hints);
+            dest.flush(hints);
+            block_cache::write_scope invalidate(out->name, dst_offset,
+                job.count());
+
+            ssize_t result = -1;
+            run_on_io_pool(admission(), hints,
+                [&]()
+                {
+                    result = kernel_copy(in->fd, src_offset, out->fd,
+                        out->name, dst_offset, job);
+                });
+            return result;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // io_uring backed implementation, an offset of -1 means the current
+        // file position
+        void open_uring(std::string const& name, std::string const& mode)
+        {
+            close_work();
+
+            int const flags = mode_to_flags(mode);
+            if (flags < 0)
+            {
+                return;
+            }
+
+            int const fd =
+                uring_engine::get().open(name.c_str(), flags, 0644).get();
+            set_file(fd, name, false, false);
+        }
+
+        int remove_file_uring(std::string const& file_name)
+        {
+            return (uring_engine::get().unlink(file_name.c_str()).get() < 0) ?
+                -1 : 0;
+        }
+
+        ssize_t pread_uring(file_handle const& f, char* buf,
+                size_t const count, off_t const offset)
+        {
+            if (count <= 0)
+            {
+                return 0;
+            }
+
+            uring_engine& engine = uring_engine::get();
+
+            size_t done = 0;
+            while (done < count)
+            {
+                ssize_t len = engine.read(f.fd, buf + done, count - done,
+                    (offset < 0) ? -1 : off_t(offset + done)).get();
+                if (len <= 0)
+                {
+                    if (len == -EINTR) continue;
+                    if (len == -EAGAIN)
+                    {
+                        // let other threads run before trying again
+                        hpx::this_thread::suspend();
+                        continue;
+                    }
+                    return done ? static_cast<ssize_t>(done) : len;
+                }
+                done += len;
+            }
+            return done;
+        }
+
+        // all extents are submitted before waiting for the first one
+        ssize_t preadv_uring(file_handle const& f,
+            std::vector<extent> const& extents, char* buf)
+        {
+            uring_engine& engine = uring_engine::get();
+
+            std::vector<hpx::future<ssize_t> > lazy_results;
+            lazy_results.reserve(extents.size());
+
+            size_t pos = 0;
+            for (size_t i = 0; i != extents.size(); ++i)
+            {
+                extent const& e = extents[i];
+                if (e.offset < 0)
+                {
+                    break;
+                }
+                lazy_results.push_back(
+                    engine.read(f.fd, buf + pos, e.count, e.offset));
+                pos += e.count;
+            }
+
+            return sum_transfers(extents, lazy_results);
+        }
+
+        ssize_t pwritev_uring(file_handle const& f,
+            std::vector<extent> const& extents, char const* buf)
+        {
+            uring_engine& engine = uring_engine::get();
+
+            std::vector<hpx::future<ssize_t> > lazy_results;
+            lazy_results.reserve(extents.size());
+
+            size_t pos = 0;
+            for (size_t i = 0; i != extents.size(); ++i)
+            {
+                extent const& e = extents[i];
+                if (e.offset < 0)
+                {
+                    break;
+                }
+                lazy_results.push_back(
+                    engine.write(f.fd, buf + pos, e.count, e.offset));
+                pos += e.count;
+            }
+
+            return sum_transfers(extents, lazy_results);
+        }
+
+        ssize_t pwrite_uring(file_handle const& f, buffer_type const& buf,
+                off_t const offset)
+        {
+            if (buf.size() == 0)
+            {
+                return 0;
+            }
+
+            uring_engine& engine = uring_engine::get();
+
+            size_t done = 0;
+            while (done < buf.size())
+            {
+                ssize_t len = engine.write(f.fd, buf.data() + done,
+                    buf.size() - done,
+                    (offset < 0) ? -1 : off_t(offset + done)).get();
+                if (len <= 0)
+                {
+                    if (len == -EINTR) continue;
+                    if (len == -EAGAIN)
+                    {
+                        // let other threads run before trying again
+                        hpx::this_thread::suspend();
+                        continue;
+                    }
+                    return done ? static_cast<ssize_t>(done) : len;
+                }
+                done += len;
+            }
+            return done;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Each of the exposed functions needs to be encapsulated into a action
+        // type, allowing to generate all require boilerplate code for threads,
+        // serialization, etc.
+        HPX_DEFINE_COMPONENT_ACTION(local_file, open);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, is_open);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, close);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, remove_file);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, read_buffer);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, pread_buffer);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, write);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, pwrite);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, preadv_buffer);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, pwritev);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, flush);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, fsync);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, fdatasync);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, collective_write);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, collective_read);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, lseek);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, seek);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, open_many);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, stat_many);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, unlink_many);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, create_many);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, stat);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, mkdir);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, rmdir);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, rename);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, truncate);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, opendir);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, readdir);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, closedir);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, copy_to);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, copy_status);
+        HPX_DEFINE_COMPONENT_ACTION(local_file, copy_wait);
+
+      private:
+        typedef components::managed_component_base<local_file> base_type;
+        typedef hpx::lcos::local::mutex flush_mutex_type;
+        typedef hpx::lcos::local::spinlock file_mutex_type;
+        typedef boost::shared_ptr<file_handle> handle_type;
+
+        // the handle of the file open right now, empty if there is none
+        handle_type file() const
+        {
+            file_mutex_type::scoped_lock l(file_mtx_);
+            return file_;
+        }
+
+        handle_type exchange_file(handle_type f)
+        {
+            file_mutex_type::scoped_lock l(file_mtx_);
+            file_.swap(f);
+            return f;
+        }
+
+        void set_file(int const fd, std::string const& name,
+            bool const direct, bool const append)
+        {
+            if (fd >= 0)
+            {
+                exchange_file(boost::make_shared<file_handle>(fd, name,
+                    direct, append));
+            }
+        }
+
+        int flush_locked(io_hints const& hints)
+        {
+            return write_extents(write_behind_.take(), hints);
+        }
+
+        // write out non-overlapping ranges, returns -1 if any of them could
+        // not be written completely. Reads fill whole blocks and read ahead,
+        // so the cache may hold neighbours of a read range which were
+        // fetched while their data was still staged, all written ranges are
+        // invalidated once they have landed.
+        int write_extents(write_behind_buffer::extent_map const& extents,
+            io_hints const& hints)
+        {
+            if (extents.empty())
+            {
+                return 0;
+            }
+
+            handle_type const f = file();
+            if (!f)
+            {
+                return -1;
+            }
+
+            typedef write_behind_buffer::extent_map::const_iterator iterator;
+
+            block_cache::write_scope invalidate(f->name);
+            for (iterator it = extents.begin(); it != extents.end(); ++it)
+            {
+                invalidate.add(it->first, it->second.size());
+            }
+
+            int result = 0;
+            if (use_uring(*f))
+            {
+                // all staged ranges are in flight at the same time
+                uring_engine& engine = uring_engine::get();
+                std::vector<hpx::future<ssize_t> > lazy_results;
+                lazy_results.reserve(extents.size());
+
+                for (iterator it = extents.begin(); it != extents.end(); ++it)
+                {
+                    lazy_results.push_back(engine.write(f->fd,
+                        it->second.data(), it->second.size(), it->first));
+                }
+
+                iterator it = extents.begin();
+                for (size_t i = 0; i != lazy_results.size(); ++i, ++it)
+                {
+                    if (lazy_results[i].get() !=
+                        static_cast<ssize_t>(it->second.size()))
+                    {
+                        result = -1;
+                    }
+                }
+            }
+            else
+            {
+                io_pool_scheduler scheduler(admission(), hints);
+                scheduler.add(hpx::util::bind(&local_file::flush_work,
+                    this, boost::ref(*f), boost::ref(extents),
+                    boost::ref(result)));
+            }
+            return result;
+        }
+
+        // every caller flushes its own staged data before it joins a sync
+        int sync_file(group_commit& commit, bool const datasync)
+        {
+            if (flush(io_hints()) != 0)
+            {
+                return -1;
+            }
+
+            return commit.run(
+                [this, datasync]()
+                {
+                    return sync_direct(datasync);
+                });
+        }
+
+        int sync_direct(bool const datasync)
+        {
+            handle_type const f = file();
+            if (!f)
+            {
+                return -1;
+            }
+
+            if (uring_engine::get().is_available())
+            {
+                return (uring_engine::get().fsync(f->fd, datasync).get() < 0) ?
+                    -1 : 0;
+            }
+
+            int result = -1;
+            {
+                io_pool_scheduler scheduler(admission());
+                scheduler.add(hpx::util::bind(&local_file::sync_work,
+                    this, boost::ref(*f), datasync, boost::ref(result)));
+            }
+            return result;
+        }
+
+        // make sure reads see data still sitting in the write-behind buffer
+        void flush_overlapping(off_t const offset, size_t const count,
+            io_hints const& hints)
+        {
+            if (!write_behind_.enabled())
+            {
+                return;
+            }
+
+            flush_mutex_type::scoped_lock l(flush_mtx_);
+            if (write_behind_.overlaps(offset, count))
+            {
+                flush_locked(hints);
+            }
+        }
+
+        buffer_type read_into_buffer(size_t const count, off_t const offset,
+            io_hints const& hints)
+        {
+            if (count <= 0)
+            {
+                return buffer_type();
+            }
+
+            handle_type const f = file();
+            if (f && f->direct)
+            {
+                // aligned requests can be read without a bounce buffer
+                aligned_buffer data(count, direct_alignment());
+                ssize_t len = (offset < 0) ?
+                    read_into(data.data(), count, hints) :
+                    pread_into(data.data(), count, offset, hints);
+
+                if (len <= 0)
+                {
+                    return buffer_type();
+                }
+
+                return buffer_type(data.release(), len, buffer_type::take,
+                    aligned_buffer::deleter());
+            }
+
+            char* data = new char[count];
+            ssize_t len = (offset < 0) ? read_into(data, count, hints) :
+                pread_into(data, count, offset, hints);
+
+            if (len <= 0)
+            {
+                delete [] data;
+                return buffer_type();
+            }
+
+            return buffer_type(data, len, buffer_type::take,
+                boost::checked_array_deleter<char>());
+        }
+
+        // add up the lengths of the extents transferred back to back,
+        // waiting for all requests as their buffers are still in use
+        static ssize_t sum_transfers(std::vector<extent> const& extents,
+            std::vector<hpx::future<ssize_t> >& lazy_results)
+        {
+            size_t done = 0;
+            bool short_transfer = false;
+            for (size_t i = 0; i != lazy_results.size(); ++i)
+            {
+                ssize_t len = lazy_results[i].get();
+                if (short_transfer)
+                {
+                    continue;
+                }
+                if (len > 0)
+                {
+                    done += len;
+                }
+                short_transfer = len < static_cast<ssize_t>(extents[i].count);
+            }
+            return done;
+        }
+
+        static bool is_direct(int flags)
+        {
+#if defined(O_DIRECT)
+            return (flags & O_DIRECT) != 0;
+#else
+            return false;
+#endif
+        }
+
+        static int to_buffered(int flags, bool append)
+        {
+#if defined(O_DIRECT)
+            flags &= ~O_DIRECT;
+#endif
+            return append ? (flags | O_APPEND) : flags;
+        }
+
+        static size_t direct_alignment()
+        {
+            static size_t const alignment = (std::max)(size_t(512),
+                boost::lexical_cast<size_t>(hpx::get_config_entry(
+                    "hpxio.local_file.direct_alignment", "4096")));
+            return alignment;
+        }
+
+        // direct files are not handed to the io_uring engine
+        static bool use_uring(file_handle const& f)
+        {
+            return !f.direct && uring_engine::get().is_available();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // The transfer helpers used by the io_pool work functions, they take
+        // care of the alignment requirements of direct files. Sequential
+        // requests on direct files are turned into positional ones at the
+        // current file position (or the end of file for append mode).
+        ssize_t read_file(file_handle const& f, char* buf, size_t count)
+        {
+            if (!f.direct)
+            {
+                return read_fully(f.fd, buf, count);
+            }
+
+            off_t const pos = ::lseek(f.fd, 0, SEEK_CUR);
+            if (pos < 0)
+            {
+                return -1;
+            }
+
+            ssize_t len = pread_aligned(f.fd, buf, count, pos);
+            if (len > 0)
+            {
+                ::lseek(f.fd, pos + len, SEEK_SET);
+            }
+            return len;
+        }
+
+        ssize_t write_file(file_handle const& f, char const* buf,
+            size_t count)
+        {
+            if (!f.direct)
+            {
+                return write_fully(f.fd, buf, count);
+            }
+
+            if (f.append)
+            {
+                return append_aligned(f.fd, buf, count);
+            }
+
+            off_t const pos = ::lseek(f.fd, 0, SEEK_CUR);
+            if (pos < 0)
+            {
+                return -1;
+            }
+
+            ssize_t len = pwrite_aligned(f.fd, buf, count, pos);
+            if (len > 0)
+            {
+                ::lseek(f.fd, pos + len, SEEK_SET);
+            }
+            return len;
+        }
+
+        ssize_t pread_file(file_handle const& f, char* buf, size_t count,
+            off_t offset)
+        {
+            return f.direct ? pread_aligned(f.fd, buf, count, offset) :
+                pread_fully(f.fd, buf, count, offset);
+        }
+
+        ssize_t pwrite_file(file_handle const& f, char const* buf,
+            size_t count, off_t offset)
+        {
+            return f.direct ? pwrite_aligned(f.fd, buf, count, offset) :
+                pwrite_fully(f.fd, buf, count, offset);
+        }
+
+        ssize_t pread_aligned(int fd, char* buf, size_t count, off_t offset)
+        {
+            size_t const a = direct_alignment();
+            off_t const begin = offset - offset % a;
+            off_t const end = ((offset + count + a - 1) / a) * a;
+
+            if (begin == offset && end == off_t(offset + count) &&
+                aligned_buffer::is_aligned(buf, a))
+            {
+                return pread_fully(fd, buf, count, offset);
+            }
+
+            aligned_buffer tmp(end - begin, a);
+            if (tmp.size() == 0)
+            {
+                return -1;
+            }
+
+            ssize_t len = pread_fully(fd, tmp.data(), tmp.size(), begin);
+            if (len <= offset - begin)
+            {
+                return (len < 0) ? -1 : 0;
+            }
+
+            size_t const n = (std::min)(count, size_t(len - (offset - begin)));
+            std::memcpy(buf, tmp.data() + (offset - begin), n);
+            return n;
+        }
+
+        // the end of file must not move between looking it up and writing
+        // there, the whole append holds the lock exclusively
+        ssize_t append_aligned(int fd, char const* buf, size_t count)
+        {
+            boost::unique_lock<boost::shared_mutex> l(direct_mtx_);
+
+            struct stat st;
+            if (::fstat(fd, &st) != 0)
+            {
+                return -1;
+            }
+
+            ssize_t len = pwrite_aligned_locked(fd, buf, count, st.st_size);
+            if (len > 0)
+            {
+                ::lseek(fd, st.st_size + len, SEEK_SET);
+            }
+            return len;
+        }
+
+        ssize_t pwrite_aligned(int fd, char const* buf, size_t count,
+            off_t offset)
+        {
+            size_t const a = direct_alignment();
+            if (offset % a == 0 && count % a == 0 &&
+                aligned_buffer::is_aligned(buf, a))
+            {
+                // whole blocks may go in parallel, but not while a partial
+                // block is being modified
+                boost::shared_lock<boost::shared_mutex> l(direct_mtx_);
+                return pwrite_fully(fd, buf, count, offset);
+            }
+
+            boost::unique_lock<boost::shared_mutex> l(direct_mtx_);
+            return pwrite_aligned_locked(fd, buf, count, offset);
+        }
+
+        // direct_mtx_ has to be held exclusively
+        ssize_t pwrite_aligned_locked(int fd, char const* buf, size_t count,
+            off_t offset)
+        {
+            size_t const a = direct_alignment();
+            off_t const begin = offset - offset % a;
+            off_t const end = ((offset + count + a - 1) / a) * a;
+
+            if (begin == offset && end == off_t(offset + count) &&
+                aligned_buffer::is_aligned(buf, a))
+            {
+                return pwrite_fully(fd, buf, count, offset);
+            }
+
+            aligned_buffer tmp(end - begin, a);
+            if (tmp.size() == 0)
+            {
+                return -1;
+            }
+            std::memset(tmp.data(), 0, tmp.size());
+
+            struct stat st;
+            if (::fstat(fd, &st) != 0)
+            {
+                return -1;
+            }
+
+            // fill in the partially covered head and tail blocks, beyond the
+            // end of file they stay zero
+            bool const partial_head = begin != offset;
+            bool const partial_tail = end != off_t(offset + count);
+            if (partial_head)
+            {
+                pread_fully(fd, tmp.data(), a, begin);
+            }
+            if (partial_tail && (end - off_t(a) != begin || !partial_head))
+            {
+                pread_fully(fd, tmp.data() + (end - a - begin), a, end - a);
+            }
+
+            std::memcpy(tmp.data() + (offset - begin), buf, count);
+
+            ssize_t len = pwrite_fully(fd, tmp.data(), tmp.size(), begin);
+            if (len == ssize_t(tmp.size()))
+            {
+                // drop the padding of the last block again
+                off_t const size = (std::max)(off_t(st.st_size),
+                    off_t(offset + count));
+                if (end > size && ::ftruncate(fd, size) != 0)
+                {
+                    return -1;
+                }
+                return count;
+            }
+
+            if (len <= offset - begin)
+            {
+                return (len < 0) ? -1 : 0;
+            }
+            return (std::min)(count, size_t(len - (offset - begin)));
+        }
+
+        // the helpers below retry short transfers the way fread/fwrite do,
+        // stopping at end of file or on the first error
+        static ssize_t read_fully(int fd, char* buf, size_t count)
+        {
+            size_t done = 0;
+            while (done < count)
+            {
+                ssize_t len = ::read(fd, buf + done, count - done);
+                if (len <= 0)
+                {
+                    if (len < 0 && errno == EINTR) continue;
+                    return done ? static_cast<ssize_t>(done) : len;
+                }
+                done += len;
+            }
+            return done;
+        }
+
+        static ssize_t pread_fully(int fd, char* buf, size_t count,
+                off_t offset)
+        {
+            size_t done = 0;
+            while (done < count)
+            {
+                ssize_t len = ::pread(fd, buf + done, count - done,
+                    offset + done);
+                if (len <= 0)
+                {
+                    if (len < 0 && errno == EINTR) continue;
+                    return done ? static_cast<ssize_t>(done) : len;
+                }
+                done += len;
+            }
+            return done;
+        }
+
+        static ssize_t write_fully(int fd, char const* buf, size_t count)
+        {
+            size_t done = 0;
+            while (done < count)
+            {
+                ssize_t len = ::write(fd, buf + done, count - done);
+                if (len <= 0)
+                {
+                    if (len < 0 && errno == EINTR) continue;
+                    return done ? static_cast<ssize_t>(done) : len;
+                }
+                done += len;
+            }
+            return done;
+        }
+
+        static ssize_t pwrite_fully(int fd, char const* buf, size_t count,
+                off_t offset)
+        {
+            size_t done = 0;
+            while (done < count)
+            {
+                ssize_t len = ::pwrite(fd, buf + done, count - done,
+                    offset + done);
+                if (len <= 0)
+                {
+                    if (len < 0 && errno == EINTR) continue;
+                    return done ? static_cast<ssize_t>(done) : len;
+                }
+                done += len;
+            }
+            return done;
+        }
+
+        mutable file_mutex_type file_mtx_;
+        handle_type file_;
+
+        boost::shared_mutex direct_mtx_;
+
+        write_behind_buffer write_behind_;
+        flush_mutex_type flush_mtx_;
+        flush_timer flush_timer_;
+
+        group_commit fsync_commit_;
+        group_commit fdatasync_commit_;
+
+        collective_buffer collective_;
 
-        std::FILE *fp_;
-        std::string file_name_;
+        directory_table<local_directory> directories_;
+        directory_table<copy_job> copies_;
     };
 
 }}} // hpx::io::server
@@ -287,16 +1905,70 @@ HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::close_action,
         local_file_close_action)
 HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::remove_file_action,
         local_file_remove_file_action)
-HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::read_action,
-        local_file_read_action)
-HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::pread_action,
-        local_file_pread_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::read_buffer_action,
+        local_file_read_buffer_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::pread_buffer_action,
+        local_file_pread_buffer_action)
 HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::write_action,
         local_file_write_action)
 HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::pwrite_action,
         local_file_pwrite_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::local_file::preadv_buffer_action,
+        local_file_preadv_buffer_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::pwritev_action,
+        local_file_pwritev_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::flush_action,
+        local_file_flush_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::fsync_action,
+        local_file_fsync_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::fdatasync_action,
+        local_file_fdatasync_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::local_file::collective_write_action,
+        local_file_collective_write_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::local_file::collective_read_action,
+        local_file_collective_read_action)
 HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::lseek_action,
         local_file_lseek_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::seek_action,
+        local_file_seek_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::local_file::open_many_action,
+        local_file_open_many_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::local_file::stat_many_action,
+        local_file_stat_many_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::local_file::unlink_many_action,
+        local_file_unlink_many_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::local_file::create_many_action,
+        local_file_create_many_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::stat_action,
+        local_file_stat_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::mkdir_action,
+        local_file_mkdir_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::rmdir_action,
+        local_file_rmdir_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::rename_action,
+        local_file_rename_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::truncate_action,
+        local_file_truncate_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::opendir_action,
+        local_file_opendir_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::readdir_action,
+        local_file_readdir_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::closedir_action,
+        local_file_closedir_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::copy_to_action,
+        local_file_copy_to_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::local_file::copy_status_action,
+        local_file_copy_status_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_file::copy_wait_action,
+        local_file_copy_wait_action)
 
 #endif
 
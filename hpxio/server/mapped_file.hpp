@@ -0,0 +1,301 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_MAPPED_FILE_HPP_JUL_01_2015_1030AM)
+#define HPX_COMPONENTS_IO_SERVER_MAPPED_FILE_HPP_JUL_01_2015_1030AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/include/thread_executors.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/runtime/actions/component_action.hpp>
+#include <hpx/runtime/components/server/managed_component_base.hpp>
+#include <hpx/util/serialize_buffer.hpp>
+
+#include <boost/checked_delete.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // A read-only memory mapping of a whole file. The mapping is released
+    // once the last reference to it went away, spans handed out by the
+    // client keep it alive beyond close().
+    class file_mapping : boost::noncopyable
+    {
+      public:
+        file_mapping(char const* data, size_t size)
+          : data_(data), size_(size)
+        {}
+
+        ~file_mapping()
+        {
+            if (data_ != 0)
+            {
+                ::munmap(const_cast<char*>(data_), size_);
+            }
+        }
+
+        char const* data() const
+        {
+            return data_;
+        }
+
+        size_t size() const
+        {
+            return size_;
+        }
+
+      private:
+        char const* data_;
+        size_t size_;
+    };
+
+    typedef boost::shared_ptr<file_mapping const> file_mapping_ptr;
+
+    // mapped file class
+    // maps a local file read-only into memory
+    //
+    // Local callers access the mapping directly through the client's spans.
+    // Everything touching the mapping on behalf of the component (pread,
+    // prefetch) runs on the io_pool, so page faults of cold data never stall
+    // the HPX worker threads. Modifications made to the file by others are
+    // visible through the mapping, growing the file needs a new open().
+    class mapped_file
+      : public components::managed_component_base<mapped_file>
+    {
+      private:
+        typedef hpx::lcos::local::spinlock mutex_type;
+
+      public:
+        typedef hpx::util::serialize_buffer<char> buffer_type;
+
+        mapped_file() {}
+
+        // only "r" is supported, the mapping is read-only
+        void open(std::string const& name, std::string const& mode)
+        {
+            close();
+
+            file_mapping_ptr m;
+            {
+                hpx::threads::executors::io_pool_executor scheduler;
+                scheduler.add(hpx::util::bind(&mapped_file::open_work,
+                    boost::ref(name), boost::ref(mode), boost::ref(m)));
+            }
+
+            mutex_type::scoped_lock l(mtx_);
+            mapping_ = m;
+        }
+
+        static void open_work(std::string const& name,
+            std::string const& mode, file_mapping_ptr& m)
+        {
+            if (mode.empty() || mode[0] != 'r' ||
+                mode.find('+') != std::string::npos)
+            {
+                return;
+            }
+
+            int const fd = ::open(name.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                return;
+            }
+
+            struct stat st;
+            if (::fstat(fd, &st) == 0)
+            {
+                if (st.st_size == 0)
+                {
+                    // an empty file cannot be mapped, it is open nevertheless
+                    m = boost::make_shared<file_mapping>(
+                        static_cast<char const*>(0), size_t(0));
+                }
+                else
+                {
+                    void* data = ::mmap(0, st.st_size, PROT_READ, MAP_SHARED,
+                        fd, 0);
+                    if (data != MAP_FAILED)
+                    {
+                        m = boost::make_shared<file_mapping>(
+                            static_cast<char const*>(data),
+                            size_t(st.st_size));
+                    }
+                }
+            }
+
+            // the mapping stays valid without the descriptor
+            ::close(fd);
+        }
+
+        bool is_open() const
+        {
+            return get_mapping().get() != 0;
+        }
+
+        void close()
+        {
+            file_mapping_ptr m;
+            {
+                mutex_type::scoped_lock l(mtx_);
+                m.swap(mapping_);
+            }
+        }
+
+        size_t size() const
+        {
+            file_mapping_ptr m = get_mapping();
+            return m ? m->size() : 0;
+        }
+
+        std::vector<char> pread(size_t const count, off_t const offset)
+        {
+            std::vector<char> result;
+            file_mapping_ptr m = get_mapping();
+            if (!m || offset < 0 || size_t(offset) >= m->size())
+            {
+                return result;
+            }
+
+            result.resize((std::min)(count, m->size() - offset));
+            {
+                hpx::threads::executors::io_pool_executor scheduler;
+                scheduler.add(hpx::util::bind(&mapped_file::pread_work,
+                    m, result.data(), result.size(), offset));
+            }
+            return result;
+        }
+
+        // the data is copied out of the mapping once, straight into the
+        // buffer which is sent as a zero-copy chunk
+        buffer_type pread_buffer(size_t const count, off_t const offset)
+        {
+            file_mapping_ptr m = get_mapping();
+            if (!m || count == 0 || offset < 0 ||
+                size_t(offset) >= m->size())
+            {
+                return buffer_type();
+            }
+
+            size_t const len = (std::min)(count, m->size() - offset);
+            char* data = new char[len];
+            {
+                hpx::threads::executors::io_pool_executor scheduler;
+                scheduler.add(hpx::util::bind(&mapped_file::pread_work,
+                    m, data, len, offset));
+            }
+            return buffer_type(data, len, buffer_type::take,
+                boost::checked_array_deleter<char>());
+        }
+
+        static void pread_work(file_mapping_ptr const& m, char* buf,
+            size_t const count, off_t const offset)
+        {
+            std::memcpy(buf, m->data() + offset, count);
+        }
+
+        // Bring the given range into memory, returns 0 once all of its
+        // pages are resident and -1 if the range is outside of the file.
+        int prefetch(off_t const offset, size_t const count)
+        {
+            file_mapping_ptr m = get_mapping();
+            if (!m || offset < 0 || size_t(offset) > m->size())
+            {
+                return -1;
+            }
+
+            int result = 0;
+            {
+                hpx::threads::executors::io_pool_executor scheduler;
+                scheduler.add(hpx::util::bind(&mapped_file::prefetch_work,
+                    m, offset, (std::min)(count, m->size() - offset),
+                    boost::ref(result)));
+            }
+            return result;
+        }
+
+        static void prefetch_work(file_mapping_ptr const& m,
+            off_t const offset, size_t const count, int& result)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            size_t const page = ::sysconf(_SC_PAGESIZE);
+            size_t const begin = (offset / page) * page;
+            size_t const end = offset + count;
+
+            // start reading ahead for the whole range at once ...
+            ::madvise(const_cast<char*>(m->data()) + begin, end - begin,
+                MADV_WILLNEED);
+
+            // ... and wait for it by touching every page
+            char volatile sink = 0;
+            for (size_t pos = begin; pos < end; pos += page)
+            {
+                sink = m->data()[pos];
+            }
+            (void)sink;
+            result = 0;
+        }
+
+        // the current mapping, this is not exposed as an action and can only
+        // be used if the component is local
+        file_mapping_ptr get_mapping() const
+        {
+            mutex_type::scoped_lock l(mtx_);
+            return mapping_;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Each of the exposed functions needs to be encapsulated into a action
+        // type, allowing to generate all require boilerplate code for threads,
+        // serialization, etc.
+        HPX_DEFINE_COMPONENT_ACTION(mapped_file, open);
+        HPX_DEFINE_COMPONENT_ACTION(mapped_file, is_open);
+        HPX_DEFINE_COMPONENT_ACTION(mapped_file, close);
+        HPX_DEFINE_COMPONENT_ACTION(mapped_file, size);
+        HPX_DEFINE_COMPONENT_ACTION(mapped_file, pread_buffer);
+        HPX_DEFINE_COMPONENT_ACTION(mapped_file, prefetch);
+
+      private:
+        mutable mutex_type mtx_;
+        file_mapping_ptr mapping_;
+    };
+
+}}} // hpx::io::server
+
+///////////////////////////////////////////////////////////////////////////////
+// Declaration of serialization support for the mapped_file actions
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::mapped_file::open_action,
+        mapped_file_open_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::mapped_file::is_open_action,
+        mapped_file_is_open_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::mapped_file::close_action,
+        mapped_file_close_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::mapped_file::size_action,
+        mapped_file_size_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::mapped_file::pread_buffer_action,
+        mapped_file_pread_buffer_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::mapped_file::prefetch_action,
+        mapped_file_prefetch_action)
+
+#endif
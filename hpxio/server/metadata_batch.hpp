@@ -0,0 +1,73 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_METADATA_BATCH_HPP_JUL_09_2015_1020AM)
+#define HPX_COMPONENTS_IO_SERVER_METADATA_BATCH_HPP_JUL_09_2015_1020AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/runtime/get_config_entry.hpp>
+#include <hpxio/io_hints.hpp>
+#include <hpxio/server/io_scheduler.hpp>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Run f(i) for all i < count on the io_pool and wait for all of them.
+    // The items are handed out in blocks of hpxio.metadata.batch_block
+    // (default: 32) items, which keeps the number of tasks of large batches
+    // down while the blocks still spread over all io_pool threads. Has to be
+    // called from an HPX thread.
+    template <typename F>
+    void run_batch(io_scheduler& s, std::size_t count, F const& f)
+    {
+        static std::size_t const block = (std::max)(std::size_t(1),
+            boost::lexical_cast<std::size_t>(hpx::get_config_entry(
+                "hpxio.metadata.batch_block", "32")));
+
+        io_pool_scheduler scheduler(s);
+        for (std::size_t begin = 0; begin < count; begin += block)
+        {
+            std::size_t const end = (std::min)(begin + block, count);
+            scheduler.add(
+                [&f, begin, end]()
+                {
+                    for (std::size_t i = begin; i != end; ++i)
+                    {
+                        f(i);
+                    }
+                });
+        }
+
+        // the destructor of the scheduler waits for all blocks
+    }
+
+    // run f() on one of the io_pool threads and wait for it, for single
+    // blocking calls from an HPX thread
+    template <typename F>
+    void run_on_io_pool(io_scheduler& s, io_hints const& hints, F const& f)
+    {
+        io_pool_scheduler scheduler(s, hints);
+        scheduler.add(
+            [&f]()
+            {
+                f();
+            });
+    }
+
+    template <typename F>
+    void run_on_io_pool(io_scheduler& s, F const& f)
+    {
+        run_on_io_pool(s, io_hints(), f);
+    }
+
+}}} // hpx::io::server
+
+#endif
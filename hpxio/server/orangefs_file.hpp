@@ -8,11 +8,44 @@
 #define HPX_COMPONENTS_IO_SERVER_ORANGEFS_FILE_HPP_SEP_01_2014_1223PM
 
 #include <hpx/hpx_fwd.hpp>
+#include <hpx/include/runtime.hpp>
 #include <hpx/include/thread_executors.hpp>
 #include <hpx/runtime/actions/component_action.hpp>
 #include <hpx/runtime/components/component_type.hpp>
+#include <hpx/runtime/components/new.hpp>
 #include <hpx/runtime/components/server/locking_hook.hpp>
 #include <hpx/runtime/components/server/managed_component_base.hpp>
+#include <hpx/runtime/get_config_entry.hpp>
+#include <hpx/runtime/get_ptr.hpp>
+#include <hpx/util/serialize_buffer.hpp>
+#include <hpxio/copy_progress.hpp>
+#include <hpxio/directory_entry.hpp>
+#include <hpxio/extent.hpp>
+#include <hpxio/file_status.hpp>
+#include <hpxio/io_hints.hpp>
+#include <hpxio/server/block_cache.hpp>
+#include <hpxio/server/collective_buffer.hpp>
+#include <hpxio/server/directory_table.hpp>
+#include <hpxio/server/file_copy.hpp>
+#include <hpxio/server/group_commit.hpp>
+#include <hpxio/server/io_scheduler.hpp>
+#include <hpxio/server/io_statistics.hpp>
+#include <hpxio/server/local_file.hpp>
+#include <hpxio/server/metadata_batch.hpp>
+#include <hpxio/server/vector_buffer.hpp>
+#include <hpxio/server/write_behind_buffer.hpp>
+
+#include <boost/checked_delete.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
 
 /* ------------------------  added pvfs header stuff --------------- */
 
@@ -32,25 +65,157 @@ extern "C" {
 ///////////////////////////////////////////////////////////////////////////////
 namespace hpx { namespace io { namespace server
 {
+    ///////////////////////////////////////////////////////////////////////////
+    // A directory in OrangeFS, read() blocks and has to be run on the
+    // io_pool.
+    class orangefs_directory : boost::noncopyable
+    {
+      public:
+        explicit orangefs_directory(std::string const& path)
+          : fd_(pvfs_open(path.c_str(), O_RDONLY | O_DIRECTORY)),
+            buf_(64 * 1024), pos_(0), len_(0)
+        {}
 
+        ~orangefs_directory()
+        {
+            if (fd_ >= 0)
+            {
+                pvfs_close(fd_);
+            }
+        }
+
+        bool is_open() const
+        {
+            return fd_ >= 0;
+        }
+
+        // up to count entries, without "." and "..", none at the end
+        std::vector<directory_entry> read(std::size_t count)
+        {
+            std::vector<directory_entry> result;
+            if (fd_ < 0)
+            {
+                return result;
+            }
+
+            result.reserve(count);
+            while (result.size() < count)
+            {
+                if (pos_ == len_)
+                {
+                    // fetch the next batch of records
+                    int const len = pvfs_getdents(fd_,
+                        reinterpret_cast<struct dirent*>(buf_.data()),
+                        buf_.size());
+                    if (len <= 0)
+                    {
+                        break;
+                    }
+                    pos_ = 0;
+                    len_ = len;
+                }
+
+                struct dirent const* e =
+                    reinterpret_cast<struct dirent const*>(buf_.data() + pos_);
+                pos_ += e->d_reclen;
+
+                if (std::strcmp(e->d_name, ".") == 0 ||
+                    std::strcmp(e->d_name, "..") == 0)
+                {
+                    continue;
+                }
+                result.push_back(directory_entry(e->d_name, e->d_type));
+            }
+            return result;
+        }
+
+      private:
+        int fd_;
+        std::vector<char> buf_;
+        std::size_t pos_;
+        std::size_t len_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Work for the io_pool is admitted by the io_scheduler according to the
+    // io_hints passed with the reads and writes, the vectored ones, flush
+    // and lseek. Write-behind data is flushed with the hints of the request
+    // causing the flush. Server-side copies run in the background class.
+    //
+    // Latency, count and bytes of every operation are recorded in
+    // io_statistics and exposed as /hpxio/orangefs_file/... performance
+    // counters.
     class orangefs_file : public components::locking_hook<
                           components::managed_component_base<orangefs_file> >
     {
       public:
+        typedef hpx::util::serialize_buffer<char> buffer_type;
+
+        // shared with the direct path of the clients
+        static io_statistics& statistics()
+        {
+            static io_statistics& stats = io_statistics::get("orangefs_file");
+            return stats;
+        }
+
+        // the admission of the work of this backend to the io_pool, shared
+        // with the requests a client serves directly
+        static io_scheduler& admission()
+        {
+            static io_scheduler& s = io_scheduler::get("orangefs_file");
+            return s;
+        }
+
         orangefs_file() : fd_(-1)
         {
             file_name_.clear();
+
+            // staged data is flushed through the action, the timer waits for
+            // the locking_hook like any other request
+            flush_timer_.start(write_behind_,
+                [this]()
+                {
+                    if (!write_behind_.due())
+                    {
+                        return;
+                    }
+                    try
+                    {
+                        hpx::async<flush_action>(
+                            this->get_unmanaged_id(), io_hints()).get();
+                    }
+                    catch (hpx::exception const&)
+                    {
+                        // the component is going away, close flushes
+                    }
+                });
         }
 
         ~orangefs_file()
         {
+            flush_timer_.stop();
+
+            // batches of group commit sync on separate HPX threads
+            fsync_commit_.wait();
+            fdatasync_commit_.wait();
+
             close();
         }
 
         void open(std::string const& name, int const flag)
         {
+            operation_timer t(statistics(), io_statistics::open);
+
+            // staged data belongs to the file opened so far
+            flush(io_hints());
+
+            if (flag & O_TRUNC)
+            {
+                block_cache::get().invalidate(name);
+            }
+
             // Get a reference to one of the IO specific HPX io_service objects ...
-            hpx::threads::executors::io_pool_executor scheduler;
+            io_pool_scheduler scheduler(admission());
 
             // ... and schedule the handler to run on one of its OS-threads.
             scheduler.add(hpx::util::bind(&orangefs_file::open_work, this,
@@ -81,16 +246,18 @@ namespace hpx { namespace io { namespace server
             return fd_ >= 0;
         }
 
-        void close()
+        // returns -1 if staged data could not be written out
+        int close()
         {
-            // Get a reference to one of the IO specific HPX io_service objects ...
-            hpx::threads::executors::io_pool_executor scheduler;
-
-            // ... and schedule the handler to run on one of its OS-threads.
-            scheduler.add(hpx::util::bind(&orangefs_file::close_work, this));
+            operation_timer t(statistics(), io_statistics::close);
+            int const result = flush(io_hints());
 
-            // Note that the destructor of the scheduler object will wait for
-            // the scheduled task to finish executing.
+            {
+                io_pool_scheduler scheduler(admission());
+                scheduler.add(hpx::util::bind(&orangefs_file::close_work,
+                    this));
+            }
+            return result;
         }
 
         void close_work()
@@ -105,9 +272,12 @@ namespace hpx { namespace io { namespace server
 
         int remove_file(std::string const& file_name)
         {
+            operation_timer t(statistics(), io_statistics::metadata);
+            block_cache::get().invalidate(file_name);
+
             int result;
             {
-                hpx::threads::executors::io_pool_executor scheduler;
+                io_pool_scheduler scheduler(admission());
                 scheduler.add(hpx::util::bind(&orangefs_file::remove_file_work,
                             this, boost::ref(file_name), boost::ref(result)));
             }
@@ -119,111 +289,584 @@ namespace hpx { namespace io { namespace server
             result = pvfs_unlink(file_name.c_str());
         }
 
-        std::vector<char> read(size_t const count)
+        std::vector<char> read(size_t const count,
+            io_hints const& hints = io_hints())
         {
             std::vector<char> result;
+            if (count > 0)
             {
-                hpx::threads::executors::io_pool_executor scheduler;
-                scheduler.add(hpx::util::bind(&orangefs_file::read_work,
-                            this, count, boost::ref(result)));
+                // read straight into the result, no staging buffer
+                result.resize(count);
+                ssize_t len = read_into(result.data(), count, hints);
+                result.resize(len > 0 ? len : 0);
             }
             return result;
         }
 
-        void read_work(size_t const count, std::vector<char>& result)
+        std::vector<char> pread(size_t const count, off_t const offset,
+            io_hints const& hints = io_hints())
         {
-            if (fd_ < 0 || count <= 0)
+            std::vector<char> result;
+            if (count > 0 && offset >= 0)
             {
-                return;
+                result.resize(count);
+                ssize_t len =
+                    pread_into(result.data(), count, offset, hints);
+                result.resize(len > 0 ? len : 0);
             }
+            return result;
+        }
 
-            std::unique_ptr<char[]> sp(new char[count]);
-            ssize_t len = pvfs_read(fd_, sp.get(), count);
+        // The buffer returned by read_buffer and pread_buffer is allocated
+        // once and filled directly by pvfs. It is handed over to the caller
+        // as is if the component is local and is sent as a zero-copy chunk
+        // if the caller lives on another locality.
+        buffer_type read_buffer(size_t const count, io_hints const& hints)
+        {
+            return read_into_buffer(count, -1, hints);
+        }
+
+        buffer_type pread_buffer(size_t const count, off_t const offset,
+            io_hints const& hints)
+        {
+            if (offset < 0)
+            {
+                return buffer_type();
+            }
+            return read_into_buffer(count, offset, hints);
+        }
+
+        // read into a caller supplied buffer, this is not exposed as an
+        // action and is only used from within the component, where the
+        // locking_hook is held
+        ssize_t read_into(char* buf, size_t const count,
+            io_hints const& hints = io_hints())
+        {
+            operation_timer t(statistics(), io_statistics::read);
+            if (!write_behind_.empty())
+            {
+                flush(hints);
+            }
 
-            if (len == 0)
+            if (block_cache::get().enabled())
+            {
+                // go through the cache at the current file position
+                off_t const pos = seek_file(0, SEEK_CUR, hints);
+                if (pos < 0)
+                {
+                    return -1;
+                }
+
+                ssize_t len = pread_cached(buf, count, pos, hints);
+                if (len > 0)
+                {
+                    seek_file(pos + len, SEEK_SET, hints);
+                }
+                return t.transferred(len);
+            }
+
+            ssize_t result = 0;
+            {
+                io_pool_scheduler scheduler(admission(), hints);
+                scheduler.add(hpx::util::bind(&orangefs_file::read_work,
+                            this, buf, count, boost::ref(result)));
+            }
+            return t.transferred(result);
+        }
+
+        void read_work(char* buf, size_t const count, ssize_t& result)
+        {
+            if (fd_ < 0 || count <= 0)
             {
                 return;
             }
 
-            result.assign(sp.get(), sp.get() + len);
+            result = pvfs_read(fd_, buf, count);
         }
 
-        std::vector<char> pread(size_t const count, off_t const offset)
+        ssize_t pread_into(char* buf, size_t const count, off_t const offset,
+            io_hints const& hints = io_hints())
         {
-            std::vector<char> result;
+            operation_timer t(statistics(), io_statistics::pread);
+            return t.transferred(pread_cached(buf, count, offset, hints));
+        }
+
+        ssize_t pread_cached(char* buf, size_t const count,
+                off_t const offset, io_hints const& hints)
+        {
+            if (write_behind_.overlaps(offset, count))
             {
-                hpx::threads::executors::io_pool_executor scheduler;
-                scheduler.add(hpx::util::bind(&orangefs_file::pread_work,
-                            this, count, offset, boost::ref(result)));
+                flush(hints);
             }
-            return result;
+
+            block_cache& cache = block_cache::get();
+            if (cache.enabled() && fd_ >= 0 && offset >= 0)
+            {
+                return cache.read(file_name_, buf, count, offset,
+                    [this, &hints](char* b, size_t c, off_t o)
+                    {
+                        return pread_direct(b, c, o, hints);
+                    });
+            }
+            return pread_direct(buf, count, offset, hints);
         }
 
-        void pread_work(size_t const count, off_t const offset,
-                std::vector<char>& result)
+        // read bypassing the block cache
+        ssize_t pread_direct(char* buf, size_t const count,
+                off_t const offset, io_hints const& hints)
         {
-            if (fd_ < 0 || count <= 0 || offset < 0)
+            if (offset >= 0 && count >= striping().threshold)
             {
-                return;
+                return pread_striped(buf, count, offset, hints);
             }
 
-            std::unique_ptr<char[]> sp(new char[count]);
-            ssize_t len = pvfs_pread(fd_, sp.get(), count, offset);
+            ssize_t result = 0;
+            {
+                io_pool_scheduler scheduler(admission(), hints);
+                scheduler.add(hpx::util::bind(&orangefs_file::pread_work,
+                            this, buf, count, offset, boost::ref(result)));
+            }
+            return result;
+        }
 
-            if (len == 0)
+        void pread_work(char* buf, size_t const count, off_t const offset,
+                ssize_t& result)
+        {
+            if (fd_ < 0 || count <= 0 || offset < 0)
             {
                 return;
             }
 
-            result.assign(sp.get(), sp.get() + len);
+            result = pvfs_pread(fd_, buf, count, offset);
         }
 
-        ssize_t write(std::vector<char> const& buf)
+        ssize_t write(buffer_type const& buf, io_hints const& hints)
         {
+            operation_timer t(statistics(), io_statistics::write);
+
+            // the current position is not known here
+            block_cache::write_scope invalidate(file_name_);
+            invalidate.add_file();
+            flush(hints);
+
             ssize_t result = 0;
             {
-                hpx::threads::executors::io_pool_executor scheduler;
+                io_pool_scheduler scheduler(admission(), hints);
                 scheduler.add(hpx::util::bind(&orangefs_file::write_work,
                             this, boost::ref(buf), boost::ref(result)));
             }
-            return result;
+            return t.transferred(result);
         }
 
-        void write_work(std::vector<char> const& buf, ssize_t& result)
+        void write_work(buffer_type const& buf, ssize_t& result)
         {
-            if (fd_ < 0 || buf.empty())
+            if (fd_ < 0 || buf.size() == 0)
             {
                 return;
             }
             result = pvfs_write(fd_, buf.data(), buf.size());
         }
 
-        ssize_t pwrite(std::vector<char> const& buf, off_t const offset)
+        ssize_t pwrite(buffer_type const& buf, off_t const offset,
+            io_hints const& hints)
         {
+            operation_timer t(statistics(), io_statistics::pwrite);
+            block_cache::write_scope invalidate(file_name_, offset, buf.size());
+
+            if (write_behind_.enabled())
+            {
+                if (fd_ < 0 || buf.size() == 0 || offset < 0)
+                {
+                    return 0;
+                }
+                if (write_behind_.stage(buf.data(), buf.size(), offset))
+                {
+                    flush(hints);
+                }
+                return t.transferred(buf.size());
+            }
+
+            if (offset >= 0 && buf.size() >= striping().threshold)
+            {
+                return t.transferred(
+                    pwrite_striped(buf.data(), buf.size(), offset, hints));
+            }
+
             ssize_t result = 0;
             {
-                hpx::threads::executors::io_pool_executor scheduler;
+                io_pool_scheduler scheduler(admission(), hints);
                 scheduler.add(hpx::util::bind(&orangefs_file::pwrite_work,
                     this, boost::ref(buf), offset, boost::ref(result)));
             }
-            return result;
+            return t.transferred(result);
         }
 
-        void pwrite_work(std::vector<char> const& buf,
+        void pwrite_work(buffer_type const& buf,
                 off_t const offset, ssize_t& result)
         {
-            if (fd_ < 0 || buf.empty() || offset < 0)
+            if (fd_ < 0 || buf.size() == 0 || offset < 0)
             {
                 return;
             }
             result = pvfs_pwrite(fd_, buf.data(), buf.size(), offset);
         }
 
-        off_t lseek(off_t const offset, int const whence)
+        ///////////////////////////////////////////////////////////////////////
+        // Large requests are cut into chunks covering whole stripes which are
+        // transferred concurrently on the io_pool OS-threads, directly from or
+        // into their final place in the buffer. This keeps several OrangeFS
+        // servers busy for a single request.
+        ssize_t pread_striped(char* buf, size_t const count,
+                off_t const offset, io_hints const& hints)
+        {
+            std::vector<extent> chunks = split_striped(count, offset);
+            std::vector<ssize_t> lengths(chunks.size(), 0);
+            {
+                io_pool_scheduler scheduler(admission(), hints);
+                for (size_t i = 0; i != chunks.size(); ++i)
+                {
+                    scheduler.add(hpx::util::bind(&orangefs_file::pread_work,
+                        this, buf + (chunks[i].offset - offset),
+                        chunks[i].count, chunks[i].offset,
+                        boost::ref(lengths[i])));
+                }
+            }
+            return contiguous_length(chunks, lengths);
+        }
+
+        ssize_t pwrite_striped(char const* buf, size_t const count,
+                off_t const offset, io_hints const& hints)
+        {
+            std::vector<extent> chunks = split_striped(count, offset);
+            std::vector<ssize_t> lengths(chunks.size(), 0);
+            {
+                io_pool_scheduler scheduler(admission(), hints);
+                for (size_t i = 0; i != chunks.size(); ++i)
+                {
+                    scheduler.add(hpx::util::bind(
+                        &orangefs_file::pwrite_from_work,
+                        this, buf + (chunks[i].offset - offset),
+                        chunks[i].count, chunks[i].offset,
+                        boost::ref(lengths[i])));
+                }
+            }
+            return contiguous_length(chunks, lengths);
+        }
+
+        void pwrite_from_work(char const* buf, size_t const count,
+                off_t const offset, ssize_t& result)
+        {
+            if (fd_ < 0 || count <= 0 || offset < 0)
+            {
+                return;
+            }
+            result = pvfs_pwrite(fd_, buf, count, offset);
+        }
+
+        // Vectored positional I/O: all extents are handled by a single
+        // request. The data of the extents is concatenated in list order, a
+        // short transfer of one extent ends the operation and only the bytes
+        // transferred so far are accounted for.
+        std::vector<char> preadv(std::vector<extent> const& extents,
+            io_hints const& hints = io_hints())
+        {
+            std::vector<char> result(total_count(extents));
+            if (!result.empty())
+            {
+                ssize_t len = preadv_into(extents, result.data(), hints);
+                result.resize(len > 0 ? len : 0);
+            }
+            return result;
+        }
+
+        buffer_type preadv_buffer(std::vector<extent> const& extents,
+            io_hints const& hints)
+        {
+            size_t const count = total_count(extents);
+            if (count == 0)
+            {
+                return buffer_type();
+            }
+
+            char* data = new char[count];
+            ssize_t len = preadv_into(extents, data, hints);
+            if (len <= 0)
+            {
+                delete [] data;
+                return buffer_type();
+            }
+
+            return buffer_type(data, len, buffer_type::take,
+                boost::checked_array_deleter<char>());
+        }
+
+        // not exposed as an action, buf has to hold the data of all extents
+        ssize_t preadv_into(std::vector<extent> const& extents, char* buf,
+            io_hints const& hints = io_hints())
+        {
+            operation_timer t(statistics(), io_statistics::preadv);
+            if (!write_behind_.empty())
+            {
+                flush(hints);
+            }
+
+            ssize_t len = 0;
+            {
+                io_pool_scheduler scheduler(admission(), hints);
+                scheduler.add(hpx::util::bind(&orangefs_file::preadv_work,
+                    this, boost::ref(extents), buf, boost::ref(len)));
+            }
+            return t.transferred(len);
+        }
+
+        void preadv_work(std::vector<extent> const& extents, char* buf,
+                ssize_t& result)
+        {
+            if (fd_ < 0)
+            {
+                return;
+            }
+
+            size_t done = 0;
+            for (size_t i = 0; i != extents.size(); ++i)
+            {
+                extent const& e = extents[i];
+                if (e.offset < 0)
+                {
+                    break;
+                }
+
+                ssize_t len = pvfs_pread(fd_, buf + done, e.count, e.offset);
+                if (len > 0)
+                {
+                    done += len;
+                }
+                if (len < static_cast<ssize_t>(e.count))
+                {
+                    break;
+                }
+            }
+            result = done;
+        }
+
+        ssize_t pwritev(std::vector<extent> const& extents,
+                buffer_type const& buf, io_hints const& hints)
+        {
+            operation_timer t(statistics(), io_statistics::pwritev);
+            if (buf.size() == 0 || total_count(extents) != buf.size())
+            {
+                return 0;
+            }
+
+            block_cache::write_scope invalidate(file_name_);
+            for (size_t i = 0; i != extents.size(); ++i)
+            {
+                invalidate.add(extents[i].offset, extents[i].count);
+            }
+
+            if (write_behind_.enabled())
+            {
+                if (fd_ < 0)
+                {
+                    return 0;
+                }
+
+                bool flush_due = false;
+                size_t pos = 0;
+                for (size_t i = 0; i != extents.size(); ++i)
+                {
+                    if (extents[i].offset < 0)
+                    {
+                        break;
+                    }
+                    flush_due = write_behind_.stage(buf.data() + pos,
+                        extents[i].count, extents[i].offset) || flush_due;
+                    pos += extents[i].count;
+                }
+
+                if (flush_due)
+                {
+                    flush(hints);
+                }
+                return t.transferred(pos);
+            }
+
+            ssize_t result = 0;
+            {
+                io_pool_scheduler scheduler(admission(), hints);
+                scheduler.add(hpx::util::bind(&orangefs_file::pwritev_work,
+                    this, boost::ref(extents), buf.data(),
+                    boost::ref(result)));
+            }
+            return t.transferred(result);
+        }
+
+        void pwritev_work(std::vector<extent> const& extents,
+                char const* buf, ssize_t& result)
+        {
+            if (fd_ < 0)
+            {
+                return;
+            }
+
+            size_t done = 0;
+            for (size_t i = 0; i != extents.size(); ++i)
+            {
+                extent const& e = extents[i];
+                if (e.offset < 0)
+                {
+                    break;
+                }
+
+                ssize_t len = pvfs_pwrite(fd_, buf + done, e.count, e.offset);
+                if (len > 0)
+                {
+                    done += len;
+                }
+                if (len < static_cast<ssize_t>(e.count))
+                {
+                    break;
+                }
+            }
+            result = done;
+        }
+
+        // Write out everything staged by write-behind, returns -1 if any of
+        // the staged data could not be written. The staged ranges do not
+        // overlap and are written concurrently, with the hints of the request
+        // causing the flush. The locking_hook keeps other requests out
+        // meanwhile.
+        int flush(io_hints const& hints)
         {
-            off_t result;
+            if (write_behind_.empty())
             {
-                hpx::threads::executors::io_pool_executor scheduler;
+                return 0;
+            }
+
+            operation_timer t(statistics(), io_statistics::flush);
+            return write_extents(write_behind_.take(), hints);
+        }
+
+        // write out non-overlapping ranges concurrently, returns -1 if any
+        // of them could not be written completely. Reads fill whole blocks
+        // and read ahead, so the cache may hold neighbours of a read range
+        // fetched while their data was still staged, all written ranges are
+        // invalidated once they have landed.
+        int write_extents(write_behind_buffer::extent_map const& extents,
+            io_hints const& hints)
+        {
+            if (extents.empty())
+            {
+                return 0;
+            }
+
+            typedef write_behind_buffer::extent_map::const_iterator iterator;
+
+            block_cache::write_scope invalidate(file_name_);
+            for (iterator it = extents.begin(); it != extents.end(); ++it)
+            {
+                invalidate.add(it->first, it->second.size());
+            }
+
+            std::vector<ssize_t> lengths(extents.size(), 0);
+            {
+                io_pool_scheduler scheduler(admission(), hints);
+
+                size_t i = 0;
+                for (iterator it = extents.begin(); it != extents.end();
+                     ++it, ++i)
+                {
+                    scheduler.add(hpx::util::bind(
+                        &orangefs_file::pwrite_from_work, this,
+                        it->second.data(), it->second.size(), it->first,
+                        boost::ref(lengths[i])));
+                }
+            }
+
+            size_t i = 0;
+            for (iterator it = extents.begin(); it != extents.end(); ++it, ++i)
+            {
+                if (lengths[i] != static_cast<ssize_t>(it->second.size()))
+                {
+                    return -1;
+                }
+            }
+            return 0;
+        }
+
+        // Write out staged data and force the file to stable storage,
+        // returns 0 on success and -1 otherwise. The locking_hook releases
+        // the component while a sync is waiting for the io_pool, so
+        // concurrent requests can be merged by group commit.
+        int fsync()
+        {
+            operation_timer t(statistics(), io_statistics::fsync);
+            return sync_file(fsync_commit_, false);
+        }
+
+        int fdatasync()
+        {
+            operation_timer t(statistics(), io_statistics::fdatasync);
+            return sync_file(fdatasync_commit_, true);
+        }
+
+        void sync_work(bool const datasync, int& result)
+        {
+            if (fd_ < 0)
+            {
+                result = -1;
+                return;
+            }
+            result = datasync ? pvfs_fdatasync(fd_) : pvfs_fsync(fd_);
+        }
+
+        // Two-phase collective I/O: the extents of all participants of a
+        // round are merged and written (or read) at once by the last
+        // participant to arrive. The locking_hook releases the component
+        // while the other participants are waiting.
+        ssize_t collective_write(boost::uint64_t const round,
+                size_t const participants, std::vector<extent> const& extents,
+                buffer_type const& buf)
+        {
+            // the aggregator has written the round once write returns
+            block_cache::write_scope invalidate(file_name_);
+            for (size_t i = 0; i != extents.size(); ++i)
+            {
+                invalidate.add(extents[i].offset, extents[i].count);
+            }
+
+            return collective_.write(round, participants, extents, buf,
+                [this](write_behind_buffer::extent_map const& merged) -> int
+                {
+                    flush(io_hints());
+                    return write_extents(merged, io_hints());
+                });
+        }
+
+        buffer_type collective_read(boost::uint64_t const round,
+                size_t const participants, std::vector<extent> const& extents)
+        {
+            return to_buffer(collective_.read(round, participants, extents,
+                [this](char* b, size_t c, off_t o)
+                {
+                    return pread_into(b, c, o);
+                }));
+        }
+
+        off_t lseek(off_t const offset, int const whence,
+            io_hints const& hints)
+        {
+            operation_timer t(statistics(), io_statistics::lseek);
+            return seek_file(offset, whence, hints);
+        }
+
+        // move the file position on the io_pool, as all pvfs calls
+        off_t seek_file(off_t const offset, int const whence,
+            io_hints const& hints)
+        {
+            off_t result = -1;
+            {
+                io_pool_scheduler scheduler(admission(), hints);
                 scheduler.add(hpx::util::bind(&orangefs_file::lseek_work,
                     this, offset, whence, boost::ref(result)));
             }
@@ -241,6 +884,362 @@ namespace hpx { namespace io { namespace server
             result = pvfs_lseek(fd_, offset, whence);
         }
 
+        ///////////////////////////////////////////////////////////////////////
+        // Batched metadata operations, the paths are handled in parallel on
+        // the io_pool and the results are returned in the order of the paths.
+        // They do not touch the file opened by this component.
+
+        // create and open one orangefs_file component on this locality for
+        // each path, an invalid id marks the paths which could not be opened
+        std::vector<naming::id_type> open_many(
+            std::vector<std::string> const& names, int const flag)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            if (flag & O_TRUNC)
+            {
+                for (std::size_t i = 0; i != names.size(); ++i)
+                {
+                    block_cache::get().invalidate(names[i]);
+                }
+            }
+
+            std::vector<lcos::future<naming::id_type> > lazy_ids;
+            lazy_ids.reserve(names.size());
+            for (std::size_t i = 0; i != names.size(); ++i)
+            {
+                lazy_ids.push_back(
+                    hpx::new_<orangefs_file>(hpx::find_here()));
+            }
+
+            std::vector<naming::id_type> ids;
+            std::vector<boost::shared_ptr<orangefs_file> > files;
+            ids.reserve(names.size());
+            files.reserve(names.size());
+            for (std::size_t i = 0; i != names.size(); ++i)
+            {
+                ids.push_back(lazy_ids[i].get());
+                files.push_back(
+                    hpx::get_ptr<orangefs_file>(ids.back()).get());
+            }
+
+            run_batch(admission(), names.size(),
+                [&files, &names, flag](std::size_t i)
+                {
+                    files[i]->open_work(names[i], flag);
+                });
+
+            for (std::size_t i = 0; i != files.size(); ++i)
+            {
+                if (!files[i]->is_open())
+                {
+                    ids[i] = naming::invalid_id;
+                }
+            }
+            return ids;
+        }
+
+        std::vector<file_status> stat_many(
+            std::vector<std::string> const& paths)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            std::vector<file_status> result(paths.size());
+            run_batch(admission(), paths.size(),
+                [&result, &paths](std::size_t i)
+                {
+                    struct stat st;
+                    if (pvfs_stat(paths[i].c_str(), &st) == 0)
+                    {
+                        result[i] = file_status(st);
+                    }
+                });
+            return result;
+        }
+
+        // returns 0 for each path removed, -1 otherwise
+        std::vector<int> unlink_many(std::vector<std::string> const& paths)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            for (std::size_t i = 0; i != paths.size(); ++i)
+            {
+                block_cache::get().invalidate(paths[i]);
+            }
+
+            std::vector<int> result(paths.size(), -1);
+            run_batch(admission(), paths.size(),
+                [&result, &paths](std::size_t i)
+                {
+                    result[i] = (pvfs_unlink(paths[i].c_str()) == 0) ? 0 : -1;
+                });
+            return result;
+        }
+
+        // create empty files, existing ones are truncated; returns 0 for
+        // each file created, -1 otherwise
+        std::vector<int> create_many(std::vector<std::string> const& paths)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            for (std::size_t i = 0; i != paths.size(); ++i)
+            {
+                block_cache::get().invalidate(paths[i]);
+            }
+
+            std::vector<int> result(paths.size(), -1);
+            run_batch(admission(), paths.size(),
+                [&result, &paths](std::size_t i)
+                {
+                    int const fd = pvfs_open(paths[i].c_str(),
+                        O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                    if (fd >= 0)
+                    {
+                        result[i] = (pvfs_close(fd) == 0) ? 0 : -1;
+                    }
+                });
+            return result;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Metadata operations on arbitrary paths, the calls are run on the
+        // io_pool. The int results are 0 on success and -1 otherwise.
+        file_status stat(std::string const& path)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            file_status result;
+            run_on_io_pool(admission(),
+                [&result, &path]()
+                {
+                    struct stat st;
+                    if (pvfs_stat(path.c_str(), &st) == 0)
+                    {
+                        result = file_status(st);
+                    }
+                });
+            return result;
+        }
+
+        int mkdir(std::string const& path, int const mode)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            int result = -1;
+            run_on_io_pool(admission(),
+                [&result, &path, mode]()
+                {
+                    result = (pvfs_mkdir(path.c_str(), mode) == 0) ? 0 : -1;
+                });
+            return result;
+        }
+
+        int rmdir(std::string const& path)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            int result = -1;
+            run_on_io_pool(admission(),
+                [&result, &path]()
+                {
+                    result = (pvfs_rmdir(path.c_str()) == 0) ? 0 : -1;
+                });
+            return result;
+        }
+
+        int rename(std::string const& from, std::string const& to)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            block_cache::get().invalidate(from);
+            block_cache::get().invalidate(to);
+
+            int result = -1;
+            run_on_io_pool(admission(),
+                [&result, &from, &to]()
+                {
+                    result = (pvfs_rename(from.c_str(), to.c_str()) == 0) ?
+                        0 : -1;
+                });
+            return result;
+        }
+
+        int truncate(std::string const& path, off_t const length)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            block_cache::get().invalidate(path);
+
+            int result = -1;
+            run_on_io_pool(admission(),
+                [&result, &path, length]()
+                {
+                    result = (pvfs_truncate(path.c_str(), length) == 0) ?
+                        0 : -1;
+                });
+            return result;
+        }
+
+        // Directory listings are streamed: opendir returns a handle (0 if
+        // the directory could not be opened), each readdir returns the next
+        // batch of up to count entries, an empty batch marks the end.
+        // closedir releases the handle.
+        boost::uint64_t opendir(std::string const& path)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            boost::shared_ptr<orangefs_directory> dir;
+            run_on_io_pool(admission(),
+                [&dir, &path]()
+                {
+                    dir = boost::make_shared<orangefs_directory>(path);
+                });
+            return dir->is_open() ? directories_.add(dir) : 0;
+        }
+
+        std::vector<directory_entry> readdir(boost::uint64_t const handle,
+            std::size_t const count)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            std::vector<directory_entry> result;
+            boost::shared_ptr<orangefs_directory> dir =
+                directories_.get(handle);
+            if (dir)
+            {
+                run_on_io_pool(admission(),
+                    [&result, &dir, count]()
+                    {
+                        result = dir->read(count);
+                    });
+            }
+            return result;
+        }
+
+        int closedir(boost::uint64_t const handle)
+        {
+            operation_timer t(statistics(), io_statistics::metadata);
+            boost::shared_ptr<orangefs_directory> dir =
+                directories_.remove(handle);
+            if (!dir)
+            {
+                return -1;
+            }
+
+            // the stream is closed by the last reference going away
+            run_on_io_pool(admission(),
+                [&dir]()
+                {
+                    dir.reset();
+                });
+            return 0;
+        }
+
+        // Server-side copies of count bytes from src_offset to dst_offset,
+        // running in the background on this component's locality. copy_to
+        // and copy_to_local_file push a range of this file to dest, reading
+        // here and writing through pwrite actions on dest. copy_from_local_file
+        // pulls a range of the local_file src into this file. Each returns a
+        // handle for copy_status and copy_wait, copy_wait returns the number
+        // of bytes copied and releases the handle. self has to refer to this
+        // component, it keeps the component alive while the copy is running.
+        // The copy accesses this file through the actions on self, so the
+        // background thread waits for the locking_hook like any request.
+        boost::uint64_t copy_to(naming::id_type const& self,
+            naming::id_type const& dest, off_t const src_offset,
+            off_t const dst_offset, boost::uint64_t const count)
+        {
+            return start_copy(hpx::util::bind(
+                &orangefs_file::copy_push<pwrite_action>, this, self, dest,
+                src_offset, dst_offset, hpx::util::placeholders::_1), count);
+        }
+
+        boost::uint64_t copy_to_local_file(naming::id_type const& self,
+            naming::id_type const& dest, off_t const src_offset,
+            off_t const dst_offset, boost::uint64_t const count)
+        {
+            return start_copy(hpx::util::bind(
+                &orangefs_file::copy_push<local_file::pwrite_action>, this,
+                self, dest, src_offset, dst_offset,
+                hpx::util::placeholders::_1), count);
+        }
+
+        boost::uint64_t copy_from_local_file(naming::id_type const& self,
+            naming::id_type const& src, off_t const src_offset,
+            off_t const dst_offset, boost::uint64_t const count)
+        {
+            return start_copy(hpx::util::bind(&orangefs_file::copy_pull,
+                this, self, src, src_offset, dst_offset,
+                hpx::util::placeholders::_1), count);
+        }
+
+        copy_progress copy_status(boost::uint64_t const handle)
+        {
+            boost::shared_ptr<copy_job> job = copies_.get(handle);
+            return job ? job->progress() : unknown_copy();
+        }
+
+        ssize_t copy_wait(boost::uint64_t const handle)
+        {
+            boost::shared_ptr<copy_job> job = copies_.get(handle);
+            if (!job)
+            {
+                return -1;
+            }
+
+            ssize_t const result = job->wait();
+            copies_.remove(handle);
+            return result;
+        }
+
+        template <typename F>
+        boost::uint64_t start_copy(F const& f, boost::uint64_t const count)
+        {
+            boost::shared_ptr<copy_job> job =
+                boost::make_shared<copy_job>(count);
+            job->start(hpx::async(hpx::util::bind(f, job)));
+            return copies_.add(job);
+        }
+
+        template <typename WriteAction>
+        ssize_t copy_push(naming::id_type const& self,
+            naming::id_type const& dest, off_t const src_offset,
+            off_t const dst_offset, boost::shared_ptr<copy_job> const& job)
+        {
+            if (src_offset < 0 || dst_offset < 0 ||
+                !hpx::async<is_open_action>(self).get())
+            {
+                return -1;
+            }
+
+            // copies do not hold up other requests to the files
+            io_hints const hints(io_priority_background);
+            return pipelined_copy(
+                [self, hints](size_t n, off_t o)
+                {
+                    return hpx::async<pread_buffer_action>(self, n, o,
+                        hints);
+                },
+                [dest, hints](buffer_type const& data, off_t o)
+                {
+                    return hpx::async<WriteAction>(dest, data, o, hints);
+                },
+                src_offset, dst_offset, *job);
+        }
+
+        ssize_t copy_pull(naming::id_type const& self,
+            naming::id_type const& src, off_t const src_offset,
+            off_t const dst_offset, boost::shared_ptr<copy_job> const& job)
+        {
+            if (src_offset < 0 || dst_offset < 0 ||
+                !hpx::async<is_open_action>(self).get())
+            {
+                return -1;
+            }
+
+            io_hints const hints(io_priority_background);
+            return pipelined_copy(
+                [src, hints](size_t n, off_t o)
+                {
+                    return hpx::async<local_file::pread_buffer_action>(
+                        src, n, o, hints);
+                },
+                [self, hints](buffer_type const& data, off_t o)
+                {
+                    return hpx::async<pwrite_action>(self, data, o, hints);
+                },
+                src_offset, dst_offset, *job);
+        }
+
         ///////////////////////////////////////////////////////////////////////
         // Each of the exposed functions needs to be encapsulated into a action
         // type, allowing to generate all require boilerplate code for threads,
@@ -249,18 +1248,166 @@ namespace hpx { namespace io { namespace server
         HPX_DEFINE_COMPONENT_ACTION(orangefs_file, is_open);
         HPX_DEFINE_COMPONENT_ACTION(orangefs_file, close);
         HPX_DEFINE_COMPONENT_ACTION(orangefs_file, remove_file);
-        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, read);
-        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, pread);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, read_buffer);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, pread_buffer);
         HPX_DEFINE_COMPONENT_ACTION(orangefs_file, write);
         HPX_DEFINE_COMPONENT_ACTION(orangefs_file, pwrite);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, preadv_buffer);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, pwritev);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, flush);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, fsync);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, fdatasync);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, collective_write);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, collective_read);
         HPX_DEFINE_COMPONENT_ACTION(orangefs_file, lseek);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, open_many);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, stat_many);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, unlink_many);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, create_many);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, stat);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, mkdir);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, rmdir);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, rename);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, truncate);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, opendir);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, readdir);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, closedir);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, copy_to);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, copy_to_local_file);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, copy_from_local_file);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, copy_status);
+        HPX_DEFINE_COMPONENT_ACTION(orangefs_file, copy_wait);
 
       private:
         typedef components::managed_component_base<orangefs_file> base_type;
 
+        // The strip size has to match the distribution of the file system,
+        // it is the simple_stripe default of 64k unless configured through
+        // hpxio.orangefs.strip_size. Requests of at least
+        // hpxio.orangefs.parallel_threshold bytes are split into chunks of
+        // hpxio.orangefs.strips_per_chunk strips.
+        struct striping_config
+        {
+            striping_config()
+            {
+                size_t strip_size = boost::lexical_cast<size_t>(
+                    hpx::get_config_entry("hpxio.orangefs.strip_size",
+                        "65536"));
+                size_t strips = boost::lexical_cast<size_t>(
+                    hpx::get_config_entry("hpxio.orangefs.strips_per_chunk",
+                        "16"));
+                threshold = boost::lexical_cast<size_t>(
+                    hpx::get_config_entry("hpxio.orangefs.parallel_threshold",
+                        "4194304"));
+
+                chunk_size = (std::max)(strip_size, size_t(1)) *
+                    (std::max)(strips, size_t(1));
+                threshold = (std::max)(threshold, 2 * chunk_size);
+            }
+
+            size_t chunk_size;
+            size_t threshold;
+        };
+
+        static striping_config const& striping()
+        {
+            static striping_config config;
+            return config;
+        }
+
+        static std::vector<extent> split_striped(size_t const count,
+            off_t const offset)
+        {
+            off_t const chunk = striping().chunk_size;
+            off_t const end = offset + count;
+
+            std::vector<extent> chunks;
+            chunks.reserve(count / chunk + 2);
+            for (off_t pos = offset; pos < end; /**/)
+            {
+                off_t next = (std::min)((pos / chunk + 1) * chunk, end);
+                chunks.push_back(extent(pos, next - pos));
+                pos = next;
+            }
+            return chunks;
+        }
+
+        // the result of a chunked transfer is what arrived without a gap
+        static ssize_t contiguous_length(std::vector<extent> const& chunks,
+            std::vector<ssize_t> const& lengths)
+        {
+            size_t done = 0;
+            for (size_t i = 0; i != chunks.size(); ++i)
+            {
+                if (lengths[i] > 0)
+                {
+                    done += lengths[i];
+                }
+                if (lengths[i] < static_cast<ssize_t>(chunks[i].count))
+                {
+                    break;
+                }
+            }
+            return done;
+        }
+
+        buffer_type read_into_buffer(size_t const count, off_t const offset,
+            io_hints const& hints)
+        {
+            if (count <= 0)
+            {
+                return buffer_type();
+            }
+
+            char* data = new char[count];
+            ssize_t len = (offset < 0) ? read_into(data, count, hints) :
+                pread_into(data, count, offset, hints);
+
+            if (len <= 0)
+            {
+                delete [] data;
+                return buffer_type();
+            }
+
+            return buffer_type(data, len, buffer_type::take,
+                boost::checked_array_deleter<char>());
+        }
+
+        int sync_file(group_commit& commit, bool const datasync)
+        {
+            if (flush(io_hints()) != 0)
+            {
+                return -1;
+            }
+
+            return commit.run(
+                [this, datasync]() -> int
+                {
+                    int result = -1;
+                    {
+                        io_pool_scheduler scheduler(admission());
+                        scheduler.add(hpx::util::bind(
+                            &orangefs_file::sync_work, this, datasync,
+                            boost::ref(result)));
+                    }
+                    return result;
+                });
+        }
+
         // PVFS2TAB_FILE env need to be set in the shell
         int fd_;
         std::string file_name_;
+
+        write_behind_buffer write_behind_;
+        flush_timer flush_timer_;
+
+        group_commit fsync_commit_;
+        group_commit fdatasync_commit_;
+
+        collective_buffer collective_;
+
+        directory_table<orangefs_directory> directories_;
+        directory_table<copy_job> copies_;
     };
 
 }}} // hpx::io::server
@@ -275,16 +1422,76 @@ HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::close_action,
         orangefs_file_close_action)
 HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::remove_file_action,
         orangefs_file_remove_file_action)
-HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::read_action,
-        orangefs_file_read_action)
-HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::pread_action,
-        orangefs_file_pread_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::read_buffer_action,
+        orangefs_file_read_buffer_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::pread_buffer_action,
+        orangefs_file_pread_buffer_action)
 HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::write_action,
         orangefs_file_write_action)
 HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::pwrite_action,
         orangefs_file_pwrite_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::orangefs_file::preadv_buffer_action,
+        orangefs_file_preadv_buffer_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::pwritev_action,
+        orangefs_file_pwritev_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::flush_action,
+        orangefs_file_flush_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::fsync_action,
+        orangefs_file_fsync_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::orangefs_file::fdatasync_action,
+        orangefs_file_fdatasync_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::orangefs_file::collective_write_action,
+        orangefs_file_collective_write_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::orangefs_file::collective_read_action,
+        orangefs_file_collective_read_action)
 HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::lseek_action,
         orangefs_file_lseek_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::orangefs_file::open_many_action,
+        orangefs_file_open_many_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::orangefs_file::stat_many_action,
+        orangefs_file_stat_many_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::orangefs_file::unlink_many_action,
+        orangefs_file_unlink_many_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::orangefs_file::create_many_action,
+        orangefs_file_create_many_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::stat_action,
+        orangefs_file_stat_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::mkdir_action,
+        orangefs_file_mkdir_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::rmdir_action,
+        orangefs_file_rmdir_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::rename_action,
+        orangefs_file_rename_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::truncate_action,
+        orangefs_file_truncate_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::opendir_action,
+        orangefs_file_opendir_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::readdir_action,
+        orangefs_file_readdir_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::closedir_action,
+        orangefs_file_closedir_action)
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::orangefs_file::copy_to_action,
+        orangefs_file_copy_to_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::orangefs_file::copy_to_local_file_action,
+        orangefs_file_copy_to_local_file_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::orangefs_file::copy_from_local_file_action,
+        orangefs_file_copy_from_local_file_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::orangefs_file::copy_status_action,
+        orangefs_file_copy_status_action)
+HPX_REGISTER_ACTION_DECLARATION(
+        hpx::io::server::orangefs_file::copy_wait_action,
+        orangefs_file_copy_wait_action)
 
 #endif
 
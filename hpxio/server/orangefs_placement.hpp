@@ -0,0 +1,40 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_ORANGEFS_PLACEMENT_HPP_JUN_29_2015_1150AM)
+#define HPX_COMPONENTS_IO_SERVER_ORANGEFS_PLACEMENT_HPP_JUN_29_2015_1150AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/config/export_definitions.hpp>
+#include <hpx/runtime/actions/plain_action.hpp>
+
+#include <boost/cstdint.hpp>
+
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // The host names of the OrangeFS servers holding the datafiles of the
+    // given file, one entry per datafile in distribution order. The list is
+    // empty if the file does not exist or its layout cannot be queried.
+    // This issues blocking metadata requests, call it on the io_pool.
+    HPX_COMPONENT_EXPORT std::vector<std::string> orangefs_data_hosts(
+        std::string const& path);
+
+    // how many of the given host names denote this locality's host
+    HPX_COMPONENT_EXPORT boost::uint64_t local_host_share(
+        std::vector<std::string> const& hosts);
+
+    HPX_DEFINE_PLAIN_ACTION(local_host_share, local_host_share_action);
+
+}}} // hpx::io::server
+
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_host_share_action,
+        local_host_share_action)
+
+#endif
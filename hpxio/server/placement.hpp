@@ -0,0 +1,35 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_PLACEMENT_HPP_JUN_29_2015_1010AM)
+#define HPX_COMPONENTS_IO_SERVER_PLACEMENT_HPP_JUN_29_2015_1010AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/config/export_definitions.hpp>
+#include <hpx/runtime/actions/plain_action.hpp>
+
+#include <boost/cstdint.hpp>
+
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Number of bytes of the given file which are stored on a disk of this
+    // locality. Files on network file systems (NFS, Lustre, OrangeFS, ...)
+    // and files which do not exist yield 0, they are equally close to every
+    // locality.
+    HPX_COMPONENT_EXPORT boost::uint64_t local_data_size(
+        std::string const& path);
+
+    HPX_DEFINE_PLAIN_ACTION(local_data_size, local_data_size_action);
+
+}}} // hpx::io::server
+
+HPX_REGISTER_ACTION_DECLARATION(hpx::io::server::local_data_size_action,
+        local_data_size_action)
+
+#endif
@@ -0,0 +1,72 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_URING_ENGINE_HPP_JUN_02_2015_0910AM)
+#define HPX_COMPONENTS_IO_SERVER_URING_ENGINE_HPP_JUN_02_2015_0910AM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/config/export_definitions.hpp>
+#include <hpx/lcos/future.hpp>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <string>
+
+#include <sys/types.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // The uring_engine submits file requests to a Linux io_uring instance
+    // directly from the calling HPX thread and completes the returned futures
+    // from a dedicated completion poller, so outstanding requests do not park
+    // an io_pool OS-thread each.
+    //
+    // There is one engine per locality. It is only used if the library was
+    // built with liburing, the ini entry 'hpxio.local_file.io_uring' is set
+    // to 1 and the kernel accepts the ring setup; otherwise is_available()
+    // returns false and callers keep using the io_pool path.
+    //
+    // All buffers and path names handed to the engine have to stay valid
+    // until the returned future becomes ready.
+    class HPX_COMPONENT_EXPORT uring_engine : boost::noncopyable
+    {
+      public:
+        struct impl;
+
+        static uring_engine& get();
+
+        bool is_available() const;
+
+        // open a file, the future returns the new descriptor or -errno
+        hpx::future<int> open(char const* name, int flags, mode_t mode);
+
+        hpx::future<int> close(int fd);
+
+        hpx::future<int> unlink(char const* name);
+
+        // an offset of -1 uses (and advances) the current file position
+        hpx::future<ssize_t> read(int fd, char* buf, size_t count,
+            off_t offset = -1);
+
+        hpx::future<ssize_t> write(int fd, char const* buf, size_t count,
+            off_t offset = -1);
+
+        // flush the file to stable storage, only the data and the metadata
+        // needed to read it back if datasync is set
+        hpx::future<int> fsync(int fd, bool datasync = false);
+
+      private:
+        uring_engine();
+        ~uring_engine();
+
+        boost::scoped_ptr<impl> impl_;
+    };
+
+}}} // hpx::io::server
+
+#endif
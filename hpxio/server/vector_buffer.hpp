@@ -0,0 +1,79 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_VECTOR_BUFFER_HPP_JUL_14_2015_1015AM)
+#define HPX_COMPONENTS_IO_SERVER_VECTOR_BUFFER_HPP_JUL_14_2015_1015AM
+
+#include <hpx/util/serialize_buffer.hpp>
+
+#include <boost/shared_ptr.hpp>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // The data-bearing actions carry their payload as serialize_buffer<char>,
+    // which is sent as a separate zero-copy chunk and received directly into
+    // its final memory. A std::vector<char> would be copied into and out of
+    // the parcel on both ends. These helpers convert at the API boundary.
+    namespace detail
+    {
+        // keeps the vector alive for as long as the buffer refers to it
+        struct vector_deleter
+        {
+            explicit vector_deleter(
+                    boost::shared_ptr<std::vector<char> > const& v)
+              : v_(v)
+            {}
+
+            void operator()(char*)
+            {
+                v_.reset();
+            }
+
+            boost::shared_ptr<std::vector<char> > v_;
+        };
+    }
+
+    // hand the data of the vector over to a buffer without copying it
+    inline hpx::util::serialize_buffer<char> to_buffer(
+        std::vector<char>&& data)
+    {
+        typedef hpx::util::serialize_buffer<char> buffer_type;
+        if (data.empty())
+        {
+            return buffer_type();
+        }
+
+        boost::shared_ptr<std::vector<char> > v(
+            new std::vector<char>(std::move(data)));
+        return buffer_type(v->data(), v->size(), buffer_type::take,
+            detail::vector_deleter(v));
+    }
+
+    inline hpx::util::serialize_buffer<char> to_buffer(
+        std::vector<char> const& data)
+    {
+        typedef hpx::util::serialize_buffer<char> buffer_type;
+        if (data.empty())
+        {
+            return buffer_type();
+        }
+        return buffer_type(data.data(), data.size(), buffer_type::copy);
+    }
+
+    inline std::vector<char> to_vector(
+        hpx::util::serialize_buffer<char> const& data)
+    {
+        return std::vector<char>(data.data(), data.data() + data.size());
+    }
+
+}}} // hpx::io::server
+
+#endif
@@ -0,0 +1,288 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPONENTS_IO_SERVER_WRITE_BEHIND_BUFFER_HPP_JUN_15_2015_0220PM)
+#define HPX_COMPONENTS_IO_SERVER_WRITE_BEHIND_BUFFER_HPP_JUN_15_2015_0220PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/lcos/local/mutex.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/runtime/get_config_entry.hpp>
+#include <hpx/util/bind.hpp>
+#include <hpx/util/function.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
+#include <hpx/util/interval_timer.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Staging area for positional writes of one file. Staged extents which
+    // overlap or touch each other are merged right away (later data wins),
+    // so a flush issues one large write per contiguous range.
+    //
+    // Write-behind is opt-in through the ini entries
+    //
+    //     hpxio.write_behind.enabled    1 to stage pwrite (default: 0)
+    //     hpxio.write_behind.threshold  staged bytes forcing a flush
+    //                                   (default: 4M)
+    //     hpxio.write_behind.max_delay  age in ms of the oldest staged data
+    //                                   forcing a flush (default: 100)
+    //
+    // The thresholds are checked whenever data is staged, a flush_timer
+    // makes sure data staged by the last write of a burst does not sit
+    // longer than max_delay.
+    class write_behind_buffer : boost::noncopyable
+    {
+      private:
+        typedef hpx::lcos::local::spinlock mutex_type;
+
+      public:
+        typedef std::map<off_t, std::vector<char> > extent_map;
+
+        write_behind_buffer()
+          : enabled_(false), threshold_(4 * 1024 * 1024),
+            max_delay_(100 * 1000000ull), size_(0), first_staged_(0)
+        {
+            enabled_ = hpx::get_config_entry(
+                "hpxio.write_behind.enabled", "0") == "1";
+            threshold_ = boost::lexical_cast<std::size_t>(
+                hpx::get_config_entry("hpxio.write_behind.threshold",
+                    "4194304"));
+            max_delay_ = 1000000ull * boost::lexical_cast<boost::uint64_t>(
+                hpx::get_config_entry("hpxio.write_behind.max_delay", "100"));
+        }
+
+        bool enabled() const
+        {
+            return enabled_;
+        }
+
+        // stage a copy of the data, returns whether a flush is due
+        bool stage(char const* data, std::size_t count, off_t offset)
+        {
+            if (count == 0)
+            {
+                return false;
+            }
+
+            mutex_type::scoped_lock l(mtx_);
+
+            if (extents_.empty())
+            {
+                first_staged_ = hpx::util::high_resolution_clock::now();
+            }
+            size_ += insert(extents_, data, count, offset);
+
+            return size_ >= threshold_ ||
+                hpx::util::high_resolution_clock::now() - first_staged_ >=
+                    max_delay_;
+        }
+
+        // merge a copy of the data into extents, returns by how many bytes
+        // the extents have grown
+        static std::size_t insert(extent_map& extents, char const* data,
+            std::size_t count, off_t offset)
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+
+            off_t begin = offset;
+            off_t end = offset + count;
+
+            // find all staged extents overlapping or adjacent to the new one
+            extent_map::iterator first = extents.upper_bound(begin);
+            if (first != extents.begin())
+            {
+                extent_map::iterator prev = first;
+                --prev;
+                if (prev->first + off_t(prev->second.size()) >= begin)
+                {
+                    first = prev;
+                }
+            }
+
+            extent_map::iterator last = first;
+            while (last != extents.end() && last->first <= end)
+            {
+                begin = (std::min)(begin, last->first);
+                end = (std::max)(end,
+                    off_t(last->first + last->second.size()));
+                ++last;
+            }
+
+            if (first == last)
+            {
+                extents[offset].assign(data, data + count);
+                return count;
+            }
+
+            std::size_t replaced = 0;
+            std::vector<char> merged(end - begin);
+            for (extent_map::iterator it = first; it != last; ++it)
+            {
+                std::memcpy(merged.data() + (it->first - begin),
+                    it->second.data(), it->second.size());
+                replaced += it->second.size();
+            }
+            std::memcpy(merged.data() + (offset - begin), data, count);
+
+            extents.erase(first, last);
+            std::size_t const grown = merged.size() - replaced;
+            extents[begin].swap(merged);
+            return grown;
+        }
+
+        bool empty() const
+        {
+            mutex_type::scoped_lock l(mtx_);
+            return extents_.empty();
+        }
+
+        // whether the oldest staged data is older than max_delay
+        bool due() const
+        {
+            mutex_type::scoped_lock l(mtx_);
+            return !extents_.empty() &&
+                hpx::util::high_resolution_clock::now() - first_staged_ >=
+                    max_delay_;
+        }
+
+        // in nanoseconds
+        boost::uint64_t max_delay() const
+        {
+            return max_delay_;
+        }
+
+        bool overlaps(off_t offset, std::size_t count) const
+        {
+            off_t const end = offset + count;
+
+            mutex_type::scoped_lock l(mtx_);
+            extent_map::const_iterator it = extents_.lower_bound(end);
+            if (it == extents_.begin())
+            {
+                return false;
+            }
+            --it;
+            return it->first + off_t(it->second.size()) > offset;
+        }
+
+        // hand out everything staged so far
+        extent_map take()
+        {
+            extent_map result;
+
+            mutex_type::scoped_lock l(mtx_);
+            result.swap(extents_);
+            size_ = 0;
+            return result;
+        }
+
+      private:
+        bool enabled_;
+        std::size_t threshold_;
+        boost::uint64_t max_delay_;
+
+        mutable mutex_type mtx_;
+        extent_map extents_;
+        std::size_t size_;
+        boost::uint64_t first_staged_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Periodically calls the given function, twice per max_delay of the
+    // write_behind_buffer it is started for. stop() waits for a running
+    // call and makes sure no further call happens, the owner has to call it
+    // before it goes away.
+    class flush_timer : boost::noncopyable
+    {
+      private:
+        typedef hpx::lcos::local::mutex mutex_type;
+
+        struct shared_state
+        {
+            mutex_type mtx_;
+            hpx::util::function_nonser<void()> f_;
+        };
+
+        static bool evaluate(boost::shared_ptr<shared_state> const& state)
+        {
+            mutex_type::scoped_lock l(state->mtx_);
+            if (state->f_.empty())
+            {
+                return false;
+            }
+            state->f_();
+            return true;
+        }
+
+      public:
+        flush_timer()
+          : state_(boost::make_shared<shared_state>())
+        {}
+
+        ~flush_timer()
+        {
+            stop();
+        }
+
+        template <typename F>
+        void start(write_behind_buffer const& buffer, F && f)
+        {
+            if (!buffer.enabled())
+            {
+                return;
+            }
+
+            state_->f_ = std::forward<F>(f);
+
+            // in microseconds
+            boost::int64_t const interval = (std::max)(
+                boost::int64_t(buffer.max_delay() / 2000),
+                boost::int64_t(1000));
+            timer_.reset(new hpx::util::interval_timer(
+                hpx::util::bind(&flush_timer::evaluate, state_), interval,
+                "hpxio write-behind flush", true));
+            timer_->start();
+        }
+
+        void stop()
+        {
+            {
+                mutex_type::scoped_lock l(state_->mtx_);
+                state_->f_ = hpx::util::function_nonser<void()>();
+            }
+            if (timer_)
+            {
+                timer_->stop();
+                timer_.reset();
+            }
+        }
+
+      private:
+        boost::shared_ptr<shared_state> state_;
+        boost::shared_ptr<hpx::util::interval_timer> timer_;
+    };
+
+}}} // hpx::io::server
+
+#endif
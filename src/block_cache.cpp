@@ -0,0 +1,20 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx.hpp>
+
+#include <hpxio/server/block_cache.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    // the one cache of the process, shared by all modules using it
+    block_cache& block_cache::get()
+    {
+        static block_cache cache;
+        return cache;
+    }
+
+}}} // hpx::io::server
@@ -0,0 +1,40 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+
+#include <hpxio/server/io_scheduler.hpp>
+#include <hpxio/server/io_statistics.hpp>
+
+#include <boost/shared_ptr.hpp>
+
+#include <map>
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    // as with the io_statistics the instances live until the process exits,
+    // the counters and the components keep references to them
+    io_scheduler& io_scheduler::get(std::string const& backend)
+    {
+        typedef hpx::lcos::local::spinlock mutex_type;
+        typedef std::map<std::string, boost::shared_ptr<io_scheduler> >
+            map_type;
+
+        static mutex_type mtx;
+        static map_type schedulers;
+
+        mutex_type::scoped_lock l(mtx);
+        boost::shared_ptr<io_scheduler>& s = schedulers[backend];
+        if (!s)
+        {
+            s.reset(new io_scheduler(io_statistics::get(backend)));
+        }
+        return *s;
+    }
+
+}}} // hpx::io::server
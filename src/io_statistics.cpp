@@ -0,0 +1,40 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+
+#include <hpxio/server/io_statistics.hpp>
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <map>
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    // the instances are never destroyed before the process exits, the
+    // counters and the components keep references to them
+    io_statistics& io_statistics::get(std::string const& backend)
+    {
+        typedef hpx::lcos::local::spinlock mutex_type;
+        typedef std::map<std::string, boost::shared_ptr<io_statistics> >
+            map_type;
+
+        static mutex_type mtx;
+        static map_type stats;
+
+        mutex_type::scoped_lock l(mtx);
+        boost::shared_ptr<io_statistics>& s = stats[backend];
+        if (!s)
+        {
+            s = boost::make_shared<io_statistics>();
+        }
+        return *s;
+    }
+
+}}} // hpx::io::server
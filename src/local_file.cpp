@@ -11,12 +11,36 @@
 #include <hpxio/local_file.hpp>
 
 #include <boost/serialization/serialization.hpp>
+#include <boost/serialization/string.hpp>
 #include <boost/serialization/vector.hpp>
 
 ///////////////////////////////////////////////////////////////////////////////
 // Add factory registration functionality
 HPX_REGISTER_COMPONENT_MODULE()
 
+///////////////////////////////////////////////////////////////////////////////
+// Install the /hpxio/local_file/... and /hpxio/cache/... performance
+// counters on every locality which loads this module
+namespace
+{
+    void register_counters()
+    {
+        hpx::io::server::register_counters("local_file");
+        hpx::io::server::register_scheduler_counters("local_file");
+        hpx::io::server::register_cache_counters();
+    }
+
+    bool get_startup(hpx::startup_function_type& startup_func,
+        bool& pre_startup)
+    {
+        startup_func = register_counters;
+        pre_startup = true;
+        return true;
+    }
+}
+
+HPX_REGISTER_STARTUP_MODULE(get_startup)
+
 ///////////////////////////////////////////////////////////////////////////////
 typedef hpx::io::server::local_file local_file_type;
 
@@ -40,17 +64,86 @@ HPX_REGISTER_ACTION(
     local_file_type::remove_file_action,
     local_file_remove_file_action)
 HPX_REGISTER_ACTION(
-    local_file_type::read_action,
-    local_file_read_action)
+    local_file_type::read_buffer_action,
+    local_file_read_buffer_action)
 HPX_REGISTER_ACTION(
-    local_file_type::pread_action,
-    local_file_pread_action)
+    local_file_type::pread_buffer_action,
+    local_file_pread_buffer_action)
 HPX_REGISTER_ACTION(
     local_file_type::write_action,
     local_file_write_action)
 HPX_REGISTER_ACTION(
     local_file_type::pwrite_action,
     local_file_pwrite_action)
+HPX_REGISTER_ACTION(
+    local_file_type::preadv_buffer_action,
+    local_file_preadv_buffer_action)
+HPX_REGISTER_ACTION(
+    local_file_type::pwritev_action,
+    local_file_pwritev_action)
+HPX_REGISTER_ACTION(
+    local_file_type::flush_action,
+    local_file_flush_action)
+HPX_REGISTER_ACTION(
+    local_file_type::fsync_action,
+    local_file_fsync_action)
+HPX_REGISTER_ACTION(
+    local_file_type::fdatasync_action,
+    local_file_fdatasync_action)
+HPX_REGISTER_ACTION(
+    local_file_type::collective_write_action,
+    local_file_collective_write_action)
+HPX_REGISTER_ACTION(
+    local_file_type::collective_read_action,
+    local_file_collective_read_action)
 HPX_REGISTER_ACTION(
     local_file_type::lseek_action,
     local_file_lseek_action)
+HPX_REGISTER_ACTION(
+    local_file_type::seek_action,
+    local_file_seek_action)
+HPX_REGISTER_ACTION(
+    local_file_type::open_many_action,
+    local_file_open_many_action)
+HPX_REGISTER_ACTION(
+    local_file_type::stat_many_action,
+    local_file_stat_many_action)
+HPX_REGISTER_ACTION(
+    local_file_type::unlink_many_action,
+    local_file_unlink_many_action)
+HPX_REGISTER_ACTION(
+    local_file_type::create_many_action,
+    local_file_create_many_action)
+HPX_REGISTER_ACTION(
+    local_file_type::stat_action,
+    local_file_stat_action)
+HPX_REGISTER_ACTION(
+    local_file_type::mkdir_action,
+    local_file_mkdir_action)
+HPX_REGISTER_ACTION(
+    local_file_type::rmdir_action,
+    local_file_rmdir_action)
+HPX_REGISTER_ACTION(
+    local_file_type::rename_action,
+    local_file_rename_action)
+HPX_REGISTER_ACTION(
+    local_file_type::truncate_action,
+    local_file_truncate_action)
+HPX_REGISTER_ACTION(
+    local_file_type::opendir_action,
+    local_file_opendir_action)
+HPX_REGISTER_ACTION(
+    local_file_type::readdir_action,
+    local_file_readdir_action)
+HPX_REGISTER_ACTION(
+    local_file_type::closedir_action,
+    local_file_closedir_action)
+HPX_REGISTER_ACTION(
+    local_file_type::copy_to_action,
+    local_file_copy_to_action)
+HPX_REGISTER_ACTION(
+    local_file_type::copy_status_action,
+    local_file_copy_status_action)
+HPX_REGISTER_ACTION(
+    local_file_type::copy_wait_action,
+    local_file_copy_wait_action)
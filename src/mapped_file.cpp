@@ -0,0 +1,46 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx.hpp>
+#include <hpx/include/components.hpp>
+#include <hpx/include/serialization.hpp>
+
+#include <hpxio/mapped_file.hpp>
+
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/vector.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+// Add factory registration functionality
+HPX_REGISTER_COMPONENT_MODULE()
+
+///////////////////////////////////////////////////////////////////////////////
+typedef hpx::io::server::mapped_file mapped_file_type;
+
+HPX_REGISTER_MINIMAL_COMPONENT_FACTORY(
+    hpx::components::managed_component<mapped_file_type>,
+    mapped_file, hpx::components::factory_enabled)
+HPX_DEFINE_GET_COMPONENT_TYPE(mapped_file_type)
+
+///////////////////////////////////////////////////////////////////////////////
+// Serialization support for the mapped_file actions
+HPX_REGISTER_ACTION(
+    mapped_file_type::open_action,
+    mapped_file_open_action)
+HPX_REGISTER_ACTION(
+    mapped_file_type::is_open_action,
+    mapped_file_is_open_action)
+HPX_REGISTER_ACTION(
+    mapped_file_type::close_action,
+    mapped_file_close_action)
+HPX_REGISTER_ACTION(
+    mapped_file_type::size_action,
+    mapped_file_size_action)
+HPX_REGISTER_ACTION(
+    mapped_file_type::pread_buffer_action,
+    mapped_file_pread_buffer_action)
+HPX_REGISTER_ACTION(
+    mapped_file_type::prefetch_action,
+    mapped_file_prefetch_action)
@@ -11,12 +11,35 @@
 #include <hpxio/orangefs_file.hpp>
 
 #include <boost/serialization/serialization.hpp>
+#include <boost/serialization/string.hpp>
 #include <boost/serialization/vector.hpp>
 
 ///////////////////////////////////////////////////////////////////////////////
 // Add factory registration functionality
 HPX_REGISTER_COMPONENT_MODULE()
 
+///////////////////////////////////////////////////////////////////////////////
+// Install the /hpxio/orangefs_file/... performance counters on every locality
+// which loads this module
+namespace
+{
+    void register_counters()
+    {
+        hpx::io::server::register_counters("orangefs_file");
+        hpx::io::server::register_scheduler_counters("orangefs_file");
+    }
+
+    bool get_startup(hpx::startup_function_type& startup_func,
+        bool& pre_startup)
+    {
+        startup_func = register_counters;
+        pre_startup = true;
+        return true;
+    }
+}
+
+HPX_REGISTER_STARTUP_MODULE(get_startup)
+
 ///////////////////////////////////////////////////////////////////////////////
 typedef hpx::io::server::orangefs_file orangefs_file_type;
 
@@ -40,17 +63,89 @@ HPX_REGISTER_ACTION(
     orangefs_file_type::remove_file_action,
     orangefs_file_remove_file_action)
 HPX_REGISTER_ACTION(
-    orangefs_file_type::read_action,
-    orangefs_file_read_action)
+    orangefs_file_type::read_buffer_action,
+    orangefs_file_read_buffer_action)
 HPX_REGISTER_ACTION(
-    orangefs_file_type::pread_action,
-    orangefs_file_pread_action)
+    orangefs_file_type::pread_buffer_action,
+    orangefs_file_pread_buffer_action)
 HPX_REGISTER_ACTION(
     orangefs_file_type::write_action,
     orangefs_file_write_action)
 HPX_REGISTER_ACTION(
     orangefs_file_type::pwrite_action,
     orangefs_file_pwrite_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::preadv_buffer_action,
+    orangefs_file_preadv_buffer_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::pwritev_action,
+    orangefs_file_pwritev_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::flush_action,
+    orangefs_file_flush_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::fsync_action,
+    orangefs_file_fsync_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::fdatasync_action,
+    orangefs_file_fdatasync_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::collective_write_action,
+    orangefs_file_collective_write_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::collective_read_action,
+    orangefs_file_collective_read_action)
 HPX_REGISTER_ACTION(
     orangefs_file_type::lseek_action,
     orangefs_file_lseek_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::open_many_action,
+    orangefs_file_open_many_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::stat_many_action,
+    orangefs_file_stat_many_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::unlink_many_action,
+    orangefs_file_unlink_many_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::create_many_action,
+    orangefs_file_create_many_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::stat_action,
+    orangefs_file_stat_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::mkdir_action,
+    orangefs_file_mkdir_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::rmdir_action,
+    orangefs_file_rmdir_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::rename_action,
+    orangefs_file_rename_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::truncate_action,
+    orangefs_file_truncate_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::opendir_action,
+    orangefs_file_opendir_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::readdir_action,
+    orangefs_file_readdir_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::closedir_action,
+    orangefs_file_closedir_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::copy_to_action,
+    orangefs_file_copy_to_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::copy_to_local_file_action,
+    orangefs_file_copy_to_local_file_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::copy_from_local_file_action,
+    orangefs_file_copy_from_local_file_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::copy_status_action,
+    orangefs_file_copy_status_action)
+HPX_REGISTER_ACTION(
+    orangefs_file_type::copy_wait_action,
+    orangefs_file_copy_wait_action)
@@ -0,0 +1,161 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx.hpp>
+#include <hpx/include/actions.hpp>
+#include <hpx/include/serialization.hpp>
+
+#include <hpxio/server/orangefs_placement.hpp>
+
+#include <boost/asio/ip/host_name.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+/* ------------------------  added pvfs header stuff --------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <pvfs2.h>
+#include <pvfs2-mgmt.h>
+#include <pvfs2-util.h>
+
+#ifdef __cplusplus
+} //extern "C" {
+#endif
+
+/* -------------------------  end pvfs header stuff --------------- */
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    namespace detail
+    {
+        // the system interface is initialized once per process
+        bool init_sysint()
+        {
+            static int const result = PVFS_util_init_defaults();
+            return result == 0;
+        }
+
+        // "tcp://host:3334" -> "host"
+        std::string host_of_address(char const* address)
+        {
+            std::string host(address ? address : "");
+
+            std::string::size_type pos = host.find("://");
+            if (pos != std::string::npos)
+            {
+                host.erase(0, pos + 3);
+            }
+
+            pos = host.find_first_of(":/");
+            if (pos != std::string::npos)
+            {
+                host.erase(pos);
+            }
+            return host;
+        }
+
+        // compare host names with and without their domain
+        std::string short_host_name(std::string const& host)
+        {
+            return host.substr(0, host.find('.'));
+        }
+    }
+
+    std::vector<std::string> orangefs_data_hosts(std::string const& path)
+    {
+        std::vector<std::string> hosts;
+        if (!detail::init_sysint())
+        {
+            return hosts;
+        }
+
+        PVFS_fs_id fs_id;
+        char pvfs_path[PVFS_NAME_MAX] = { 0 };
+        if (PVFS_util_resolve(path.c_str(), &fs_id, pvfs_path,
+                PVFS_NAME_MAX) < 0)
+        {
+            return hosts;
+        }
+
+        PVFS_credential credential;
+        if (PVFS_util_gen_credential_defaults(&credential) < 0)
+        {
+            return hosts;
+        }
+
+        PVFS_sysresp_lookup lookup;
+        std::memset(&lookup, 0, sizeof(lookup));
+        if (PVFS_sys_lookup(fs_id, pvfs_path, &credential, &lookup,
+                PVFS2_LOOKUP_LINK_FOLLOW, NULL) < 0)
+        {
+            PVFS_util_release_credential(&credential);
+            return hosts;
+        }
+
+        PVFS_sysresp_getattr getattr;
+        std::memset(&getattr, 0, sizeof(getattr));
+        if (PVFS_sys_getattr(lookup.ref, PVFS_ATTR_SYS_DFILE_COUNT,
+                &credential, &getattr, NULL) < 0)
+        {
+            PVFS_util_release_credential(&credential);
+            return hosts;
+        }
+
+        int const dfile_count = getattr.attr.dfile_count;
+        PVFS_util_release_sys_attr(&getattr.attr);
+
+        std::vector<PVFS_handle> dfiles(dfile_count > 0 ? dfile_count : 0);
+        if (!dfiles.empty() &&
+            PVFS_mgmt_get_dfile_array(lookup.ref, &credential,
+                dfiles.data(), dfile_count, NULL) == 0)
+        {
+            hosts.reserve(dfiles.size());
+            for (std::size_t i = 0; i != dfiles.size(); ++i)
+            {
+                PVFS_BMI_addr_t addr;
+                if (PVFS_mgmt_map_handle(fs_id, dfiles[i], &addr) != 0)
+                {
+                    continue;
+                }
+
+                int server_type = 0;
+                hosts.push_back(detail::host_of_address(
+                    PVFS_mgmt_map_addr(fs_id, addr, &server_type)));
+            }
+        }
+
+        PVFS_util_release_credential(&credential);
+        return hosts;
+    }
+
+    boost::uint64_t local_host_share(std::vector<std::string> const& hosts)
+    {
+        std::string const here =
+            detail::short_host_name(boost::asio::ip::host_name());
+
+        boost::uint64_t share = 0;
+        for (std::size_t i = 0; i != hosts.size(); ++i)
+        {
+            if (detail::short_host_name(hosts[i]) == here)
+            {
+                ++share;
+            }
+        }
+        return share;
+    }
+
+}}} // hpx::io::server
+
+///////////////////////////////////////////////////////////////////////////////
+HPX_REGISTER_ACTION(hpx::io::server::local_host_share_action,
+    local_host_share_action)
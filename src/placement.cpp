@@ -0,0 +1,77 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx.hpp>
+#include <hpx/include/actions.hpp>
+#include <hpx/include/serialization.hpp>
+
+#include <hpxio/server/placement.hpp>
+
+#include <string>
+
+#include <sys/stat.h>
+
+#if defined(__linux__)
+#include <sys/vfs.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+    namespace detail
+    {
+        // file systems whose data does not live on this node
+        bool is_network_file_system(std::string const& path)
+        {
+#if defined(__linux__)
+            struct statfs fs;
+            if (::statfs(path.c_str(), &fs) != 0)
+            {
+                return false;
+            }
+
+            switch (static_cast<unsigned long>(fs.f_type))
+            {
+            case 0x6969UL:          // NFS
+            case 0x517BUL:          // SMB
+            case 0xFF534D42UL:      // CIFS
+            case 0xFE534D42UL:      // SMB2
+            case 0x0BD00BD0UL:      // Lustre
+            case 0x47504653UL:      // GPFS
+            case 0x20030528UL:      // OrangeFS (pvfs2 kernel module)
+            case 0x65735546UL:      // FUSE, e.g. the pvfs2fuse client
+            case 0x00C36400UL:      // Ceph
+                return true;
+            default:
+                break;
+            }
+#endif
+            return false;
+        }
+    }
+
+    boost::uint64_t local_data_size(std::string const& path)
+    {
+        struct stat st;
+        if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            return 0;
+        }
+
+        if (detail::is_network_file_system(path))
+        {
+            return 0;
+        }
+
+        // count at least one byte, an empty local file is still local
+        boost::uint64_t const size = boost::uint64_t(st.st_blocks) * 512;
+        return size ? size : 1;
+    }
+
+}}} // hpx::io::server
+
+///////////////////////////////////////////////////////////////////////////////
+HPX_REGISTER_ACTION(hpx::io::server::local_data_size_action,
+    local_data_size_action)
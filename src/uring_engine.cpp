@@ -0,0 +1,389 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx.hpp>
+#include <hpx/include/runtime.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/lcos/local/promise.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/util/function.hpp>
+
+#include <hpxio/server/uring_engine.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <cerrno>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+
+#if defined(HPXIO_HAVE_IO_URING)
+#include <liburing.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace io { namespace server
+{
+#if defined(HPXIO_HAVE_IO_URING)
+    namespace detail
+    {
+        struct request_base
+        {
+            virtual ~request_base() {}
+            virtual void complete(int result) = 0;
+        };
+
+        template <typename T>
+        struct request : request_base
+        {
+            lcos::local::promise<T> p_;
+
+            void complete(int result)
+            {
+                // notify the waiting HPX thread and return a value
+                p_.set_value(static_cast<T>(result));
+                delete this;
+            }
+        };
+
+        void complete_request(request_base* req, int result)
+        {
+            req->complete(result);
+        }
+
+        // let other threads run while the ring has no room
+        void back_off()
+        {
+            if (hpx::threads::get_self_ptr() != 0)
+            {
+                hpx::this_thread::suspend();
+            }
+            else
+            {
+                boost::this_thread::yield();
+            }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    struct uring_engine::impl
+    {
+        typedef hpx::lcos::local::spinlock mutex_type;
+        typedef hpx::util::function_nonser<void(io_uring_sqe*)> prep_type;
+        typedef std::pair<prep_type, detail::request_base*> pending_type;
+
+        impl()
+          : available_(false), submitting_(false), outstanding_(0),
+            rt_p_(hpx::get_runtime_ptr())
+        {
+            std::string enabled =
+                hpx::get_config_entry("hpxio.local_file.io_uring", "0");
+            if (enabled != "1")
+            {
+                return;
+            }
+
+            unsigned depth = boost::lexical_cast<unsigned>(
+                hpx::get_config_entry("hpxio.local_file.io_uring_depth",
+                    "256"));
+
+            if (io_uring_queue_init(depth, &ring_, 0) < 0)
+            {
+                return;
+            }
+
+            available_ = true;
+            poller_ = boost::thread(&impl::poll, this);
+
+            // the poller has to be gone before the runtime shuts down
+            hpx::register_pre_shutdown_function(
+                hpx::util::bind(&impl::stop, this));
+        }
+
+        ~impl()
+        {
+            stop();
+        }
+
+        // called at pre-shutdown and again from the destructor, only the
+        // first call tears the ring down. The poller keeps going until all
+        // requests submitted before have completed.
+        void stop()
+        {
+            if (!available_.exchange(false))
+            {
+                return;
+            }
+
+            // a NOP without a request attached tells the poller to exit
+            submit(
+                [](io_uring_sqe* sqe)
+                {
+                    io_uring_prep_nop(sqe);
+                },
+                static_cast<detail::request_base*>(0));
+
+            poller_.join();
+            io_uring_queue_exit(&ring_);
+        }
+
+        // this runs on a plain OS-thread, it only touches HPX after having
+        // registered itself once with the runtime
+        void poll()
+        {
+            bool registered = rt_p_->register_thread("hpxio-uring-poller");
+
+            bool stopping = false;
+            while (!stopping || outstanding_.load() != 0)
+            {
+                io_uring_cqe* cqe = 0;
+                int r = io_uring_wait_cqe(&ring_, &cqe);
+                if (r < 0)
+                {
+                    if (r == -EINTR) continue;
+                    break;
+                }
+
+                // drain everything which is ready in one go
+                do {
+                    detail::request_base* req =
+                        static_cast<detail::request_base*>(
+                            io_uring_cqe_get_data(cqe));
+                    int result = cqe->res;
+                    io_uring_cqe_seen(&ring_, cqe);
+
+                    if (req == 0)
+                    {
+                        stopping = true;
+                        continue;
+                    }
+                    --outstanding_;
+
+                    // Create an HPX thread to guarantee that the
+                    // promise::set_value function can be invoked safely.
+                    hpx::threads::register_thread(hpx::util::bind(
+                        &detail::complete_request, req, result));
+
+                } while (io_uring_peek_cqe(&ring_, &cqe) == 0);
+            }
+
+            if (registered) rt_p_->unregister_thread();
+        }
+
+        // Requests are queued under the spinlock only. The thread which
+        // finds no other one submitting moves all queued requests into the
+        // ring and hands them to the kernel, outside of the spinlock.
+        template <typename F>
+        void submit(F const& prep, detail::request_base* req)
+        {
+            {
+                mutex_type::scoped_lock l(mtx_);
+                pending_.push_back(pending_type(prep_type(prep), req));
+            }
+            flush();
+        }
+
+        void flush()
+        {
+            for (;;)
+            {
+                if (submitting_.exchange(true))
+                {
+                    // the thread submitting right now picks up our requests
+                    return;
+                }
+
+                std::vector<pending_type> pending;
+                {
+                    mutex_type::scoped_lock l(mtx_);
+                    pending.swap(pending_);
+                }
+
+                for (std::size_t i = 0; i != pending.size(); ++i)
+                {
+                    io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+                    while (sqe == 0)
+                    {
+                        // the submission queue is full, hand it to the kernel
+                        if (io_uring_submit(&ring_) <= 0)
+                        {
+                            detail::back_off();
+                        }
+                        sqe = io_uring_get_sqe(&ring_);
+                    }
+
+                    pending[i].first(sqe);
+                    io_uring_sqe_set_data(sqe, pending[i].second);
+                }
+                if (!pending.empty())
+                {
+                    io_uring_submit(&ring_);
+                }
+
+                submitting_.store(false);
+
+                // requests queued after the swap above are ours to submit
+                mutex_type::scoped_lock l(mtx_);
+                if (pending_.empty())
+                {
+                    return;
+                }
+            }
+        }
+
+        // requests arriving once stop() has begun are failed right away,
+        // the poller may be gone before they would complete
+        template <typename T, typename F>
+        hpx::future<T> submit(F const& prep)
+        {
+            ++outstanding_;
+            if (!available_.load())
+            {
+                --outstanding_;
+                return hpx::make_ready_future(static_cast<T>(-ECANCELED));
+            }
+
+            detail::request<T>* req = new detail::request<T>();
+            hpx::future<T> f = req->p_.get_future();
+            submit(prep, req);
+            return f;
+        }
+
+        boost::atomic<bool> available_;
+        boost::atomic<bool> submitting_;
+        boost::atomic<std::size_t> outstanding_;
+        hpx::runtime* rt_p_;
+        mutex_type mtx_;
+        std::vector<pending_type> pending_;
+        io_uring ring_;
+        boost::thread poller_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool uring_engine::is_available() const
+    {
+        return impl_->available_.load();
+    }
+
+    hpx::future<int> uring_engine::open(char const* name, int flags,
+        mode_t mode)
+    {
+        return impl_->submit<int>(
+            [=](io_uring_sqe* sqe)
+            {
+                io_uring_prep_openat(sqe, AT_FDCWD, name, flags, mode);
+            });
+    }
+
+    hpx::future<int> uring_engine::close(int fd)
+    {
+        return impl_->submit<int>(
+            [=](io_uring_sqe* sqe)
+            {
+                io_uring_prep_close(sqe, fd);
+            });
+    }
+
+    hpx::future<int> uring_engine::unlink(char const* name)
+    {
+        return impl_->submit<int>(
+            [=](io_uring_sqe* sqe)
+            {
+                io_uring_prep_unlinkat(sqe, AT_FDCWD, name, 0);
+            });
+    }
+
+    hpx::future<ssize_t> uring_engine::read(int fd, char* buf, size_t count,
+        off_t offset)
+    {
+        return impl_->submit<ssize_t>(
+            [=](io_uring_sqe* sqe)
+            {
+                io_uring_prep_read(sqe, fd, buf, count, offset);
+            });
+    }
+
+    hpx::future<ssize_t> uring_engine::write(int fd, char const* buf,
+        size_t count, off_t offset)
+    {
+        return impl_->submit<ssize_t>(
+            [=](io_uring_sqe* sqe)
+            {
+                io_uring_prep_write(sqe, fd, buf, count, offset);
+            });
+    }
+
+    hpx::future<int> uring_engine::fsync(int fd, bool datasync)
+    {
+        return impl_->submit<int>(
+            [=](io_uring_sqe* sqe)
+            {
+                io_uring_prep_fsync(sqe, fd,
+                    datasync ? IORING_FSYNC_DATASYNC : 0);
+            });
+    }
+
+#else
+
+    ///////////////////////////////////////////////////////////////////////////
+    // built without liburing, the engine is never available
+    struct uring_engine::impl {};
+
+    bool uring_engine::is_available() const
+    {
+        return false;
+    }
+
+    hpx::future<int> uring_engine::open(char const*, int, mode_t)
+    {
+        return hpx::make_ready_future(-ENOSYS);
+    }
+
+    hpx::future<int> uring_engine::close(int)
+    {
+        return hpx::make_ready_future(-ENOSYS);
+    }
+
+    hpx::future<int> uring_engine::unlink(char const*)
+    {
+        return hpx::make_ready_future(-ENOSYS);
+    }
+
+    hpx::future<ssize_t> uring_engine::read(int, char*, size_t, off_t)
+    {
+        return hpx::make_ready_future(static_cast<ssize_t>(-ENOSYS));
+    }
+
+    hpx::future<ssize_t> uring_engine::write(int, char const*, size_t, off_t)
+    {
+        return hpx::make_ready_future(static_cast<ssize_t>(-ENOSYS));
+    }
+
+    hpx::future<int> uring_engine::fsync(int, bool)
+    {
+        return hpx::make_ready_future(-ENOSYS);
+    }
+
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////
+    uring_engine::uring_engine()
+      : impl_(new impl)
+    {}
+
+    uring_engine::~uring_engine()
+    {}
+
+    uring_engine& uring_engine::get()
+    {
+        static uring_engine engine;
+        return engine;
+    }
+
+}}} // hpx::io::server
@@ -0,0 +1,162 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Read-ahead, invalidation on write and the handling of the short block at
+// the end of a file in the block_cache, driven with a file kept in memory.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <hpxio/server/block_cache.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using boost::program_options::variables_map;
+using boost::program_options::options_description;
+
+using hpx::io::server::block_cache;
+
+///////////////////////////////////////////////////////////////////////////////
+// the fetch function handed to block_cache::read, counts the requests
+struct memory_file
+{
+    memory_file(std::size_t size, char c)
+      : data_(size, c), fetches_(0)
+    {}
+
+    ssize_t operator()(char* buf, size_t count, off_t offset) const
+    {
+        ++fetches_;
+        if (offset >= off_t(data_.size()))
+        {
+            return 0;
+        }
+        size_t len = (std::min)(count, data_.size() - size_t(offset));
+        std::memcpy(buf, data_.data() + offset, len);
+        return len;
+    }
+
+    std::vector<char> data_;
+    mutable std::size_t fetches_;
+};
+
+std::size_t const block_size = 16;
+
+///////////////////////////////////////////////////////////////////////////////
+void test_read_ahead()
+{
+    block_cache& cache = block_cache::get();
+    memory_file file(8 * block_size, 'a');
+    char buf[block_size];
+
+    // the first read is not known to be sequential, a single block
+    HPX_TEST_EQ(cache.read("read_ahead", buf, block_size, 0, file),
+        ssize_t(block_size));
+    HPX_TEST_EQ(file.fetches_, std::size_t(1));
+
+    // the next block fetches two more with the same request
+    boost::uint64_t ahead = cache.read_ahead_blocks();
+    HPX_TEST_EQ(cache.read("read_ahead", buf, block_size, block_size, file),
+        ssize_t(block_size));
+    HPX_TEST_EQ(file.fetches_, std::size_t(2));
+    HPX_TEST_EQ(cache.read_ahead_blocks(), ahead + 2);
+
+    // which are then served from the cache
+    boost::uint64_t hits = cache.hits();
+    HPX_TEST_EQ(cache.read("read_ahead", buf, block_size, 2 * block_size,
+        file), ssize_t(block_size));
+    HPX_TEST_EQ(cache.read("read_ahead", buf, block_size, 3 * block_size,
+        file), ssize_t(block_size));
+    HPX_TEST_EQ(file.fetches_, std::size_t(2));
+    HPX_TEST_EQ(cache.hits(), hits + 2);
+}
+
+void test_invalidate_on_write()
+{
+    block_cache& cache = block_cache::get();
+    memory_file file(4 * block_size, 'a');
+    char buf[block_size];
+
+    HPX_TEST_EQ(cache.read("invalidate", buf, block_size, 0, file),
+        ssize_t(block_size));
+    HPX_TEST_EQ(buf[0], 'a');
+
+    // a cached block is not fetched again
+    HPX_TEST_EQ(cache.read("invalidate", buf, block_size, 0, file),
+        ssize_t(block_size));
+    HPX_TEST_EQ(file.fetches_, std::size_t(1));
+
+    {
+        block_cache::write_scope scope("invalidate", 4, 2);
+        file.data_[4] = file.data_[5] = 'b';
+    }
+
+    // the written block is read from the file again
+    HPX_TEST_EQ(cache.read("invalidate", buf, block_size, 0, file),
+        ssize_t(block_size));
+    HPX_TEST_EQ(file.fetches_, std::size_t(2));
+    HPX_TEST_EQ(buf[0], 'a');
+    HPX_TEST_EQ(buf[4], 'b');
+    HPX_TEST_EQ(buf[5], 'b');
+}
+
+void test_eof_block()
+{
+    block_cache& cache = block_cache::get();
+    memory_file file(2 * block_size + 8, 'a');
+    char buf[block_size];
+
+    // the short block at the end of the file is cached as such
+    HPX_TEST_EQ(cache.read("eof", buf, block_size, 2 * block_size, file),
+        ssize_t(8));
+    HPX_TEST_EQ(cache.read("eof", buf, block_size, 2 * block_size, file),
+        ssize_t(8));
+    HPX_TEST_EQ(file.fetches_, std::size_t(1));
+
+    // a write beyond the end makes the file grow without touching that block
+    {
+        block_cache::write_scope scope("eof", 4 * block_size, block_size);
+        file.data_.resize(5 * block_size, 'b');
+    }
+
+    // the old end of the file must not be returned any more
+    HPX_TEST_EQ(cache.read("eof", buf, block_size, 2 * block_size, file),
+        ssize_t(block_size));
+    HPX_TEST_EQ(file.fetches_, std::size_t(2));
+    HPX_TEST_EQ(buf[7], 'a');
+    HPX_TEST_EQ(buf[8], 'b');
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(variables_map&)
+{
+    HPX_TEST(block_cache::get().enabled());
+
+    test_read_ahead();
+    test_invalidate_on_write();
+    test_eof_block();
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    options_description desc_commandline(
+        "Usage: " HPX_APPLICATION_STRING " [options]");
+
+    std::vector<std::string> cfg;
+    cfg.push_back("hpxio.cache.enabled=1");
+    cfg.push_back("hpxio.cache.block_size=16");
+    cfg.push_back("hpxio.cache.capacity=64");
+    cfg.push_back("hpxio.cache.read_ahead=2");
+
+    HPX_TEST_EQ(hpx::init(desc_commandline, argc, argv, cfg), 0);
+    return hpx::util::report_errors();
+}
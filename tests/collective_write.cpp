@@ -0,0 +1,147 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Write rounds of the collective_buffer with several participants arriving
+// concurrently, one of them handing in data not matching its extents.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/async.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <hpxio/server/collective_buffer.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <string>
+#include <vector>
+
+using boost::program_options::variables_map;
+using boost::program_options::options_description;
+
+using hpx::io::extent;
+using hpx::io::server::collective_buffer;
+
+///////////////////////////////////////////////////////////////////////////////
+// the write_extents function of a round, keeps what it was asked to write
+struct recorder
+{
+    recorder() : calls_(0) {}
+
+    int operator()(collective_buffer::extent_map const& merged) const
+    {
+        ++calls_;
+        merged_ = merged;
+        return 0;
+    }
+
+    mutable std::size_t calls_;
+    mutable collective_buffer::extent_map merged_;
+};
+
+ssize_t participate(collective_buffer* cb, boost::uint64_t round,
+    std::size_t participants, std::vector<extent> const& extents,
+    std::vector<char> const& data, recorder const* r)
+{
+    return cb->write(round, participants, extents, data, *r);
+}
+
+std::size_t const participants = 4;
+std::size_t const chunk = 8;
+
+///////////////////////////////////////////////////////////////////////////////
+// every participant writes two interleaved chunks, together they cover
+// one contiguous range
+void test_write_round(collective_buffer& cb)
+{
+    recorder r;
+    std::vector<hpx::future<ssize_t> > results;
+    for (std::size_t i = 0; i != participants; ++i)
+    {
+        std::vector<extent> extents;
+        extents.push_back(extent(i * chunk, chunk));
+        extents.push_back(extent((participants + i) * chunk, chunk));
+
+        std::vector<char> data(2 * chunk, char('a' + i));
+        results.push_back(hpx::async(&participate, &cb, 1, participants,
+            extents, data, &r));
+    }
+
+    for (std::size_t i = 0; i != participants; ++i)
+    {
+        HPX_TEST_EQ(results[i].get(), ssize_t(2 * chunk));
+    }
+
+    HPX_TEST_EQ(r.calls_, std::size_t(1));
+    HPX_TEST_EQ(r.merged_.size(), std::size_t(1));
+    if (r.merged_.size() != 1)
+    {
+        return;
+    }
+
+    HPX_TEST_EQ(r.merged_.begin()->first, off_t(0));
+    std::vector<char> const& merged = r.merged_.begin()->second;
+    HPX_TEST_EQ(merged.size(), 2 * participants * chunk);
+    for (std::size_t j = 0; j < merged.size(); j += chunk)
+    {
+        HPX_TEST_EQ(merged[j], char('a' + (j / chunk) % participants));
+        HPX_TEST_EQ(merged[j + chunk - 1],
+            char('a' + (j / chunk) % participants));
+    }
+}
+
+// the last participant hands in less data than its extents describe, it
+// still completes the round but contributes nothing
+void test_mismatched_size(collective_buffer& cb)
+{
+    recorder r;
+    std::vector<hpx::future<ssize_t> > results;
+    for (std::size_t i = 0; i != participants; ++i)
+    {
+        std::vector<extent> extents;
+        extents.push_back(extent(i * chunk, chunk));
+
+        std::size_t size = (i == participants - 1) ? chunk / 2 : chunk;
+        std::vector<char> data(size, char('a' + i));
+        results.push_back(hpx::async(&participate, &cb, 2, participants,
+            extents, data, &r));
+    }
+
+    // nobody is left waiting for the mismatched participant
+    for (std::size_t i = 0; i != participants - 1; ++i)
+    {
+        HPX_TEST_EQ(results[i].get(), ssize_t(chunk));
+    }
+    HPX_TEST_EQ(results[participants - 1].get(), ssize_t(-1));
+
+    HPX_TEST_EQ(r.calls_, std::size_t(1));
+    HPX_TEST_EQ(r.merged_.size(), std::size_t(1));
+    if (r.merged_.size() != 1)
+    {
+        return;
+    }
+
+    HPX_TEST_EQ(r.merged_.begin()->first, off_t(0));
+    HPX_TEST_EQ(r.merged_.begin()->second.size(),
+        (participants - 1) * chunk);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(variables_map&)
+{
+    collective_buffer cb;
+    test_write_round(cb);
+    test_mismatched_size(cb);
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    options_description desc_commandline(
+        "Usage: " HPX_APPLICATION_STRING " [options]");
+
+    HPX_TEST_EQ(hpx::init(desc_commandline, argc, argv), 0);
+    return hpx::util::report_errors();
+}
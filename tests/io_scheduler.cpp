@@ -0,0 +1,169 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Order in which the io_scheduler admits waiting requests to its only slot:
+// by priority class, round robin between the clients of a class, and a
+// request whose deadline passed ahead of everything else.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/async.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <hpxio/io_hints.hpp>
+#include <hpxio/server/io_scheduler.hpp>
+
+#include <boost/chrono.hpp>
+#include <boost/program_options.hpp>
+
+#include <string>
+#include <vector>
+
+using boost::program_options::variables_map;
+using boost::program_options::options_description;
+
+using hpx::io::io_hints;
+using hpx::io::server::io_scheduler;
+
+///////////////////////////////////////////////////////////////////////////////
+// the requests run one at a time, each one appends its tag while holding
+// the slot
+void run(io_scheduler* s, io_hints hints, int tag, std::vector<int>* order)
+{
+    HPX_TEST(s->acquire(hints));
+    order->push_back(tag);
+    s->release();
+}
+
+boost::int64_t queued(io_scheduler& s)
+{
+    boost::int64_t n = 0;
+    for (std::size_t c = 0; c != hpx::io::io_priority_count; ++c)
+    {
+        n += s[c].queued_.load();
+    }
+    return n;
+}
+
+// start a request and wait until it is queued behind the slot held by the
+// caller, so the requests are queued in a known order
+hpx::future<void> enqueue(io_scheduler& s, io_hints const& hints, int tag,
+    std::vector<int>& order)
+{
+    boost::int64_t const before = queued(s);
+    hpx::future<void> f = hpx::async(&run, &s, hints, tag, &order);
+    while (queued(s) == before)
+    {
+        hpx::this_thread::suspend();
+    }
+    return f;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void test_priority(io_scheduler& s)
+{
+    std::vector<int> order;
+    HPX_TEST(s.acquire(io_hints()));
+
+    std::vector<hpx::future<void> > requests;
+    requests.push_back(enqueue(s,
+        io_hints(hpx::io::io_priority_background), 2, order));
+    requests.push_back(enqueue(s,
+        io_hints(hpx::io::io_priority_normal), 1, order));
+    requests.push_back(enqueue(s,
+        io_hints(hpx::io::io_priority_interactive), 0, order));
+
+    s.release();
+    hpx::wait_all(requests);
+
+    HPX_TEST_EQ(order.size(), std::size_t(3));
+    for (std::size_t i = 0; i != order.size(); ++i)
+    {
+        HPX_TEST_EQ(order[i], int(i));
+    }
+}
+
+void test_round_robin(io_scheduler& s)
+{
+    std::vector<int> order;
+    HPX_TEST(s.acquire(io_hints()));
+
+    // client 1 queues two requests before client 2 queues its one
+    std::vector<hpx::future<void> > requests;
+    requests.push_back(enqueue(s,
+        io_hints(hpx::io::io_priority_normal, 1), 0, order));
+    requests.push_back(enqueue(s,
+        io_hints(hpx::io::io_priority_normal, 1), 2, order));
+    requests.push_back(enqueue(s,
+        io_hints(hpx::io::io_priority_normal, 2), 1, order));
+
+    s.release();
+    hpx::wait_all(requests);
+
+    HPX_TEST_EQ(order.size(), std::size_t(3));
+    for (std::size_t i = 0; i != order.size(); ++i)
+    {
+        HPX_TEST_EQ(order[i], int(i));
+    }
+}
+
+void test_deadline(io_scheduler& s)
+{
+    std::vector<int> order;
+    HPX_TEST(s.acquire(io_hints()));
+
+    // the background request asks to be started within a millisecond
+    std::vector<hpx::future<void> > requests;
+    requests.push_back(enqueue(s,
+        io_hints(hpx::io::io_priority_interactive), 1, order));
+    requests.push_back(enqueue(s,
+        io_hints(hpx::io::io_priority_background, 0, 1000), 0, order));
+
+    boost::uint64_t missed =
+        s[hpx::io::io_priority_background].missed_.load();
+
+    hpx::this_thread::sleep_for(boost::chrono::milliseconds(10));
+    s.release();
+    hpx::wait_all(requests);
+
+    HPX_TEST_EQ(order.size(), std::size_t(2));
+    for (std::size_t i = 0; i != order.size(); ++i)
+    {
+        HPX_TEST_EQ(order[i], int(i));
+    }
+    HPX_TEST_EQ(s[hpx::io::io_priority_background].missed_.load(),
+        missed + 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(variables_map&)
+{
+    io_scheduler& s = io_scheduler::get("test");
+
+    test_priority(s);
+    test_round_robin(s);
+    test_deadline(s);
+
+    HPX_TEST_EQ(s.running(), boost::int64_t(0));
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    options_description desc_commandline(
+        "Usage: " HPX_APPLICATION_STRING " [options]");
+
+    // a single slot, the default deadlines do not pass during the test
+    std::vector<std::string> cfg;
+    cfg.push_back("hpxio.scheduler.enabled=1");
+    cfg.push_back("hpxio.scheduler.slots=1");
+    cfg.push_back("hpxio.scheduler.deadline.interactive=1000000000");
+    cfg.push_back("hpxio.scheduler.deadline.normal=1000000000");
+    cfg.push_back("hpxio.scheduler.deadline.background=1000000000");
+
+    HPX_TEST_EQ(hpx::init(desc_commandline, argc, argv, cfg), 0);
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,74 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Reads at or past the end of a file return 0, on the io_uring path as well
+// as on the io_pool path. Negative results are reserved for errors.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/runtime.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <hpxio/local_file.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using boost::program_options::variables_map;
+using boost::program_options::options_description;
+
+///////////////////////////////////////////////////////////////////////////////
+void test_eof(std::string const& name)
+{
+    hpx::io::local_file f(
+        hpx::new_<hpx::io::server::local_file>(hpx::find_here()));
+    f.open_sync(name, "w+");
+    HPX_TEST(f.is_open_sync());
+
+    std::vector<char> data(100, 'x');
+    HPX_TEST_EQ(f.pwrite_sync(data, 0), ssize_t(100));
+
+    char buf[16];
+
+    // a read crossing the end returns what is there
+    HPX_TEST_EQ(f.pread_sync(buf, sizeof(buf), 90), ssize_t(10));
+
+    // reads at and behind the end are not errors
+    HPX_TEST_EQ(f.pread_sync(buf, sizeof(buf), 100), ssize_t(0));
+    HPX_TEST_EQ(f.pread_sync(buf, sizeof(buf), 4096), ssize_t(0));
+    HPX_TEST_EQ(f.pread_buffer_sync(sizeof(buf), 100).size(),
+        std::size_t(0));
+
+    // the same at the current file position
+    HPX_TEST_EQ(f.seek_sync(0, SEEK_END), off_t(100));
+    HPX_TEST_EQ(f.read_sync(buf, sizeof(buf)), ssize_t(0));
+
+    HPX_TEST_EQ(f.close_sync(), 0);
+    HPX_TEST_EQ(f.remove_file_sync(name), 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(variables_map&)
+{
+    test_eof("hpxio_local_file_eof.dat");
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    options_description desc_commandline(
+        "Usage: " HPX_APPLICATION_STRING " [options]");
+
+    // the io_uring engine is used where the library and the kernel have it,
+    // the io_pool otherwise
+    std::vector<std::string> cfg;
+    cfg.push_back("hpxio.local_file.io_uring=1");
+
+    HPX_TEST_EQ(hpx::init(desc_commandline, argc, argv, cfg), 0);
+    return hpx::util::report_errors();
+}
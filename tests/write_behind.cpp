@@ -0,0 +1,85 @@
+//  Copyright (c) 2015 Alireza Kheirkhahan
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Staged writes of a local_file stay in the write-behind buffer until a read
+// overlapping them forces a flush, reads elsewhere in the file leave them.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/runtime.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <hpxio/local_file.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+using boost::program_options::variables_map;
+using boost::program_options::options_description;
+
+///////////////////////////////////////////////////////////////////////////////
+// size of the file on disk, bypassing the component
+off_t disk_size(std::string const& name)
+{
+    struct stat st;
+    if (::stat(name.c_str(), &st) != 0)
+    {
+        return -1;
+    }
+    return st.st_size;
+}
+
+void test_flush_on_overlap(std::string const& name)
+{
+    hpx::io::local_file f(
+        hpx::new_<hpx::io::server::local_file>(hpx::find_here()));
+    f.open_sync(name, "w+");
+    HPX_TEST(f.is_open_sync());
+
+    std::vector<char> data(100, 'x');
+    HPX_TEST_EQ(f.pwrite_sync(data, 0), ssize_t(100));
+
+    // the write is staged, nothing reached the file yet
+    HPX_TEST_EQ(disk_size(name), off_t(0));
+
+    // a read not touching the staged range does not flush
+    char buf[16];
+    HPX_TEST_EQ(f.pread_sync(buf, sizeof(buf), 1000), ssize_t(0));
+    HPX_TEST_EQ(disk_size(name), off_t(0));
+
+    // a read overlapping it does, and sees the data
+    HPX_TEST_EQ(f.pread_sync(buf, sizeof(buf), 90), ssize_t(10));
+    HPX_TEST_EQ(buf[0], 'x');
+    HPX_TEST_EQ(buf[9], 'x');
+    HPX_TEST_EQ(disk_size(name), off_t(100));
+
+    HPX_TEST_EQ(f.close_sync(), 0);
+    HPX_TEST_EQ(f.remove_file_sync(name), 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(variables_map&)
+{
+    test_flush_on_overlap("hpxio_write_behind.dat");
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    options_description desc_commandline(
+        "Usage: " HPX_APPLICATION_STRING " [options]");
+
+    // neither the size nor the age of the staged data may force a flush
+    std::vector<std::string> cfg;
+    cfg.push_back("hpxio.write_behind.enabled=1");
+    cfg.push_back("hpxio.write_behind.threshold=1048576");
+    cfg.push_back("hpxio.write_behind.max_delay=1000000");
+
+    HPX_TEST_EQ(hpx::init(desc_commandline, argc, argv, cfg), 0);
+    return hpx::util::report_errors();
+}